@@ -0,0 +1,454 @@
+#ifndef ASK_WORKER_H
+#define ASK_WORKER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <vector>
+#include "async_log.h"
+#include "knowledge_base.h"
+#include "metrics.h"
+#include "openai_client.h"
+#include "profiler.h"
+
+// Knowledge base passages injected into each prompt
+#ifndef ASK_CONTEXT_MAX_PASSAGES
+#define ASK_CONTEXT_MAX_PASSAGES 3
+#endif
+#ifndef ASK_CONTEXT_MAX_BYTES
+#define ASK_CONTEXT_MAX_BYTES 768
+#endif
+
+// Questions queued or answered but not yet collected; further questions
+// are turned away until one is
+#ifndef ASK_JOB_SLOTS
+#define ASK_JOB_SLOTS 4
+#endif
+// Answers nobody collects are dropped after this many ms
+#ifndef ASK_RESULT_TTL
+#define ASK_RESULT_TTL 60000
+#endif
+// The worker runs on the core the Arduino loop does not. TLS handshakes
+// need a deep stack
+#ifndef ASK_WORKER_CORE
+#define ASK_WORKER_CORE 0
+#endif
+#ifndef ASK_WORKER_STACK
+#define ASK_WORKER_STACK 16384
+#endif
+#ifndef ASK_WORKER_PRIORITY
+#define ASK_WORKER_PRIORITY 1
+#endif
+// How often an idle worker runs cache and connection upkeep
+#ifndef ASK_WORKER_TICK_MS
+#define ASK_WORKER_TICK_MS 10
+#endif
+// Free heap a new question needs: room for a TLS handshake and the JSON
+// documents of a request, plus some for each question already admitted
+#ifndef ASK_MIN_FREE_HEAP
+#define ASK_MIN_FREE_HEAP 49152
+#endif
+#ifndef ASK_HEAP_PER_JOB
+#define ASK_HEAP_PER_JOB 4096
+#endif
+// Largest free block an API request needs, for the TLS record buffers
+#ifndef ASK_MIN_HEAP_BLOCK
+#define ASK_MIN_HEAP_BLOCK 20480
+#endif
+
+enum AskJobState : uint8_t {
+  ASK_JOB_FREE,
+  ASK_JOB_QUEUED,   // waiting for its knowledge base search and cache lookup
+  ASK_JOB_WAITING,  // missed the cache; waiting its turn at the API
+  ASK_JOB_RUNNING,
+  ASK_JOB_DONE
+};
+
+// Why submit() turned a question away
+enum AskRefusal : uint8_t {
+  ASK_REFUSED_NONE,
+  ASK_REFUSED_FULL,  // every job slot is taken
+  ASK_REFUSED_HEAP   // too little free heap to take on more
+};
+
+// What a poll found
+enum AskPollResult : uint8_t {
+  ASK_POLL_UNKNOWN,  // no such job, or it expired
+  ASK_POLL_PENDING,  // text holds what arrived since the last poll
+  ASK_POLL_DONE      // text (or cached) completes the answer
+};
+
+struct AskJob {
+  uint32_t id;
+  AskJobState state;
+  uint32_t leader;              // job whose answer this one shares, or 0
+  String question;
+  String prompt;                // built by the lookup, for the API request
+  uint64_t contextId;
+  String text;                  // the answer as streamed so far
+  std::vector<uint8_t> cached;  // or the compressed answer from the cache
+  unsigned long finished;
+};
+
+// Time spent in the worker's stages, for /metrics
+struct AskStageTimes {
+  StageHistogram kbLookup;     // knowledge base search for the context
+  StageHistogram cacheLookup;  // response cache, exact and similar questions
+};
+
+struct AskWorkerStats {
+  uint32_t submitted;
+  uint32_t rejected;    // no free job slot
+  uint32_t shed;        // turned away for lack of heap
+  uint32_t cached;      // answered from the response cache
+  uint32_t requested;   // answered by the API
+  uint32_t coalesced;   // shared an identical question's answer: API calls saved
+  uint32_t expired;     // answers nobody collected
+};
+
+// Answers questions on a FreeRTOS task of its own, pinned to the other
+// core, so the Arduino loop (OTA, WiFi monitoring, the web server) is
+// never held up by a knowledge base search or an API call. Questions are
+// queued in a fixed set of job slots, admitted only while the heap can
+// take them, and answered in two steps: new questions are looked up in
+// the cache first, so cached answers skip past questions waiting for the
+// API, and cache misses then go to the API in order. The answer text is
+// collected by polling as it streams in. A question asked again
+// while the first is still queued or being answered joins that job
+// rather than being answered twice, and streams the same text.
+//
+// The worker is the only task using the OpenAIClient, so its caches and
+// the API connection need no locking; only the job slots are shared
+class AskWorker {
+private:
+  KnowledgeBase& kb;
+  OpenAIClient& ai;
+  AskJob jobs[ASK_JOB_SLOTS];
+  QueueHandle_t queue = nullptr;     // slot indices to look up, in arrival order
+  QueueHandle_t misses = nullptr;    // slot indices waiting for the API
+  SemaphoreHandle_t lock = nullptr;  // guards jobs
+  uint32_t nextId = 1;
+  AskWorkerStats counters = {};
+  AskStageTimes times;
+
+public:
+  AskWorker(KnowledgeBase& knowledgeBase, OpenAIClient& aiClient) : kb(knowledgeBase), ai(aiClient) {
+    for (AskJob& job : jobs) {
+      job.id = 0;
+      job.state = ASK_JOB_FREE;
+      job.leader = 0;
+    }
+  }
+
+  // Start the worker task
+  bool begin() {
+    queue = xQueueCreate(ASK_JOB_SLOTS, sizeof(uint8_t));
+    misses = xQueueCreate(ASK_JOB_SLOTS, sizeof(uint8_t));
+    lock = xSemaphoreCreateMutex();
+    if (queue == nullptr || misses == nullptr || lock == nullptr) return false;
+    return xTaskCreatePinnedToCore(run, "ask", ASK_WORKER_STACK, this, ASK_WORKER_PRIORITY, nullptr,
+                                   ASK_WORKER_CORE) == pdPASS;
+  }
+
+  bool running() const { return queue != nullptr; }
+
+  // Queue a question, or join the job already answering the same one.
+  // Returns its job ID, or 0 with the reason in refusal when it can't be
+  // taken on
+  uint32_t submit(const String& question, AskRefusal* refusal = nullptr) {
+    if (refusal != nullptr) *refusal = ASK_REFUSED_FULL;
+    if (!running()) return 0;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    expire();
+    int slot = -1;
+    size_t pending = 0;
+    for (int i = 0; i < ASK_JOB_SLOTS; i++) {
+      if (jobs[i].state == ASK_JOB_FREE) {
+        if (slot < 0) slot = i;
+      } else if (jobs[i].state != ASK_JOB_DONE) {
+        pending++;
+      }
+    }
+    uint32_t id = 0;
+    const AskJob* leader = nullptr;
+    if (slot >= 0 && !heapAllows(pending)) {
+      counters.shed++;
+      if (refusal != nullptr) *refusal = ASK_REFUSED_HEAP;
+    } else if (slot >= 0) {
+      leader = findLeader(question);
+      AskJob& job = jobs[slot];
+      id = job.id = nextId++;
+      if (nextId == 0) nextId = 1;
+      job.state = ASK_JOB_QUEUED;
+      job.leader = leader != nullptr ? leader->id : 0;
+      job.question = question;
+      job.text = leader != nullptr ? leader->text : "";
+      job.cached.clear();
+      counters.submitted++;
+      if (leader != nullptr) counters.coalesced++;
+      if (refusal != nullptr) *refusal = ASK_REFUSED_NONE;
+    } else {
+      counters.rejected++;
+    }
+    xSemaphoreGive(lock);
+
+    // Followers are finished along with their leader and never queued.
+    // Slots and queue entries are one to one, so this never blocks
+    if (id != 0 && leader == nullptr) {
+      uint8_t index = slot;
+      xQueueSend(queue, &index, 0);
+    }
+    return id;
+  }
+
+  // Collect a job's answer from byte offset from. Pending jobs return
+  // whatever text has arrived since; a done job returns the rest of it,
+  // or its whole compressed answer in cached, and is released once it
+  // has been read to the end
+  AskPollResult poll(uint32_t id, size_t from, String& text, std::vector<uint8_t>& cached) {
+    text = "";
+    cached.clear();
+    if (!running() || id == 0) return ASK_POLL_UNKNOWN;
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    AskPollResult result = ASK_POLL_UNKNOWN;
+    for (AskJob& job : jobs) {
+      if (job.id != id || job.state == ASK_JOB_FREE) continue;
+
+      if (from < job.text.length()) text = job.text.substring(from);
+      if (job.state != ASK_JOB_DONE) {
+        result = ASK_POLL_PENDING;
+      } else {
+        result = ASK_POLL_DONE;
+        cached.swap(job.cached);
+        release(job);
+      }
+      break;
+    }
+    xSemaphoreGive(lock);
+    return result;
+  }
+
+  // Jobs waiting for the worker, not counting the one it is on
+  size_t queued() const {
+    return running() ? uxQueueMessagesWaiting(queue) + uxQueueMessagesWaiting(misses) : 0;
+  }
+
+  const AskWorkerStats& stats() const { return counters; }
+  const AskStageTimes& stageTimes() const { return times; }
+
+private:
+  // New questions are looked up before any cache miss is sent to the API
+  static void run(void* self) {
+    AskWorker* worker = (AskWorker*)self;
+    for (;;) {
+      uint8_t slot;
+      if (xQueueReceive(worker->queue, &slot, 0) == pdTRUE) {
+        worker->lookUp(worker->jobs[slot]);
+      } else if (xQueueReceive(worker->misses, &slot, 0) == pdTRUE) {
+        worker->request(worker->jobs[slot]);
+      } else if (xQueueReceive(worker->queue, &slot, pdMS_TO_TICKS(ASK_WORKER_TICK_MS)) == pdTRUE) {
+        worker->lookUp(worker->jobs[slot]);
+      }
+      worker->ai.tick();
+    }
+  }
+
+  // Answer a question from the cache, or queue it for the API. The job's
+  // question and prompt stay untouched while it is queued or running, so
+  // they are read without the lock
+  void lookUp(AskJob& job) {
+    PROFILE_ZONE("ask.look_up");
+    setState(job, ASK_JOB_RUNNING);
+    const String& question = job.question;
+    LOG_INFO("Question: %.*s", LOG_PREVIEW(question));
+
+    // Get context from knowledge base
+    unsigned long start = micros();
+    String context = buildContext(question);
+    times.kbLookup.record(micros() - start);
+    LOG_DEBUG("Context, %u bytes: %.*s", (unsigned)context.length(), LOG_PREVIEW(context));
+    String prompt = buildPrompt(question, context);
+
+    // Cached answers, including to paraphrases of earlier questions that
+    // retrieved the same passages, are handed over still compressed
+    uint64_t contextId = responseDigest(context.c_str(), context.length());
+    std::vector<uint8_t> cached;
+    start = micros();
+    bool hit = ai.findCachedResponse(prompt, question, contextId, cached);
+    times.cacheLookup.record(micros() - start);
+    if (hit) {
+      LOG_INFO("Answer: cached, %u bytes compressed", (unsigned)cached.size());
+      xSemaphoreTake(lock, portMAX_DELAY);
+      for (AskJob& follower : jobs) {
+        if (follows(follower, job)) follower.cached = cached;
+      }
+      job.cached.swap(cached);
+      finish(job);
+      counters.cached++;
+      xSemaphoreGive(lock);
+      return;
+    }
+
+    job.prompt = prompt;
+    job.contextId = contextId;
+    setState(job, ASK_JOB_WAITING);
+    uint8_t slot = &job - jobs;
+    xQueueSend(misses, &slot, 0);
+  }
+
+  // Stream the answer from OpenAI into the job as it is generated
+  void request(AskJob& job) {
+    PROFILE_ZONE("ask.request");
+    setState(job, ASK_JOB_RUNNING);
+    const String& question = job.question;
+    const String& prompt = job.prompt;
+    uint64_t contextId = job.contextId;
+
+    // A TLS handshake without the memory for it would crash the device
+    if (ESP.getMaxAllocHeap() < ASK_MIN_HEAP_BLOCK) {
+      LOG_WARN("Answer: skipped, largest free block %u bytes", (unsigned)ESP.getMaxAllocHeap());
+      xSemaphoreTake(lock, portMAX_DELAY);
+      String error = "Error: The device is low on memory, please try again shortly";
+      for (AskJob& follower : jobs) {
+        if (follows(follower, job)) appendError(follower, error);
+      }
+      appendError(job, error);
+      finish(job);
+      counters.shed++;
+      xSemaphoreGive(lock);
+      return;
+    }
+
+    unsigned long start = millis();
+    unsigned long firstText = 0;
+    String answer = ai.streamResponse(prompt, question, contextId, [&](const String& text) {
+      if (firstText == 0) firstText = max(millis() - start, 1UL);
+      xSemaphoreTake(lock, portMAX_DELAY);
+      for (AskJob& follower : jobs) {
+        if (follows(follower, job)) follower.text += text;
+      }
+      job.text += text;
+      xSemaphoreGive(lock);
+    });
+    LOG_DEBUG("Answer, %u bytes: %.*s", (unsigned)answer.length(), LOG_PREVIEW(answer));
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (answer.startsWith("Error:")) {
+      // Appended to whatever had already streamed
+      for (AskJob& follower : jobs) {
+        if (follows(follower, job)) appendError(follower, answer);
+      }
+      appendError(job, answer);
+    }
+    finish(job);
+    counters.requested++;
+    xSemaphoreGive(lock);
+    LOG_INFO("Answer streamed: first text after %lu ms, done after %lu ms", firstText, millis() - start);
+  }
+
+  // Join the best ranked passages that fit in the context byte budget.
+  // One snapshot keeps match indices valid while an update is published;
+  // it is taken after the query is embedded, so it is never held across
+  // a call to the embedding provider
+  String buildContext(const String& question) {
+    std::vector<float> vector = kb.embedForSearch(question);
+    KnowledgeView view = kb.snapshot();
+    std::vector<KnowledgeMatch> matches = kb.findMatches(*view, question, vector, ASK_CONTEXT_MAX_PASSAGES);
+
+    String context;
+    for (size_t i = 0; i < matches.size(); i++) {
+      String passage = view->getContent(matches[i].index);
+      size_t separator = context.length() > 0 ? 1 : 0;
+      if (context.length() + separator + passage.length() > ASK_CONTEXT_MAX_BYTES) continue;
+
+      if (separator) context += "\n";
+      context += passage;
+    }
+
+    return context;
+  }
+
+  // Create prompt with context and instructions for code formatting
+  static String buildPrompt(const String& question, const String& context) {
+    String prompt;
+    if (context.length() > 0) {
+      prompt = "Context information: " + context + "\n\n";
+    }
+    prompt += "Question: " + question + "\n\n"
+              "When providing code examples, please format them using markdown code blocks with language specifiers, like:\n"
+              "```javascript\n// Your JavaScript code here\n```\n"
+              "```cpp\n// Your C++ code here\n```\n"
+              "For inline code, use backticks like `this`.\n\n"
+              "Answer:";
+    return prompt;
+  }
+
+  void setState(AskJob& job, AskJobState state) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    job.state = state;
+    xSemaphoreGive(lock);
+  }
+
+  // Whether free heap covers another question on top of the pending ones
+  static bool heapAllows(size_t pending) {
+    return ESP.getFreeHeap() >= ASK_MIN_FREE_HEAP + pending * ASK_HEAP_PER_JOB &&
+           ESP.getMaxAllocHeap() >= ASK_MIN_HEAP_BLOCK;
+  }
+
+  // A job not yet answered with the same question; call with the lock
+  // held
+  const AskJob* findLeader(const String& question) const {
+    for (const AskJob& job : jobs) {
+      if (job.state != ASK_JOB_FREE && job.state != ASK_JOB_DONE && job.leader == 0 &&
+          job.question == question) {
+        return &job;
+      }
+    }
+    return nullptr;
+  }
+
+  static bool follows(const AskJob& follower, const AskJob& leader) {
+    return follower.state != ASK_JOB_FREE && follower.state != ASK_JOB_DONE && follower.leader == leader.id;
+  }
+
+  static void appendError(AskJob& job, const String& error) {
+    if (job.text.length() > 0) job.text += "\n\n";
+    job.text += error;
+  }
+
+  // Finish the job and those sharing its answer; call with the lock held
+  void finish(AskJob& job) {
+    for (AskJob& follower : jobs) {
+      if (follows(follower, job)) {
+        follower.state = ASK_JOB_DONE;
+        follower.finished = millis();
+      }
+    }
+    job.state = ASK_JOB_DONE;
+    job.finished = millis();
+  }
+
+  void release(AskJob& job) {
+    job.state = ASK_JOB_FREE;
+    job.leader = 0;
+    job.question = "";
+    job.prompt = "";
+    job.text = "";
+    job.cached = std::vector<uint8_t>();
+  }
+
+  // Drop answers nobody came back for; call with the lock held
+  void expire() {
+    for (AskJob& job : jobs) {
+      if (job.state == ASK_JOB_DONE && millis() - job.finished > ASK_RESULT_TTL) {
+        release(job);
+        counters.expired++;
+      }
+    }
+  }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,251 @@
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <stdarg.h>
+#include <atomic>
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+// Messages above this level are compiled out, arguments and all
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+// Records waiting to be drained; a power of two. When it is full new
+// records are dropped and counted rather than waited for
+#ifndef LOG_RING_RECORDS
+#define LOG_RING_RECORDS 32
+#endif
+// Drained records kept for /logs
+#ifndef LOG_HISTORY_RECORDS
+#define LOG_HISTORY_RECORDS 32
+#endif
+// Longer messages are cut short, marked with "..."
+#ifndef LOG_RECORD_TEXT
+#define LOG_RECORD_TEXT 116
+#endif
+// Characters of a question, context or answer that are logged
+#ifndef LOG_PAYLOAD_PREVIEW
+#define LOG_PAYLOAD_PREVIEW 60
+#endif
+#ifndef LOG_SERIAL
+#define LOG_SERIAL true
+#endif
+#ifndef LOG_DRAIN_CORE
+#define LOG_DRAIN_CORE 1
+#endif
+#ifndef LOG_DRAIN_PRIORITY
+#define LOG_DRAIN_PRIORITY 1
+#endif
+#ifndef LOG_DRAIN_MS
+#define LOG_DRAIN_MS 20
+#endif
+
+// One message, fixed size so records never allocate
+struct LogRecord {
+  uint32_t sequence;
+  uint32_t timestamp;  // ms since boot
+  uint8_t level;
+  uint8_t length;
+  char text[LOG_RECORD_TEXT];
+};
+
+// Logger that keeps Serial off the request path. write() formats into a
+// slot of a lock-free ring buffer (a bounded multi-producer queue with a
+// sequence number per slot) and returns; a low-priority task drains the
+// ring to Serial and into a history served at /logs. Any task may write;
+// only the drain task reads the ring
+class AsyncLog {
+private:
+  struct Slot {
+    std::atomic<uint32_t> turn;  // position it is ready to be written (== position) or read (== position + 1)
+    LogRecord record;
+  };
+
+  Slot ring[LOG_RING_RECORDS];
+  std::atomic<uint32_t> writePosition;
+  uint32_t readPosition = 0;
+  std::atomic<uint32_t> dropped;
+  uint32_t reportedDropped = 0;
+
+  LogRecord kept[LOG_HISTORY_RECORDS];
+  uint32_t keptCount = 0;  // records ever added; the last LOG_HISTORY_RECORDS are kept
+  SemaphoreHandle_t keptLock = nullptr;
+
+public:
+  AsyncLog() {
+    static_assert((LOG_RING_RECORDS & (LOG_RING_RECORDS - 1)) == 0, "LOG_RING_RECORDS must be a power of two");
+    for (uint32_t i = 0; i < LOG_RING_RECORDS; i++) ring[i].turn.store(i, std::memory_order_relaxed);
+    writePosition.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+  }
+
+  // Start the drain task; records written before this wait in the ring
+  bool begin() {
+    keptLock = xSemaphoreCreateMutex();
+    if (keptLock == nullptr) return false;
+    return xTaskCreatePinnedToCore(run, "log", 4096, this, LOG_DRAIN_PRIORITY, nullptr, LOG_DRAIN_CORE) == pdPASS;
+  }
+
+  void write(uint8_t level, const char* format, ...) __attribute__((format(printf, 3, 4))) {
+    // Claim a slot
+    uint32_t position = writePosition.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+      slot = &ring[position & (LOG_RING_RECORDS - 1)];
+      int32_t lag = (int32_t)(slot->turn.load(std::memory_order_acquire) - position);
+      if (lag == 0) {
+        if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+      } else if (lag < 0) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+      } else {
+        position = writePosition.load(std::memory_order_relaxed);
+      }
+    }
+
+    LogRecord& record = slot->record;
+    record.sequence = position;
+    record.timestamp = millis();
+    record.level = level;
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(record.text, sizeof(record.text), format, args);
+    va_end(args);
+    if (length >= (int)sizeof(record.text)) {
+      memcpy(record.text + sizeof(record.text) - 4, "...", 4);
+      length = sizeof(record.text) - 1;
+    }
+    record.length = length > 0 ? length : 0;
+    slot->turn.store(position + 1, std::memory_order_release);
+  }
+
+  // Records dropped because the ring was full
+  uint32_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+  // Append the kept records after sequence number since, one per line,
+  // and return the sequence number to ask for next time
+  uint32_t recent(String& out, uint32_t since = 0) {
+    if (keptLock == nullptr) return since;
+    xSemaphoreTake(keptLock, portMAX_DELAY);
+    uint32_t first = keptCount > LOG_HISTORY_RECORDS ? keptCount - LOG_HISTORY_RECORDS : 0;
+    uint32_t next = since;
+    for (uint32_t i = first; i < keptCount; i++) {
+      const LogRecord& record = kept[i % LOG_HISTORY_RECORDS];
+      if (record.sequence < since) continue;
+      format(record, out);
+      next = record.sequence + 1;
+    }
+    xSemaphoreGive(keptLock);
+    return next;
+  }
+
+  static const char* levelName(uint8_t level) {
+    switch (level) {
+      case LOG_LEVEL_ERROR: return "E";
+      case LOG_LEVEL_WARN: return "W";
+      case LOG_LEVEL_INFO: return "I";
+      default: return "D";
+    }
+  }
+
+private:
+  static void run(void* self) {
+    AsyncLog* log = (AsyncLog*)self;
+    for (;;) {
+      log->drain();
+      vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_MS));
+    }
+  }
+
+  void drain() {
+    for (;;) {
+      Slot& slot = ring[readPosition & (LOG_RING_RECORDS - 1)];
+      if (slot.turn.load(std::memory_order_acquire) != readPosition + 1) break;
+      const LogRecord& record = slot.record;
+
+      if (LOG_SERIAL) {
+        String line;
+        format(record, line);
+        Serial.print(line);
+      }
+      xSemaphoreTake(keptLock, portMAX_DELAY);
+      kept[keptCount % LOG_HISTORY_RECORDS] = record;
+      keptCount++;
+      xSemaphoreGive(keptLock);
+
+      // Hand the slot back for the writer one lap ahead
+      slot.turn.store(readPosition + LOG_RING_RECORDS, std::memory_order_release);
+      readPosition++;
+    }
+
+    uint32_t lost = droppedCount();
+    if (LOG_SERIAL && lost != reportedDropped) {
+      Serial.printf("[log] %u records dropped\n", (unsigned)(lost - reportedDropped));
+      reportedDropped = lost;
+    }
+  }
+
+  // "[   12.345] I message\n"
+  static void format(const LogRecord& record, String& out) {
+    char prefix[24];
+    snprintf(prefix, sizeof(prefix), "[%6u.%03u] %s ", (unsigned)(record.timestamp / 1000),
+             (unsigned)(record.timestamp % 1000), levelName(record.level));
+    out += prefix;
+    out.concat(record.text, record.length);
+    out += '\n';
+  }
+};
+
+// The one logger, written to from any task through the LOG_ macros
+inline AsyncLog asyncLog;
+
+// Compiled out, but the arguments are still type-checked and count as used
+#define LOG_DISABLED(level, ...)                 \
+  do {                                           \
+    if (false) asyncLog.write(level, __VA_ARGS__); \
+  } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) asyncLog.write(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) LOG_DISABLED(LOG_LEVEL_ERROR, __VA_ARGS__)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) asyncLog.write(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) LOG_DISABLED(LOG_LEVEL_WARN, __VA_ARGS__)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) asyncLog.write(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) LOG_DISABLED(LOG_LEVEL_INFO, __VA_ARGS__)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) asyncLog.write(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) LOG_DISABLED(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#endif
+
+// Log only every nth time this line is reached, for messages that would
+// otherwise flood the ring under load
+#define LOG_EVERY(n, level, ...)                                        \
+  do {                                                                  \
+    static std::atomic<uint32_t> logEveryCount(0);                      \
+    if (logEveryCount.fetch_add(1, std::memory_order_relaxed) % (n) == 0) \
+      level(__VA_ARGS__);                                               \
+  } while (0)
+
+// printf arguments for at most LOG_PAYLOAD_PREVIEW characters of a
+// String, used with "%.*s"
+#define LOG_PREVIEW(text) \
+  (int)((text).length() < LOG_PAYLOAD_PREVIEW ? (text).length() : LOG_PAYLOAD_PREVIEW), (text).c_str()
+
+#endif
\ No newline at end of file
@@ -0,0 +1,148 @@
+#ifndef CODEC_BENCHMARK_H
+#define CODEC_BENCHMARK_H
+
+#include <Arduino.h>
+#include "response_cache.h"
+#include "response_codec.h"
+
+// Decodes timed per sample to average out timer resolution
+#ifndef CODEC_BENCHMARK_ROUNDS
+#define CODEC_BENCHMARK_ROUNDS 20
+#endif
+
+// Answers typical of the assistant: prose, lists and markdown code blocks
+const char* const codecBenchmarkSamples[] = {
+  "The ESP32 is a low-cost, low-power system on a chip with integrated Wi-Fi and dual-mode Bluetooth. "
+  "It is built around a dual-core Tensilica Xtensa LX6 microcontroller running at up to 240 MHz, with "
+  "520 KB of SRAM and support for external flash and PSRAM. The chip includes a rich set of peripherals: "
+  "capacitive touch sensors, Hall sensor, SD card interface, Ethernet MAC, high-speed SPI, UART, I2S and "
+  "I2C. Because Wi-Fi and Bluetooth are on the same chip, the ESP32 is a popular choice for IoT devices, "
+  "wearables and home automation projects. The ESP32 can be programmed with the ESP-IDF framework, the "
+  "Arduino core for ESP32, MicroPython or PlatformIO, so you can use whichever toolchain you already know.",
+
+  "To blink an LED on an ESP32 with the Arduino framework, connect the LED through a 220 ohm resistor to a "
+  "GPIO pin and toggle the pin in loop():\n\n"
+  "```cpp\n"
+  "#include <Arduino.h>\n\n"
+  "const int ledPin = 2;  // on-board LED on most DevKit boards\n\n"
+  "void setup() {\n"
+  "  pinMode(ledPin, OUTPUT);\n"
+  "}\n\n"
+  "void loop() {\n"
+  "  digitalWrite(ledPin, HIGH);\n"
+  "  delay(500);\n"
+  "  digitalWrite(ledPin, LOW);\n"
+  "  delay(500);\n"
+  "}\n"
+  "```\n\n"
+  "The `pinMode` call configures the pin as an output, and `digitalWrite` drives it high or low. "
+  "Adjust the `delay` values to change the blink rate.",
+
+  "Deep sleep is the lowest power mode of the ESP32. In deep sleep the CPUs, most of the RAM and all "
+  "digital peripherals are powered off; only the RTC controller, RTC peripherals and RTC memory stay on. "
+  "The chip can wake up from a timer, a touch pad, an external pin (ext0 or ext1) or the ULP coprocessor.\n\n"
+  "1. Configure a wake-up source, for example `esp_sleep_enable_timer_wakeup(10 * 1000000ULL);` for 10 seconds.\n"
+  "2. Save any state you need in RTC memory with `RTC_DATA_ATTR int bootCount = 0;`.\n"
+  "3. Call `esp_deep_sleep_start();` to enter deep sleep.\n\n"
+  "After waking up, the ESP32 restarts from setup(), so use `esp_sleep_get_wakeup_cause()` to find out "
+  "why it woke up. A typical deep sleep current is around 10 uA, which lets a battery powered sensor run "
+  "for months when it only wakes up to take a reading and send it over Wi-Fi.",
+
+  "Here is a minimal web server that serves a JSON status page:\n\n"
+  "```cpp\n"
+  "#include <WiFi.h>\n"
+  "#include <WebServer.h>\n\n"
+  "WebServer server(80);\n\n"
+  "void handleStatus() {\n"
+  "  String json = \"{\\\"uptime\\\":\" + String(millis() / 1000) + \",\\\"heap\\\":\" + String(ESP.getFreeHeap()) + \"}\";\n"
+  "  server.send(200, \"application/json\", json);\n"
+  "}\n\n"
+  "void setup() {\n"
+  "  Serial.begin(115200);\n"
+  "  WiFi.begin(\"your-ssid\", \"your-password\");\n"
+  "  while (WiFi.status() != WL_CONNECTED) {\n"
+  "    delay(500);\n"
+  "  }\n"
+  "  server.on(\"/status\", handleStatus);\n"
+  "  server.begin();\n"
+  "}\n\n"
+  "void loop() {\n"
+  "  server.handleClient();\n"
+  "}\n"
+  "```\n\n"
+  "Open `http://<device-ip>/status` in a browser to see the uptime in seconds and the free heap in bytes. "
+  "Call `server.handleClient()` often, since the server only handles requests from inside loop().",
+
+  "PWM on the ESP32 is provided by the LEDC peripheral, which has 16 channels that can be routed to almost "
+  "any GPIO. Each channel is configured with a frequency and a resolution in bits; higher frequencies leave "
+  "fewer bits of resolution. With the Arduino core you call `ledcSetup(channel, frequency, resolution)`, "
+  "attach a pin with `ledcAttachPin(pin, channel)` and set the duty cycle with `ledcWrite(channel, duty)`. "
+  "For example, a 5 kHz signal with 8-bit resolution accepts duty values from 0 to 255. PWM is commonly "
+  "used to dim LEDs, control the speed of DC motors through a driver, and position servos, which expect a "
+  "50 Hz signal with a pulse width between 1 and 2 milliseconds.",
+};
+
+#define CODEC_BENCHMARK_SAMPLE_COUNT (sizeof(codecBenchmarkSamples) / sizeof(codecBenchmarkSamples[0]))
+
+// Response compression benchmark. Reports the compression ratio, the
+// one-off encode cost when an answer is cached and the decode cost per
+// cache hit, and how many answers of this size fit the RAM cache budget
+// raw versus compressed
+class ResponseCodecBenchmark {
+public:
+  static void run(Print& out) {
+    size_t rawTotal = 0;
+    size_t packedTotal = 0;
+    unsigned long encodeMicros = 0;
+    unsigned long decodeMicros = 0;
+    unsigned long maxDecodeMicros = 0;
+    bool ok = true;
+
+    out.printf("Codec benchmark: %u answers, %u byte window\n",
+               (unsigned)CODEC_BENCHMARK_SAMPLE_COUNT, (unsigned)RESPONSE_CODEC_WINDOW);
+    for (size_t i = 0; i < CODEC_BENCHMARK_SAMPLE_COUNT; i++) {
+      const char* text = codecBenchmarkSamples[i];
+      size_t length = strlen(text);
+
+      std::vector<uint8_t> blob;
+      unsigned long start = micros();
+      ResponseCodec::encode(text, length, blob);
+      encodeMicros += micros() - start;
+
+      // Decode into a checksum, so the time is the codec's own and not the
+      // sink's; the codec verifies the CRC itself
+      unsigned long sampleMicros = 0;
+      for (int round = 0; round < CODEC_BENCHMARK_ROUNDS; round++) {
+        size_t decoded = 0;
+        start = micros();
+        ok &= ResponseCodec::decode(blob.data(), blob.size(), [&decoded](const uint8_t* data, size_t size) {
+          decoded += size;
+        });
+        sampleMicros += micros() - start;
+        ok &= decoded == length;
+      }
+      sampleMicros /= CODEC_BENCHMARK_ROUNDS;
+      decodeMicros += sampleMicros;
+      maxDecodeMicros = max(maxDecodeMicros, sampleMicros);
+
+      out.printf("  answer %u: %u -> %u bytes (%.2fx), decode %lu us\n",
+                 (unsigned)i, (unsigned)length, (unsigned)blob.size(), (float)length / blob.size(), sampleMicros);
+      rawTotal += length;
+      packedTotal += blob.size();
+    }
+
+    size_t count = CODEC_BENCHMARK_SAMPLE_COUNT;
+    out.printf("  ratio %.2fx, encode %lu us/answer, decode %lu us/hit mean, %lu us max%s\n",
+               (float)rawTotal / packedTotal, encodeMicros / count, decodeMicros / count, maxDecodeMicros,
+               ok ? "" : ", ROUND TRIP FAILED");
+
+    // The cache charges each entry its bytes plus one pool node
+    size_t node = ResponseCache::entryOverhead();
+    out.printf("  %u byte RAM cache holds ~%u answers raw, ~%u compressed\n",
+               (unsigned)RESPONSE_CACHE_BYTES,
+               (unsigned)(RESPONSE_CACHE_BYTES / (rawTotal / count + 1 + node)),
+               (unsigned)(RESPONSE_CACHE_BYTES / (packedTotal / count + node)));
+  }
+};
+
+#endif
\ No newline at end of file
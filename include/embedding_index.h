@@ -0,0 +1,183 @@
+#ifndef EMBEDDING_INDEX_H
+#define EMBEDDING_INDEX_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <ctype.h>
+#include <string.h>
+#endif
+#include <math.h>
+#include <algorithm>
+#include "knowledge_store.h"
+
+// Vector dimensions are padded to this many int8 lanes so the SIMD kernel
+// never needs a tail loop
+#define KB_EMBEDDING_ALIGN 16
+#define KB_MAX_EMBEDDING_DIM 1024
+
+// Use the ESP32-S3 PIE vector instructions for dot products
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && !defined(KB_EMBEDDING_SCALAR)
+#define KB_EMBEDDING_SIMD 1
+#else
+#define KB_EMBEDDING_SIMD 0
+#endif
+
+// Per-entry embeddings quantized to int8 with one float scale per vector,
+// compiled into flash by tools/kb_compile.py. Vectors are L2-normalized
+// before quantization, so a dot product approximates cosine similarity
+struct EmbeddingTables {
+  const int8_t* vectors;  // count * dim values, 16-byte aligned
+  const float* scales;
+  uint32_t count;
+  uint16_t dim;           // multiple of KB_EMBEDDING_ALIGN, 0 when absent
+};
+
+// Source of query embeddings. Must produce vectors from the same model and
+// dimension as the offline entry embeddings
+class EmbeddingProvider {
+public:
+  virtual ~EmbeddingProvider() {}
+
+  // Write a dim-sized embedding of text into out
+  virtual bool embed(const char* text, size_t length, float* out, size_t dim) = 0;
+};
+
+// Local stand-in provider: signed feature hashing of lowercase ASCII words
+// and their character trigrams. Needs no network, so it also serves host
+// builds; entry embeddings must come from tools/kb_embed.py --provider hashing
+class HashingEmbeddingProvider : public EmbeddingProvider {
+public:
+  bool embed(const char* text, size_t length, float* out, size_t dim) override {
+    if (dim == 0) return false;
+    memset(out, 0, dim * sizeof(float));
+
+    char word[KB_MAX_TOKEN_LENGTH + 2];
+    size_t wordLength = 0;
+    for (size_t i = 0; i <= length; i++) {
+      char c = i < length ? tolower((unsigned char)text[i]) : ' ';
+      if (isalnum((unsigned char)c)) {
+        if (wordLength < KB_MAX_TOKEN_LENGTH) word[1 + wordLength++] = c;
+        continue;
+      }
+      if (wordLength == 0) continue;
+
+      addFeature(word + 1, wordLength, 1.0f, out, dim);
+      word[0] = '^';
+      word[1 + wordLength] = '$';
+      for (size_t t = 0; t + 3 <= wordLength + 2; t++) {
+        addFeature(word + t, 3, 0.5f, out, dim);
+      }
+      wordLength = 0;
+    }
+
+    float norm = 0;
+    for (size_t d = 0; d < dim; d++) norm += out[d] * out[d];
+    if (norm <= 0) return false;
+    norm = 1.0f / sqrtf(norm);
+    for (size_t d = 0; d < dim; d++) out[d] *= norm;
+    return true;
+  }
+
+private:
+  static void addFeature(const char* text, size_t length, float weight, float* out, size_t dim) {
+    uint32_t hash = kbHashToken(text, length);
+    out[hash % dim] += (hash & 0x80000000u) ? -weight : weight;
+  }
+};
+
+// Brute-force int8 similarity search over EmbeddingTables
+class EmbeddingIndex {
+private:
+  EmbeddingTables tables = {};
+
+public:
+  void open(const EmbeddingTables& embeddings) {
+    tables = embeddings;
+  }
+
+  void close() {
+    tables = EmbeddingTables();
+  }
+
+  bool isOpen() const { return tables.vectors != nullptr && tables.dim > 0; }
+  size_t size() const { return isOpen() ? tables.count : 0; }
+  uint16_t dim() const { return tables.dim; }
+
+  // Score every vector against a float query and keep the best
+  // maxResults at or above minScore, best first. Returns the match count
+  template <typename Match>
+  size_t search(const float* query, Match* out, size_t maxResults, float minScore) const {
+    if (!isOpen() || maxResults == 0) return 0;
+
+    // Quantize the query once with its own scale
+    alignas(KB_EMBEDDING_ALIGN) int8_t quantized[KB_MAX_EMBEDDING_DIM];
+    float queryScale = quantize(query, quantized, tables.dim);
+    if (queryScale <= 0) return 0;
+
+    size_t found = 0;
+    for (size_t i = 0; i < tables.count; i++) {
+      float score = dot(quantized, tables.vectors + i * tables.dim, tables.dim) * queryScale * tables.scales[i];
+      if (score < minScore || (found == maxResults && score <= out[found - 1].score)) continue;
+
+      // Insertion into the small sorted result array
+      size_t pos = found < maxResults ? found++ : found - 1;
+      while (pos > 0 && out[pos - 1].score < score) {
+        out[pos] = out[pos - 1];
+        pos--;
+      }
+      out[pos].index = i;
+      out[pos].score = score;
+    }
+    return found;
+  }
+
+  // Symmetric int8 quantization; returns the dequantization scale
+  static float quantize(const float* values, int8_t* out, size_t dim) {
+    float maxAbs = 0;
+    for (size_t d = 0; d < dim; d++) maxAbs = std::max(maxAbs, fabsf(values[d]));
+    if (maxAbs <= 0) return 0;
+
+    float scale = maxAbs / 127.0f;
+    for (size_t d = 0; d < dim; d++) {
+      out[d] = (int8_t)lroundf(values[d] / scale);
+    }
+    return scale;
+  }
+
+  // int8 dot product; dim must be a multiple of KB_EMBEDDING_ALIGN and both
+  // vectors 16-byte aligned
+  static int32_t dot(const int8_t* a, const int8_t* b, size_t dim) {
+#if KB_EMBEDDING_SIMD
+    int32_t result;
+    uint32_t blocks = dim / KB_EMBEDDING_ALIGN;
+    asm volatile(
+      "ee.zero.accx\n"
+      "beqz %[n], 2f\n"
+      "1:\n"
+      "ee.vld.128.ip q0, %[a], 16\n"
+      "ee.vld.128.ip q1, %[b], 16\n"
+      "addi %[n], %[n], -1\n"
+      "ee.vmulas.s8.accx q0, q1\n"
+      "bnez %[n], 1b\n"
+      "2:\n"
+      "rur.accx_0 %[r]\n"
+      : [r] "=r"(result), [a] "+r"(a), [b] "+r"(b), [n] "+r"(blocks)
+      :
+      : "memory");
+    return result;
+#else
+    // Four independent accumulators keep the multiplier pipeline busy
+    int32_t sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+    for (size_t d = 0; d < dim; d += 4) {
+      sum0 += (int16_t)a[d] * b[d];
+      sum1 += (int16_t)a[d + 1] * b[d + 1];
+      sum2 += (int16_t)a[d + 2] * b[d + 2];
+      sum3 += (int16_t)a[d + 3] * b[d + 3];
+    }
+    return sum0 + sum1 + sum2 + sum3;
+#endif
+  }
+};
+
+#endif
\ No newline at end of file
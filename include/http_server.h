@@ -0,0 +1,689 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "metrics.h"
+
+// lwIP provides BSD sockets on the ESP32; the same code builds on a host
+// for load testing (tools/http_bench.cpp)
+#ifdef ESP_PLATFORM
+#include <lwip/sockets.h>
+#else
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Open connections; more wait in the listen backlog. lwIP has 10 sockets
+// by default, shared with the API connection and OTA
+#ifndef HTTP_MAX_CONNECTIONS
+#define HTTP_MAX_CONNECTIONS 6
+#endif
+// Per connection; the request line and headers must fit
+#ifndef HTTP_REQUEST_BUFFER
+#define HTTP_REQUEST_BUFFER 1024
+#endif
+// Keep-alive connections, and requests that stall, are closed after this
+#ifndef HTTP_IDLE_TIMEOUT
+#define HTTP_IDLE_TIMEOUT 5000
+#endif
+// Connections idle this long are closed to make room when others are
+// waiting for a slot
+#ifndef HTTP_EVICT_IDLE
+#define HTTP_EVICT_IDLE 500
+#endif
+#ifndef HTTP_BACKLOG
+#define HTTP_BACKLOG 8
+#endif
+
+enum HttpBodyEvent : uint8_t {
+  HTTP_BODY_START,
+  HTTP_BODY_DATA,
+  HTTP_BODY_END,
+  HTTP_BODY_ABORTED  // the connection closed before the body was complete
+};
+
+class HttpRequest {
+public:
+  uint32_t id = 0;  // unique per request
+  uint32_t remoteAddress = 0;  // client's IPv4 address, network byte order
+  std::string method;
+  std::string path;
+  std::string query;
+  std::string pathArg;  // what matched "{}" in the route
+  std::vector<std::pair<std::string, std::string>> headers;  // names lower case
+  size_t contentLength = 0;
+  bool keepAlive = true;
+
+  bool hasArg(const char* name) const {
+    std::string value;
+    return findArg(name, value);
+  }
+
+  // A query string parameter, URL-decoded
+  std::string arg(const char* name) const {
+    std::string value;
+    findArg(name, value);
+    return value;
+  }
+
+  // A header by its lower case name
+  std::string header(const char* name) const {
+    for (const auto& entry : headers) {
+      if (entry.first == name) return entry.second;
+    }
+    return std::string();
+  }
+
+private:
+  bool findArg(const char* name, std::string& value) const {
+    size_t nameLength = strlen(name);
+    size_t start = 0;
+    while (start <= query.length()) {
+      size_t end = query.find('&', start);
+      if (end == std::string::npos) end = query.length();
+      size_t equals = query.find('=', start);
+      size_t keyEnd = equals < end ? equals : end;
+      if (keyEnd - start == nameLength && query.compare(start, nameLength, name) == 0) {
+        value = equals < end ? decode(query.substr(equals + 1, end - equals - 1)) : std::string();
+        return true;
+      }
+      start = end + 1;
+    }
+    return false;
+  }
+
+  static std::string decode(const std::string& text) {
+    std::string out;
+    out.reserve(text.length());
+    for (size_t i = 0; i < text.length(); i++) {
+      char c = text[i];
+      if (c == '+') {
+        out += ' ';
+      } else if (c == '%' && i + 2 < text.length() && isHex(text[i + 1]) && isHex(text[i + 2])) {
+        out += (char)(hexValue(text[i + 1]) * 16 + hexValue(text[i + 2]));
+        i += 2;
+      } else {
+        out += c;
+      }
+    }
+    return out;
+  }
+
+  static bool isHex(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+  }
+
+  static int hexValue(char c) {
+    return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+  }
+};
+
+class HttpResponse {
+private:
+  int statusCode = 0;
+  std::string extraHeaders;
+  std::string contentType;
+  std::string owned;               // body copied into the response
+  const char* borrowed = nullptr;  // or a body that outlives it
+  size_t borrowedLength = 0;
+
+  friend class HttpServer;
+
+public:
+  void setHeader(const char* name, const std::string& value) {
+    extraHeaders += name;
+    extraHeaders += ": ";
+    extraHeaders += value;
+    extraHeaders += "\r\n";
+  }
+
+  void send(int status, const char* type, std::string body) {
+    statusCode = status;
+    contentType = type;
+    owned = std::move(body);
+    borrowed = nullptr;
+    borrowedLength = 0;
+  }
+
+  void send(int status, const char* type, const uint8_t* data, size_t length) {
+    send(status, type, std::string((const char*)data, length));
+  }
+
+  // A body that stays valid until it has been sent, such as a page in
+  // flash; it is not copied
+  void sendStatic(int status, const char* type, const char* data, size_t length) {
+    statusCode = status;
+    contentType = type;
+    owned.clear();
+    borrowed = data;
+    borrowedLength = length;
+  }
+
+  bool sent() const { return statusCode != 0; }
+};
+
+typedef std::function<void(HttpRequest&, HttpResponse&)> HttpHandler;
+typedef std::function<void(HttpRequest&, HttpBodyEvent, const uint8_t*, size_t)> HttpBodyHandler;
+
+struct HttpServerStats {
+  uint32_t accepted;
+  uint32_t requests;
+  uint32_t keptAlive;     // requests on a connection that had served one already
+  uint32_t rejected;      // malformed, oversized or unsupported requests
+  uint32_t timeouts;      // connections closed idle or stalled
+  uint32_t evicted;       // idle keep-alive connections closed to make room
+  uint32_t open;
+  uint32_t maxOpen;
+};
+
+// Event-driven HTTP/1.1 server. One poll() serves every connection that
+// is ready, without blocking on any of them: each has a fixed request
+// buffer and its response is written as fast as the socket takes it, so
+// a slow client only delays itself. Connections are kept alive between
+// requests until every slot is taken and more are waiting; then responses
+// close their connections, and connections idle for HTTP_EVICT_IDLE are
+// closed, to make way. Request bodies are passed to a route's body
+// handler as they arrive rather than buffered. Handlers run to completion
+// in poll() and must not block
+class HttpServer {
+private:
+  enum ConnectionState : uint8_t {
+    CONNECTION_FREE,
+    CONNECTION_READING_HEAD,
+    CONNECTION_READING_BODY,
+    CONNECTION_WRITING
+  };
+
+  struct Route {
+    std::string method;
+    std::string path;  // a trailing "{}" matches one path segment
+    HttpHandler handler;
+    HttpBodyHandler body;
+  };
+
+  struct Connection {
+    int fd = -1;
+    uint32_t remoteAddress = 0;
+    ConnectionState state = CONNECTION_FREE;
+    char input[HTTP_REQUEST_BUFFER];
+    size_t inputLength = 0;
+    uint32_t lastActive = 0;
+    uint32_t served = 0;
+    HttpRequest request;
+    const Route* route = nullptr;
+    size_t bodyLeft = 0;
+    HttpResponse response;
+    std::string head;  // status line and headers
+    size_t written = 0;
+    uint32_t responseStarted = 0;  // us
+    bool closeAfter = false;
+  };
+
+  uint16_t port;
+  int listener = -1;
+  std::vector<Route> routes;
+  Connection connections[HTTP_MAX_CONNECTIONS];
+  uint32_t nextRequestId = 1;
+  bool waiting = false;  // connections are queued in the backlog
+  HttpServerStats counters = {};
+  StageHistogram sendTimes;  // response ready until its last byte was sent
+
+public:
+  explicit HttpServer(uint16_t listenPort) : port(listenPort) {}
+
+  ~HttpServer() {
+    for (Connection& connection : connections) {
+      if (connection.state != CONNECTION_FREE) closeConnection(connection);
+    }
+    if (listener >= 0) close(listener);
+  }
+
+  // Route method and path to handler. A body handler, if given, receives
+  // the request body as it arrives, before handler is called. Routes are
+  // added before begin()
+  void on(const char* method, const char* path, HttpHandler handler, HttpBodyHandler body = nullptr) {
+    routes.push_back({method, path, handler, body});
+  }
+
+  bool begin() {
+    listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) return false;
+    int enable = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (bind(listener, (struct sockaddr*)&address, sizeof(address)) < 0 ||
+        listen(listener, HTTP_BACKLOG) < 0) {
+      close(listener);
+      listener = -1;
+      return false;
+    }
+    fcntl(listener, F_SETFL, fcntl(listener, F_GETFL, 0) | O_NONBLOCK);
+    return true;
+  }
+
+  // Serve every connection that is ready. Waits up to timeoutMs for one
+  // to become ready; 0 returns at once
+  void poll(uint32_t timeoutMs = 0) {
+    if (listener < 0) return;
+
+    fd_set readable;
+    fd_set writable;
+    FD_ZERO(&readable);
+    FD_ZERO(&writable);
+    uint32_t now = clock();
+    int highest = -1;
+    bool room = false;
+    for (Connection& connection : connections) {
+      if (connection.state == CONNECTION_FREE || evictable(connection, now)) room = true;
+      if (connection.state == CONNECTION_FREE) continue;
+      FD_SET(connection.fd, connection.state == CONNECTION_WRITING ? &writable : &readable);
+      if (connection.fd > highest) highest = connection.fd;
+    }
+    // With every slot busy, new connections wait in the backlog; once
+    // one is known to be waiting the listener is left out, or select()
+    // would return at once until a slot frees up
+    if (room || !waiting) {
+      FD_SET(listener, &readable);
+      if (listener > highest) highest = listener;
+    }
+
+    struct timeval timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_usec = (timeoutMs % 1000) * 1000;
+    int ready = select(highest + 1, &readable, &writable, nullptr, &timeout);
+
+    now = clock();
+    if (ready > 0) {
+      if (FD_ISSET(listener, &readable)) {
+        if (room) acceptConnections(now);
+        else waiting = true;
+      }
+      for (Connection& connection : connections) {
+        if (connection.state == CONNECTION_FREE) continue;
+        if (FD_ISSET(connection.fd, &readable)) {
+          receive(connection, now);
+        } else if (FD_ISSET(connection.fd, &writable)) {
+          transmit(connection, now);
+          // A pipelined request may be waiting behind the response
+          if (connection.state == CONNECTION_READING_HEAD && connection.inputLength > 0) process(connection, now);
+        }
+      }
+    }
+
+    for (Connection& connection : connections) {
+      if (connection.state != CONNECTION_FREE && now - connection.lastActive > HTTP_IDLE_TIMEOUT) {
+        counters.timeouts++;
+        closeConnection(connection);
+      }
+    }
+  }
+
+  const HttpServerStats& stats() const { return counters; }
+  const StageHistogram& sendTime() const { return sendTimes; }
+
+private:
+  static uint32_t clock() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  static uint32_t microClock() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  // Between requests, with nothing buffered, for long enough that the
+  // client is unlikely to be sending the next one
+  bool evictable(const Connection& connection, uint32_t now) const {
+    return waiting && connection.state == CONNECTION_READING_HEAD && connection.inputLength == 0 &&
+           now - connection.lastActive >= HTTP_EVICT_IDLE;
+  }
+
+  void acceptConnections(uint32_t now) {
+    for (;;) {
+      Connection* slot = nullptr;
+      Connection* oldest = nullptr;
+      for (Connection& connection : connections) {
+        if (connection.state == CONNECTION_FREE) {
+          slot = &connection;
+          break;
+        }
+        if (evictable(connection, now) && (oldest == nullptr || now - connection.lastActive > now - oldest->lastActive)) {
+          oldest = &connection;
+        }
+      }
+      if (slot == nullptr && oldest == nullptr) {
+        waiting = true;
+        return;
+      }
+
+      struct sockaddr_in peer;
+      socklen_t peerLength = sizeof(peer);
+      int fd = accept(listener, (struct sockaddr*)&peer, &peerLength);
+      if (fd < 0) {
+        waiting = false;
+        return;
+      }
+      if (slot == nullptr) {
+        counters.evicted++;
+        closeConnection(*oldest);
+        slot = oldest;
+      }
+      Connection& connection = *slot;
+
+      fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+      int enable = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+      connection.fd = fd;
+      connection.remoteAddress = peer.sin_family == AF_INET ? peer.sin_addr.s_addr : 0;
+      connection.state = CONNECTION_READING_HEAD;
+      connection.inputLength = 0;
+      connection.served = 0;
+      connection.lastActive = now;
+      counters.accepted++;
+      counters.open++;
+      if (counters.open > counters.maxOpen) counters.maxOpen = counters.open;
+    }
+  }
+
+  void receive(Connection& connection, uint32_t now) {
+    size_t space = sizeof(connection.input) - connection.inputLength;
+    if (space == 0) return;
+    ssize_t received = recv(connection.fd, connection.input + connection.inputLength, space, 0);
+    if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+      closeConnection(connection);
+      return;
+    }
+    if (received < 0) return;
+    connection.inputLength += received;
+    connection.lastActive = now;
+    process(connection, now);
+  }
+
+  // Advance through whatever input is buffered: headers, body, and the
+  // next pipelined request once the last response has gone out
+  void process(Connection& connection, uint32_t now) {
+    for (;;) {
+      if (connection.state == CONNECTION_READING_HEAD) {
+        if (!parseHead(connection)) return;
+      }
+      if (connection.state == CONNECTION_READING_BODY) {
+        consumeBody(connection);
+        if (connection.bodyLeft > 0) return;
+        finishBody(connection);
+        respond(connection);
+      }
+      if (connection.state != CONNECTION_WRITING) return;
+      transmit(connection, now);
+      if (connection.state != CONNECTION_READING_HEAD || connection.inputLength == 0) return;
+    }
+  }
+
+  // Parse a complete request head, if buffered, and pick its route
+  bool parseHead(Connection& connection) {
+    const char* input = connection.input;
+    size_t end = 0;
+    for (size_t i = 3; i < connection.inputLength && end == 0; i++) {
+      if (input[i] == '\n' && input[i - 1] == '\r' && input[i - 2] == '\n' && input[i - 3] == '\r') end = i + 1;
+    }
+    if (end == 0) {
+      if (connection.inputLength == sizeof(connection.input)) reject(connection, 431, "Request headers too large");
+      return false;
+    }
+
+    HttpRequest& request = connection.request;
+    request = HttpRequest();
+    request.id = nextRequestId++;
+    request.remoteAddress = connection.remoteAddress;
+    counters.requests++;
+    if (connection.served++ > 0) counters.keptAlive++;
+
+    // Request line, e.g. "GET /ask?q=hi HTTP/1.1"
+    const char* line = input;
+    const char* lineEnd = (const char*)memchr(line, '\r', end);
+    const char* space = (const char*)memchr(line, ' ', lineEnd - line);
+    const char* target = space != nullptr ? space + 1 : nullptr;
+    const char* targetEnd = target != nullptr ? (const char*)memchr(target, ' ', lineEnd - target) : nullptr;
+    if (targetEnd == nullptr) {
+      consumeInput(connection, end);
+      reject(connection, 400, "Malformed request line");
+      return false;
+    }
+    request.method.assign(line, space - line);
+    std::string uri(target, targetEnd - target);
+    size_t question = uri.find('?');
+    request.path = uri.substr(0, question);
+    if (question != std::string::npos) request.query = uri.substr(question + 1);
+    bool http11 = strncmp(targetEnd + 1, "HTTP/1.1", 8) == 0;
+    request.keepAlive = http11;
+
+    bool chunked = false;
+    for (line = lineEnd + 2; line < input + end - 2; line = lineEnd + 2) {
+      lineEnd = (const char*)memchr(line, '\r', input + end - line);
+      const char* colon = (const char*)memchr(line, ':', lineEnd - line);
+      if (colon == nullptr) continue;
+
+      std::string name(line, colon - line);
+      for (char& c : name) c = tolower((unsigned char)c);
+      const char* value = colon + 1;
+      while (value < lineEnd && (*value == ' ' || *value == '\t')) value++;
+      const char* valueEnd = lineEnd;
+      while (valueEnd > value && (valueEnd[-1] == ' ' || valueEnd[-1] == '\t')) valueEnd--;
+      std::string text(value, valueEnd - value);
+
+      if (name == "content-length") {
+        request.contentLength = strtoul(text.c_str(), nullptr, 10);
+      } else if (name == "transfer-encoding") {
+        chunked = true;
+      } else if (name == "connection") {
+        std::string lower = text;
+        for (char& c : lower) c = tolower((unsigned char)c);
+        if (lower.find("close") != std::string::npos) request.keepAlive = false;
+        else if (lower.find("keep-alive") != std::string::npos) request.keepAlive = true;
+      }
+      request.headers.emplace_back(std::move(name), std::move(text));
+    }
+    consumeInput(connection, end);
+
+    if (chunked) {
+      reject(connection, 411, "Chunked request bodies are not supported");
+      return false;
+    }
+
+    connection.route = findRoute(request);
+    connection.bodyLeft = request.contentLength;
+    connection.state = CONNECTION_READING_BODY;
+    if (connection.route != nullptr && connection.route->body && request.contentLength > 0) {
+      connection.route->body(request, HTTP_BODY_START, nullptr, 0);
+    }
+    return true;
+  }
+
+  const Route* findRoute(HttpRequest& request) {
+    for (const Route& route : routes) {
+      if (route.method != request.method) continue;
+      const std::string& pattern = route.path;
+      size_t braces = pattern.size() >= 2 && pattern.compare(pattern.size() - 2, 2, "{}") == 0 ? pattern.size() - 2 : std::string::npos;
+      if (braces == std::string::npos) {
+        if (pattern == request.path) return &route;
+      } else if (request.path.size() > braces && request.path.compare(0, braces, pattern, 0, braces) == 0 &&
+                 request.path.find('/', braces) == std::string::npos) {
+        request.pathArg = request.path.substr(braces);
+        return &route;
+      }
+    }
+    return nullptr;
+  }
+
+  // Hand buffered body bytes to the route, or drop them if it has no use
+  // for a body
+  void consumeBody(Connection& connection) {
+    size_t take = connection.inputLength < connection.bodyLeft ? connection.inputLength : connection.bodyLeft;
+    if (take == 0) return;
+    if (connection.route != nullptr && connection.route->body) {
+      connection.route->body(connection.request, HTTP_BODY_DATA, (const uint8_t*)connection.input, take);
+    }
+    connection.bodyLeft -= take;
+    consumeInput(connection, take);
+  }
+
+  void finishBody(Connection& connection) {
+    if (connection.route != nullptr && connection.route->body && connection.request.contentLength > 0) {
+      connection.route->body(connection.request, HTTP_BODY_END, nullptr, 0);
+    }
+  }
+
+  void respond(Connection& connection) {
+    HttpResponse& response = connection.response;
+    response = HttpResponse();
+    if (connection.route == nullptr) {
+      response.send(404, "text/plain", "Not found");
+    } else {
+      connection.route->handler(connection.request, response);
+      if (!response.sent()) response.send(500, "text/plain", "No response");
+    }
+    // Hand the slot over if others are waiting for one
+    startResponse(connection, !connection.request.keepAlive || waiting);
+  }
+
+  // Answer without a route, closing afterwards since the rest of the
+  // request can't be trusted
+  void reject(Connection& connection, int status, const char* message) {
+    counters.rejected++;
+    connection.response = HttpResponse();
+    connection.response.send(status, "text/plain", message);
+    connection.inputLength = 0;
+    startResponse(connection, true);
+  }
+
+  void startResponse(Connection& connection, bool closeAfter) {
+    HttpResponse& response = connection.response;
+    size_t length = response.borrowed != nullptr ? response.borrowedLength : response.owned.length();
+    std::string& head = connection.head;
+    head = "HTTP/1.1 ";
+    head += std::to_string(response.statusCode);
+    head += ' ';
+    head += reason(response.statusCode);
+    // 204 and 304 responses have no body to describe
+    if (response.statusCode != 204 && response.statusCode != 304) {
+      head += "\r\nContent-Type: ";
+      head += response.contentType;
+      head += "\r\nContent-Length: ";
+      head += std::to_string(length);
+    }
+    head += closeAfter ? "\r\nConnection: close\r\n" : "\r\nConnection: keep-alive\r\n";
+    head += response.extraHeaders;
+    head += "\r\n";
+    connection.written = 0;
+    connection.responseStarted = microClock();
+    connection.closeAfter = closeAfter;
+    connection.state = CONNECTION_WRITING;
+  }
+
+  // Write as much of the response as the socket takes; the rest goes out
+  // when it is writable again
+  void transmit(Connection& connection, uint32_t now) {
+    if (connection.state != CONNECTION_WRITING) return;
+    const HttpResponse& response = connection.response;
+    const char* body = response.borrowed != nullptr ? response.borrowed : response.owned.data();
+    size_t bodyLength = response.borrowed != nullptr ? response.borrowedLength : response.owned.length();
+    size_t headLength = connection.head.length();
+
+    while (connection.written < headLength + bodyLength) {
+      const char* data;
+      size_t length;
+      if (connection.written < headLength) {
+        data = connection.head.data() + connection.written;
+        length = headLength - connection.written;
+      } else {
+        data = body + (connection.written - headLength);
+        length = bodyLength - (connection.written - headLength);
+      }
+      int flags = MSG_NOSIGNAL;
+#ifdef MSG_MORE
+      if (connection.written < headLength && bodyLength > 0) flags |= MSG_MORE;
+#endif
+      ssize_t sent = send(connection.fd, data, length, flags);
+      if (sent < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) closeConnection(connection);
+        return;
+      }
+      connection.written += sent;
+      connection.lastActive = now;
+    }
+
+    // Done: free the body and wait for the next request
+    sendTimes.record(microClock() - connection.responseStarted);
+    if (connection.closeAfter) {
+      closeConnection(connection);
+      return;
+    }
+    connection.response = HttpResponse();
+    connection.head = std::string();
+    connection.state = CONNECTION_READING_HEAD;
+  }
+
+  void consumeInput(Connection& connection, size_t length) {
+    memmove(connection.input, connection.input + length, connection.inputLength - length);
+    connection.inputLength -= length;
+  }
+
+  void closeConnection(Connection& connection) {
+    if (connection.state == CONNECTION_READING_BODY && connection.route != nullptr &&
+        connection.route->body && connection.request.contentLength > 0) {
+      connection.route->body(connection.request, HTTP_BODY_ABORTED, nullptr, 0);
+    }
+    close(connection.fd);
+    connection.fd = -1;
+    connection.state = CONNECTION_FREE;
+    connection.inputLength = 0;
+    connection.request = HttpRequest();
+    connection.response = HttpResponse();
+    connection.head = std::string();
+    counters.open--;
+  }
+
+  static const char* reason(int status) {
+    switch (status) {
+      case 200: return "OK";
+      case 202: return "Accepted";
+      case 204: return "No Content";
+      case 304: return "Not Modified";
+      case 400: return "Bad Request";
+      case 404: return "Not Found";
+      case 405: return "Method Not Allowed";
+      case 409: return "Conflict";
+      case 411: return "Length Required";
+      case 413: return "Payload Too Large";
+      case 429: return "Too Many Requests";
+      case 431: return "Request Header Fields Too Large";
+      case 500: return "Internal Server Error";
+      case 503: return "Service Unavailable";
+      default: return "";
+    }
+  }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef KB_BENCHMARK_H
+#define KB_BENCHMARK_H
+
+#include <Arduino.h>
+#include "knowledge_base.h"
+
+// Retrieval benchmark over the labelled queries compiled from
+// kb/benchmark.csv. Reports recall@1, recall@k and mean/max latency per
+// query for keyword search and, when available, semantic search, whose
+// query embedding time is reported separately from the index search
+class KnowledgeBenchmark {
+private:
+  struct Result {
+    int hitsAtOne = 0;
+    int hitsAtK = 0;
+    unsigned long totalMicros = 0;
+    unsigned long maxMicros = 0;
+    unsigned long embedMicros = 0;
+  };
+
+public:
+  static void run(KnowledgeBase& kb, Print& out, int k = 3) {
+    if (KB_BENCHMARK_QUERY_COUNT == 0) {
+      out.println("Benchmark: no queries in kb/benchmark.csv");
+      return;
+    }
+
+    Result keyword;
+    Result semantic;
+    bool semanticRan = kb.semanticAvailable();
+
+    for (int i = 0; i < KB_BENCHMARK_QUERY_COUNT; i++) {
+      const KnowledgeQuerySample& sample = kbBenchmarkQueries[i];
+      String query = sample.query;
+
+      unsigned long start = micros();
+      std::vector<KnowledgeMatch> matches = kb.findKeywordMatches(query, k, KB_MIN_SCORE);
+      record(keyword, matches, sample.expected, micros() - start);
+
+      if (semanticRan) {
+        std::vector<float> vector;
+        start = micros();
+        if (!kb.embedQuery(query, vector)) {
+          semanticRan = false;
+          continue;
+        }
+        semantic.embedMicros += micros() - start;
+
+        start = micros();
+        matches = kb.findSemanticMatches(vector.data(), k, KB_SEMANTIC_MIN_SCORE);
+        record(semantic, matches, sample.expected, micros() - start);
+      }
+    }
+
+    out.printf("Benchmark: %d queries, k=%d\n", KB_BENCHMARK_QUERY_COUNT, k);
+    report(out, "keyword ", keyword, k);
+    if (semanticRan) {
+      report(out, "semantic", semantic, k);
+      out.printf("  semantic query embedding: %lu us/query\n", semantic.embedMicros / KB_BENCHMARK_QUERY_COUNT);
+    } else {
+      out.println("  semantic: unavailable (no embeddings or provider)");
+    }
+  }
+
+private:
+  static void record(Result& result, const std::vector<KnowledgeMatch>& matches, int expected, unsigned long elapsed) {
+    for (size_t i = 0; i < matches.size(); i++) {
+      if (matches[i].index == expected) {
+        if (i == 0) result.hitsAtOne++;
+        result.hitsAtK++;
+        break;
+      }
+    }
+    result.totalMicros += elapsed;
+    result.maxMicros = max(result.maxMicros, elapsed);
+  }
+
+  static void report(Print& out, const char* name, const Result& result, int k) {
+    out.printf("  %s recall@1 %.2f  recall@%d %.2f  search %lu us mean, %lu us max\n",
+      name,
+      (float)result.hitsAtOne / KB_BENCHMARK_QUERY_COUNT,
+      k, (float)result.hitsAtK / KB_BENCHMARK_QUERY_COUNT,
+      result.totalMicros / KB_BENCHMARK_QUERY_COUNT, result.maxMicros);
+  }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,170 @@
+#ifndef KB_INGEST_H
+#define KB_INGEST_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+#include "knowledge_base.h"
+
+// Longest record the streaming parser buffers; longer ones are rejected
+#ifndef KB_INGEST_MAX_RECORD
+#define KB_INGEST_MAX_RECORD 4096
+#endif
+
+enum KnowledgeIngestFormat {
+  KB_INGEST_NDJSON,  // {"keywords": "...", "content": "...", "importance": 1.0} per line
+  KB_INGEST_CSV      // keywords,content[,importance] rows, as in kb/corpus.csv
+};
+
+struct KnowledgeIngestStats {
+  uint32_t added;
+  uint32_t rejected;
+  uint32_t bytes;
+  uint32_t elapsedMs;
+  uint32_t peakHeap;  // most heap in use above the level at start
+  int firstId;        // id of the first added entry
+};
+
+// Incremental parser for bulk knowledge uploads. Body chunks are fed as
+// they arrive from the socket, so only the record being parsed is ever
+// buffered. Entries go into one KnowledgeUpdate that the caller commits,
+// which publishes the whole upload as a single new version
+class KnowledgeIngest {
+private:
+  KnowledgeUpdate update;
+  KnowledgeIngestFormat format;
+  std::vector<char> record;  // current record, allocated once
+  bool inQuotes = false;     // CSV newlines inside quotes do not end a record
+  bool overflow = false;     // current record is too long and is skipped
+  bool firstRecord = true;
+  KnowledgeIngestStats counters = {};
+  uint32_t startMs;
+  uint32_t startFreeHeap;
+  uint32_t minFreeHeap;
+
+public:
+  KnowledgeIngest(KnowledgeUpdate&& pending, KnowledgeIngestFormat bodyFormat)
+    : update(std::move(pending)), format(bodyFormat) {
+    startMs = millis();
+    startFreeHeap = ESP.getFreeHeap();
+    minFreeHeap = startFreeHeap;
+    record.reserve(KB_INGEST_MAX_RECORD);
+    counters.firstId = update.getSize();
+  }
+
+  // Consume the next chunk of the body
+  void write(const uint8_t* data, size_t length) {
+    counters.bytes += length;
+    for (size_t i = 0; i < length; i++) {
+      char c = data[i];
+      if (format == KB_INGEST_CSV && c == '"') inQuotes = !inQuotes;
+
+      if (c == '\n' && !inQuotes) {
+        endRecord();
+      } else if (record.size() < KB_INGEST_MAX_RECORD) {
+        record.push_back(c);
+      } else {
+        overflow = true;
+      }
+    }
+    sampleHeap();
+  }
+
+  // Parse a final record that has no trailing newline
+  void finish() {
+    endRecord();
+    counters.elapsedMs = millis() - startMs;
+  }
+
+  void sampleHeap() {
+    minFreeHeap = min(minFreeHeap, (uint32_t)ESP.getFreeHeap());
+    counters.peakHeap = startFreeHeap - minFreeHeap;
+  }
+
+  KnowledgeUpdate& pending() { return update; }
+  const KnowledgeIngestStats& stats() const { return counters; }
+
+private:
+  void endRecord() {
+    if (!record.empty() && record.back() == '\r') record.pop_back();
+
+    bool header = firstRecord && format == KB_INGEST_CSV;
+    firstRecord = false;
+
+    if (overflow) {
+      counters.rejected++;
+    } else if (!record.empty()) {
+      bool ok = format == KB_INGEST_CSV ? parseCsv(header) : parseJson();
+      if (!ok) counters.rejected++;
+    }
+
+    record.clear();
+    inQuotes = false;
+    overflow = false;
+  }
+
+  bool add(const char* keywords, size_t keywordsLength, const char* content, size_t contentLength, float importance) {
+    if (keywordsLength == 0 || contentLength == 0) return false;
+    if (!update.addEntry(keywords, keywordsLength, content, contentLength, importance)) return false;
+    counters.added++;
+    return true;
+  }
+
+  bool parseJson() {
+    JsonDocument doc;
+    if (deserializeJson(doc, record.data(), record.size())) return false;
+
+    const char* keywords = doc["keywords"] | "";
+    const char* content = doc["content"] | "";
+    float importance = doc["importance"] | 1.0f;
+    return add(keywords, strlen(keywords), content, strlen(content), importance);
+  }
+
+  // Split the row into fields in place, unescaping quoted ones
+  bool parseCsv(bool header) {
+    char* fields[3] = {};
+    size_t lengths[3] = {};
+    size_t fieldCount = 0;
+
+    char* in = record.data();
+    char* end = in + record.size();
+    while (in <= end && fieldCount < 3) {
+      char* out = in;
+      fields[fieldCount] = out;
+      if (in < end && *in == '"') {
+        in++;
+        while (in < end) {
+          if (*in == '"' && in + 1 < end && in[1] == '"') {
+            *out++ = '"';
+            in += 2;
+          } else if (*in == '"') {
+            in++;
+            break;
+          } else {
+            *out++ = *in++;
+          }
+        }
+      }
+      while (in < end && *in != ',') *out++ = *in++;
+      lengths[fieldCount] = out - fields[fieldCount];
+      fieldCount++;
+      in++;
+    }
+
+    // A leading "keywords,content,importance" header row is skipped
+    if (header && lengths[0] == 8 && strncasecmp(fields[0], "keywords", 8) == 0) return true;
+    if (fieldCount < 2) return false;
+
+    float importance = 1.0f;
+    if (fieldCount == 3 && lengths[2] > 0) {
+      char number[16];
+      size_t length = min(lengths[2], sizeof(number) - 1);
+      memcpy(number, fields[2], length);
+      number[length] = '\0';
+      importance = atof(number);
+    }
+    return add(fields[0], lengths[0], fields[1], lengths[1], importance);
+  }
+};
+
+#endif
\ No newline at end of file
@@ -3,78 +3,293 @@
 
 #include <Arduino.h>
 #include <vector>
+#include <algorithm>
+#include <mutex>
+#include "async_log.h"
+#include "knowledge_snapshot.h"
+#include "profiler.h"
+#include "snapshot.h"
+#include "knowledge_tables.h"
 
-// Structure for knowledge entries
-struct KnowledgeEntry {
-  String keywords;
-  String content;
-  float importance;
+// Minimum cosine similarity, before importance, for semantic matches
+#ifndef KB_SEMANTIC_MIN_SCORE
+#define KB_SEMANTIC_MIN_SCORE 0.3f
+#endif
+
+enum KnowledgeSearchMode {
+  KB_SEARCH_KEYWORD,
+  KB_SEARCH_SEMANTIC
 };
 
+// A reader's hold on one knowledge base version
+typedef SnapshotRef<KnowledgeSnapshot> KnowledgeView;
+
+// A writer's private copy of the current version. Changes are invisible to
+// readers until KnowledgeBase::commit() publishes them as a new version.
+// Holds the writer lock until committed or destroyed
+class KnowledgeUpdate {
+private:
+  std::unique_lock<std::mutex> lock;
+  KnowledgeSnapshot* next = nullptr;
+
+  friend class KnowledgeBase;
+  KnowledgeUpdate(std::unique_lock<std::mutex>&& writerLock, const KnowledgeSnapshot& base)
+    : lock(std::move(writerLock)) {
+    next = new KnowledgeSnapshot();
+    next->image = base.image;
+    next->store = base.store;
+    next->embeddings = base.embeddings;
+    next->removed = base.removed;
+  }
+
+public:
+  KnowledgeUpdate(KnowledgeUpdate&& other) : lock(std::move(other.lock)), next(other.next) {
+    other.next = nullptr;
+  }
+  KnowledgeUpdate(const KnowledgeUpdate&) = delete;
+  KnowledgeUpdate& operator=(const KnowledgeUpdate&) = delete;
+
+  ~KnowledgeUpdate() { delete next; }
+
+  // False once committed or moved from; changes are then refused
+  bool isOpen() const { return next != nullptr; }
+
+  // Pre-size storage before adding many entries at once
+  void reserve(size_t entryCount, size_t textBytes) {
+    if (!isOpen()) return;
+    next->store.reserve(next->store.size() + entryCount, next->store.textSize() + textBytes);
+  }
+
+  bool addEntry(const char* keywords, size_t keywordsLength,
+                const char* content, size_t contentLength, float importance = 1.0) {
+    if (!isOpen()) return false;
+    if (!next->addEntry(keywords, keywordsLength, content, contentLength, importance)) {
+      LOG_WARN("Knowledge base full, entry dropped");
+      return false;
+    }
+    return true;
+  }
+
+  bool addEntry(const String& keywords, const String& content, float importance = 1.0) {
+    return addEntry(keywords.c_str(), keywords.length(), content.c_str(), content.length(), importance);
+  }
+
+  // Remove an entry from search results. Ids of other entries do not
+  // change until the next persist() compacts the knowledge base
+  bool removeEntry(int index) {
+    if (!isOpen() || index < 0 || index >= getSize() || next->isRemoved(index)) return false;
+    if ((int)next->removed.size() < getSize()) next->removed.resize(getSize());
+    next->removed[index] = true;
+    return true;
+  }
+
+  int getSize() const { return isOpen() ? next->getSize() : 0; }
+};
+
+// Knowledge base shared by readers on any task or core. Readers take a
+// lock-free snapshot of the current version; writers copy it, apply their
+// changes and publish the result atomically. Replaced versions are freed
+// when their last reader lets go
 class KnowledgeBase {
 private:
-  std::vector<KnowledgeEntry> entries;
+  SnapshotCell<KnowledgeSnapshot> versions;
+  std::mutex writer;
+  EmbeddingProvider* embedder = nullptr;
+  KnowledgeSearchMode searchMode = KB_SEARCH_KEYWORD;
 
 public:
   KnowledgeBase() {
-    // Initialize with some default entries
-    addEntry("AI artificial intelligence", "AI stands for Artificial Intelligence.", 1.0);
-    addEntry("ESP32 microcontroller wifi bluetooth", "ESP32 is a microcontroller with WiFi and Bluetooth capabilities.", 1.0);
-    addEntry("Arduino Italy developers", "Arduino was created by developers in Italy.", 1.0);
+    // Start from the corpus compiled into flash by tools/kb_compile.py
+    KnowledgeSnapshot* initial = new KnowledgeSnapshot();
+    initial->image.open(kbCompiledTables);
+    if (kbCompiledEmbeddings.count == kbCompiledTables.entryCount) {
+      initial->embeddings.open(kbCompiledEmbeddings);
+    }
+    versions.publish(initial);
+  }
+
+  // Hold the current version. Indices returned by its searches stay valid
+  // for as long as the view is held
+  KnowledgeView snapshot() {
+    return versions.acquire();
+  }
+
+  // Semantic search needs compiled embeddings and a query embedding
+  // provider; without them findMatches stays in keyword mode. Set up
+  // before readers start
+  void setSearchMode(KnowledgeSearchMode mode, EmbeddingProvider* provider = nullptr) {
+    searchMode = mode;
+    if (provider != nullptr) embedder = provider;
+  }
+
+  bool semanticAvailable() {
+    return embedder != nullptr && snapshot()->hasEmbeddings();
+  }
+
+  // Serve entries straight from a validated image instead of the compiled
+  // corpus. Entries added afterwards are kept in RAM on top of the image
+  bool attachImage(const uint8_t* data, size_t size) {
+    KnowledgeSnapshot* attached = new KnowledgeSnapshot();
+    if (!attached->image.open(data, size)) {
+      delete attached;
+      return false;
+    }
+
+    // Embeddings only describe the compiled corpus, so they are dropped
+    std::lock_guard<std::mutex> lock(writer);
+    versions.publish(attached);
+    return true;
   }
 
-  void addEntry(String keywords, String content, float importance = 1.0) {
-    KnowledgeEntry entry = {keywords, content, importance};
-    entries.push_back(entry);
+  // Write all entries to storage as one image and serve from it. Readers
+  // are moved to a RAM copy first, so none is left reading the partition
+  // while it is rewritten. On failure the entries stay available from RAM
+  bool persist(KnowledgeImageStorage& storage) {
+    std::lock_guard<std::mutex> lock(writer);
+
+    KnowledgeSnapshot* merged = new KnowledgeSnapshot();
+    {
+      KnowledgeView current = snapshot();
+      current->exportTo(merged->store);
+      // Compaction moves every entry after a removed one down, and the
+      // embeddings are a table by entry index, so after a removal they
+      // no longer line up; search falls back to keywords until the
+      // corpus is embedded again. Otherwise the order is unchanged
+      if (current->removedCount() == 0) {
+        merged->embeddings = current->embeddings;
+      } else if (current->hasEmbeddings()) {
+        LOG_WARN("Entries removed, semantic search off until the corpus is embedded again");
+      }
+    }
+    merged->storeTrigrams.build(merged->store);
+    versions.publish(merged);
+    versions.waitForReaders();
+
+    if (!storage.write(merged->store)) return false;
+
+    KnowledgeSnapshot* attached = new KnowledgeSnapshot();
+    if (!attached->image.open(storage.data(), storage.size())) {
+      delete attached;
+      return false;
+    }
+    attached->embeddings = merged->embeddings;
+    versions.publish(attached);
+    return true;
+  }
+
+  // Copy every entry into a finalized store
+  void exportTo(KnowledgeStore& out) {
+    snapshot()->exportTo(out);
+  }
+
+  // Start a batch of changes on a copy of the current version. Blocks
+  // while another writer holds an update
+  KnowledgeUpdate beginUpdate() {
+    std::unique_lock<std::mutex> lock(writer);
+    KnowledgeView current = snapshot();
+    return KnowledgeUpdate(std::move(lock), *current);
+  }
+
+  // Publish an update as the new current version. Returns false, and
+  // publishes nothing, for an update already committed or moved from
+  bool commit(KnowledgeUpdate& update) {
+    if (!update.isOpen()) return false;
+    KnowledgeSnapshot* next = update.next;
+    update.next = nullptr;
+
+    next->finalize();
+    versions.publish(next);
+    update.lock.unlock();
+    return true;
+  }
+
+  // Add one entry and publish it; batch many through beginUpdate()
+  bool addEntry(const String& keywords, const String& content, float importance = 1.0) {
+    KnowledgeUpdate update = beginUpdate();
+    if (!update.addEntry(keywords, content, importance)) return false;
+    return commit(update);
+  }
+
+  bool removeEntry(int index) {
+    KnowledgeUpdate update = beginUpdate();
+    if (!update.removeEntry(index)) return false;
+    return commit(update);
   }
 
   int getSize() {
-    return entries.size();
+    return snapshot()->getSize();
   }
 
   String getContent(int index) {
-    if (index >= 0 && index < entries.size()) {
-      return entries[index].content;
-    }
-    return "";
+    return snapshot()->getContent(index);
+  }
+
+  size_t memoryUsage() {
+    return snapshot()->memoryUsage();
   }
 
-  // Find the best matching entry for a query
+  // Find the best matching entry for a query, or "" when nothing matches
   String getBestMatch(String query) {
-    int bestScore = -1;
-    int bestIndex = 0;
-    
-    query.toLowerCase();
-    
-    for (int i = 0; i < entries.size(); i++) {
-      int score = keywordMatch(query, entries[i].keywords) * entries[i].importance;
-      if (score > bestScore) {
-        bestScore = score;
-        bestIndex = i;
-      }
+    std::vector<float> vector = embedForSearch(query);
+    KnowledgeView view = snapshot();
+    std::vector<KnowledgeMatch> matches = findMatches(*view, query, vector, 1);
+    if (matches.empty()) return "";
+    return view->getContent(matches[0].index);
+  }
+
+  std::vector<KnowledgeMatch> findMatches(const String& query, int maxResults = 3) {
+    std::vector<float> vector = embedForSearch(query);
+    return findMatches(*snapshot(), query, vector, maxResults);
+  }
+
+  // Query embedding for findMatches() in semantic mode, empty in keyword
+  // mode or when the provider fails. Call it before taking the view the
+  // search runs on: the provider may wait on the network, and a view held
+  // that long keeps persist() waiting
+  std::vector<float> embedForSearch(const String& query) {
+    std::vector<float> vector;
+    if (searchMode != KB_SEARCH_SEMANTIC || embedder == nullptr) return vector;
+    if (!embedQuery(query, vector)) {
+      // Still empty when there are no embeddings to search
+      if (!vector.empty()) LOG_WARN("Query embedding failed, using keyword search");
+      vector.clear();
     }
-    
-    return entries[bestIndex].content;
+    return vector;
   }
 
-private:
-  // Score a query against keywords
-  int keywordMatch(String query, String keywords) {
-    int score = 0;
-    keywords.toLowerCase();
-    
-    int start = 0;
-    while (start < query.length()) {
-      int end = query.indexOf(' ', start);
-      if (end == -1) end = query.length();
-      
-      String word = query.substring(start, end);
-      if (keywords.indexOf(word) >= 0) score++;
-      
-      start = end + 1;
+  // Rank entries of a version against a query, by the embedding from
+  // embedForSearch() when there is one and the version has embeddings of
+  // its size, otherwise by keywords. Returns at most maxResults matches,
+  // best first
+  std::vector<KnowledgeMatch> findMatches(const KnowledgeSnapshot& view, const String& query,
+                                          const std::vector<float>& vector, int maxResults = 3) {
+    PROFILE_ZONE("kb.lookup");
+    if (!vector.empty() && view.hasEmbeddings() && vector.size() == view.embeddingDim()) {
+      return view.findSemanticMatches(vector.data(), maxResults, KB_SEMANTIC_MIN_SCORE);
+    }
+    return view.findKeywordMatches(query, maxResults, KB_MIN_SCORE);
+  }
+
+  // Embed a query with the provider at the compiled embedding dimension.
+  // The version is only held to read the dimension, not during the call
+  bool embedQuery(const String& query, std::vector<float>& vector) {
+    uint16_t dim = 0;
+    {
+      KnowledgeView view = snapshot();
+      if (view->hasEmbeddings()) dim = view->embeddingDim();
     }
-    
-    return score;
+    if (embedder == nullptr || dim == 0) return false;
+    PROFILE_ZONE("kb.embed_query");
+    vector.resize(dim);
+    return embedder->embed(query.c_str(), query.length(), vector.data(), vector.size());
+  }
+
+  std::vector<KnowledgeMatch> findSemanticMatches(const float* vector, int maxResults, float minScore) {
+    return snapshot()->findSemanticMatches(vector, maxResults, minScore);
+  }
+
+  std::vector<KnowledgeMatch> findKeywordMatches(const String& query, int maxResults, float minScore) {
+    return snapshot()->findKeywordMatches(query, maxResults, minScore);
   }
 };
 
@@ -0,0 +1,507 @@
+#ifndef KNOWLEDGE_IMAGE_H
+#define KNOWLEDGE_IMAGE_H
+
+#include <algorithm>
+#include "knowledge_store.h"
+#include "trigram_index.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_idf_version.h>
+#include <esp_partition.h>
+#if ESP_IDF_VERSION_MAJOR >= 5
+#include <spi_flash_mmap.h>
+#else
+#include <esp_spi_flash.h>
+#endif
+#else
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Binary knowledge base image, read in place from a flash partition or a
+// memory-mapped file. Layout, all little-endian and 4-byte aligned:
+//   header | records | tokens (lexical order) | trigram keys |
+//   trigram offsets | postings | trigram token ids | text
+#define KB_IMAGE_MAGIC 0x3149424B  // "KBI1"
+#define KB_IMAGE_VERSION 3
+#define KB_PARTITION_LABEL "kb"
+
+// Check the payload CRC when an image is attached. Costs one pass over the
+// image at boot; the header and section bounds are always checked
+#ifndef KB_IMAGE_VERIFY_PAYLOAD
+#define KB_IMAGE_VERIFY_PAYLOAD 1
+#endif
+
+struct KnowledgeImageHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t headerSize;
+  uint32_t imageSize;       // header plus payload
+  uint32_t headerCrc;       // CRC32 of this header with headerCrc zeroed
+  uint32_t payloadCrc;      // CRC32 of everything after the header
+  uint32_t entryCount;
+  uint32_t tokenCount;
+  uint32_t postingCount;
+  uint32_t totalTokens;
+  uint32_t recordsOffset;
+  uint32_t tokensOffset;
+  uint32_t postingsOffset;
+  uint32_t textOffset;
+  uint32_t textSize;
+  uint32_t trigramCount;
+  uint32_t trigramTokenCount;
+  uint32_t trigramKeysOffset;
+  uint32_t trigramOffsetsOffset;
+  uint32_t trigramTokensOffset;
+  uint32_t generation;      // higher is newer, to pick between two stored images
+};
+
+// CRC-32 (IEEE 802.3), nibble table to keep flash use small
+inline uint32_t kbCrc32(const uint8_t* data, size_t length, uint32_t crc = 0) {
+  static const uint32_t table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+  crc = ~crc;
+  for (size_t i = 0; i < length; i++) {
+    crc = table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+    crc = table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+  }
+  return ~crc;
+}
+
+// Pointers to read-only knowledge tables, either inside an image or
+// compiled into the firmware by tools/kb_compile.py. The optional perfect
+// hash maps a token to its id with one probe
+struct KnowledgeTables {
+  const KnowledgeRecord* records;
+  const KnowledgeToken* tokens;   // lexical order
+  const uint16_t* postings;
+  const char* text;
+  const uint16_t* hashSeeds;      // per-bucket displacement seeds, or null
+  const uint16_t* hashSlots;      // token id per slot, KB_NO_TOKEN if empty
+  uint32_t entryCount;
+  uint32_t tokenCount;
+  uint32_t totalTokens;
+  uint32_t hashBuckets;
+  uint32_t hashSize;
+  TrigramTables trigrams;         // token ids are lexical positions
+};
+
+// Labelled query naming the entry it should retrieve, for benchmarks
+struct KnowledgeQuerySample {
+  const char* query;
+  uint16_t expected;
+};
+
+// Read-only view of an image or compiled tables. Exposes the same
+// accessors as KnowledgeStore so ranking code works on either; nothing is
+// parsed or copied
+class KnowledgeImage {
+private:
+  KnowledgeTables view = {};
+  TrigramIndex trigramIndex;
+  size_t bytes = 0;
+
+public:
+  // Validate the image at data and point the view into it
+  bool open(const uint8_t* data, size_t size) {
+    close();
+    if (data == nullptr || size < sizeof(KnowledgeImageHeader) || ((uintptr_t)data & 3) != 0) {
+      return false;
+    }
+
+    KnowledgeImageHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != KB_IMAGE_MAGIC || header.version != KB_IMAGE_VERSION ||
+        header.headerSize != sizeof(KnowledgeImageHeader) || header.imageSize > size) {
+      return false;
+    }
+
+    uint32_t headerCrc = header.headerCrc;
+    header.headerCrc = 0;
+    if (kbCrc32((const uint8_t*)&header, sizeof(header)) != headerCrc) return false;
+
+    if (!sectionFits(header, header.recordsOffset, header.entryCount, sizeof(KnowledgeRecord), 4) ||
+        !sectionFits(header, header.tokensOffset, header.tokenCount, sizeof(KnowledgeToken), 4) ||
+        !sectionFits(header, header.postingsOffset, header.postingCount, sizeof(uint16_t), 2) ||
+        !sectionFits(header, header.textOffset, header.textSize, 1, 1) ||
+        !sectionFits(header, header.trigramKeysOffset, header.trigramCount, sizeof(uint32_t), 4) ||
+        !sectionFits(header, header.trigramOffsetsOffset, header.trigramCount + 1, sizeof(uint32_t), 4) ||
+        !sectionFits(header, header.trigramTokensOffset, header.trigramTokenCount, sizeof(uint16_t), 2) ||
+        header.entryCount > KB_MAX_ENTRIES || header.tokenCount > KB_MAX_TOKENS) {
+      return false;
+    }
+
+#if KB_IMAGE_VERIFY_PAYLOAD
+    if (kbCrc32(data + header.headerSize, header.imageSize - header.headerSize) != header.payloadCrc) {
+      return false;
+    }
+#endif
+
+    KnowledgeTables tables = {};
+    tables.records = (const KnowledgeRecord*)(data + header.recordsOffset);
+    tables.tokens = (const KnowledgeToken*)(data + header.tokensOffset);
+    tables.postings = (const uint16_t*)(data + header.postingsOffset);
+    tables.text = (const char*)(data + header.textOffset);
+    tables.entryCount = header.entryCount;
+    tables.tokenCount = header.tokenCount;
+    tables.totalTokens = header.totalTokens;
+    tables.trigrams.keys = (const uint32_t*)(data + header.trigramKeysOffset);
+    tables.trigrams.offsets = (const uint32_t*)(data + header.trigramOffsetsOffset);
+    tables.trigrams.tokenIds = (const uint16_t*)(data + header.trigramTokensOffset);
+    tables.trigrams.count = header.trigramCount;
+    open(tables);
+    bytes = header.imageSize;
+    return true;
+  }
+
+  // Point the view at tables that are already in memory or flash
+  void open(const KnowledgeTables& tables) {
+    view = tables;
+    trigramIndex.open(tables.trigrams);
+    bytes = 0;
+  }
+
+  void close() {
+    view = KnowledgeTables();
+    trigramIndex.clear();
+    bytes = 0;
+  }
+
+  bool isOpen() const { return view.records != nullptr; }
+  size_t imageSize() const { return bytes; }
+
+  size_t size() const { return view.entryCount; }
+  uint32_t getTotalTokens() const { return view.totalTokens; }
+  const KnowledgeRecord& record(size_t index) const { return view.records[index]; }
+  const char* keywords(size_t index) const { return view.text + view.records[index].keywordsOffset; }
+  const char* content(size_t index) const { return view.text + view.records[index].contentOffset; }
+
+  size_t tokenCount() const { return view.tokenCount; }
+  const KnowledgeToken& token(uint16_t id) const { return view.tokens[id]; }
+  const char* tokenText(uint16_t id) const { return view.text + view.tokens[id].textOffset; }
+  const uint16_t* tokenPostings(uint16_t id) const { return view.postings + view.tokens[id].postingsOffset; }
+
+  // Tokens are stored in lexical order, so ids and positions coincide. An
+  // exact hit through the perfect hash is its own lower bound
+  size_t lowerBound(const char* word, size_t length) const {
+    uint16_t exact = findToken(word, length);
+    if (exact != KB_NO_TOKEN) return exact;
+
+    size_t lo = 0;
+    size_t hi = tokenCount();
+    while (lo < hi) {
+      size_t mid = (lo + hi) / 2;
+      int result = memcmp(tokenText(mid), word, std::min((size_t)view.tokens[mid].length, length));
+      if (result < 0 || (result == 0 && view.tokens[mid].length < length)) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  size_t sortedTokenCount() const { return tokenCount(); }
+  uint16_t sortedToken(size_t position) const { return position; }
+
+  bool tokenStartsWith(uint16_t id, const char* word, size_t length) const {
+    return view.tokens[id].length >= length && memcmp(tokenText(id), word, length) == 0;
+  }
+
+  const TrigramIndex& trigrams() const { return trigramIndex; }
+
+  // Id of the token equal to word through the perfect hash, if present
+  uint16_t findToken(const char* word, size_t length) const {
+    if (view.hashSeeds == nullptr || view.hashBuckets == 0 || view.hashSize == 0) return KB_NO_TOKEN;
+
+    uint32_t bucket = kbHashToken(word, length) % view.hashBuckets;
+    uint32_t slot = kbHashToken(word, length, view.hashSeeds[bucket]) % view.hashSize;
+    uint16_t id = view.hashSlots[slot];
+    if (id == KB_NO_TOKEN || view.tokens[id].length != length || memcmp(tokenText(id), word, length) != 0) {
+      return KB_NO_TOKEN;
+    }
+    return id;
+  }
+
+private:
+  static bool sectionFits(const KnowledgeImageHeader& h, uint32_t offset, uint32_t count,
+                          size_t itemSize, size_t alignment) {
+    uint64_t end = (uint64_t)offset + (uint64_t)count * itemSize;
+    return offset >= h.headerSize && (offset % alignment) == 0 && end <= h.imageSize;
+  }
+};
+
+// Serializes a finalized KnowledgeStore into the image format. The sink is
+// called as sink(offset, data, length) and returns false on failure. The
+// header is written last, so an interrupted write never looks valid
+class KnowledgeImageWriter {
+public:
+  static size_t imageSize(const KnowledgeStore& store) {
+    KnowledgeImageHeader header = layout(store);
+    return header.imageSize;
+  }
+
+  template <typename Sink>
+  static bool write(const KnowledgeStore& store, Sink sink, uint32_t generation = 0) {
+    if (!store.isFinalized()) return false;
+
+    KnowledgeImageHeader header = layout(store);
+    header.generation = generation;
+    uint32_t crc = 0;
+    uint32_t offset = header.headerSize;
+
+    // Records, with the RAM-only entry token list offsets cleared
+    for (size_t i = 0; i < store.size(); i++) {
+      KnowledgeRecord record = store.record(i);
+      record.tokensOffset = 0;
+      if (!emit(sink, offset, &record, sizeof(record), crc)) return false;
+    }
+
+    // Tokens in lexical order; their posting offsets stay valid because
+    // the posting array is written unchanged
+    for (size_t pos = 0; pos < store.sortedTokenCount(); pos++) {
+      KnowledgeToken token = store.token(store.sortedToken(pos));
+      if (!emit(sink, offset, &token, sizeof(token), crc)) return false;
+    }
+
+    // Trigram postings, with store token ids renumbered to lexical positions
+    TrigramIndex trigrams;
+    trigrams.build(store);
+    const TrigramTables& tables = trigrams.tables();
+    std::vector<uint16_t> positions(store.tokenCount());
+    for (size_t pos = 0; pos < store.sortedTokenCount(); pos++) {
+      positions[store.sortedToken(pos)] = pos;
+    }
+
+    if (!emit(sink, offset, tables.keys, tables.count * sizeof(uint32_t), crc)) return false;
+    if (!emit(sink, offset, tables.offsets, (tables.count + 1) * sizeof(uint32_t), crc)) return false;
+    if (!emit(sink, offset, store.postingData(), store.postingCount() * sizeof(uint16_t), crc)) return false;
+    for (size_t i = 0; i < trigrams.tokenIdCount(); i++) {
+      uint16_t position = positions[tables.tokenIds[i]];
+      if (!emit(sink, offset, &position, sizeof(position), crc)) return false;
+    }
+    if (!pad(sink, offset, header.textOffset, crc)) return false;
+    if (!emit(sink, offset, store.textData(), store.textSize(), crc)) return false;
+    if (!pad(sink, offset, header.imageSize, crc)) return false;
+
+    header.payloadCrc = crc;
+    header.headerCrc = 0;
+    header.headerCrc = kbCrc32((const uint8_t*)&header, sizeof(header));
+    return sink(0, (const uint8_t*)&header, sizeof(header));
+  }
+
+private:
+  static KnowledgeImageHeader layout(const KnowledgeStore& store) {
+    TrigramIndex trigrams;
+    trigrams.build(store);
+
+    KnowledgeImageHeader header = {};
+    header.magic = KB_IMAGE_MAGIC;
+    header.version = KB_IMAGE_VERSION;
+    header.headerSize = sizeof(KnowledgeImageHeader);
+    header.entryCount = store.size();
+    header.tokenCount = store.tokenCount();
+    header.postingCount = store.postingCount();
+    header.totalTokens = store.getTotalTokens();
+    header.trigramCount = trigrams.tables().count;
+    header.trigramTokenCount = trigrams.tokenIdCount();
+    header.recordsOffset = header.headerSize;
+    header.tokensOffset = header.recordsOffset + header.entryCount * sizeof(KnowledgeRecord);
+    header.trigramKeysOffset = header.tokensOffset + header.tokenCount * sizeof(KnowledgeToken);
+    header.trigramOffsetsOffset = header.trigramKeysOffset + header.trigramCount * sizeof(uint32_t);
+    header.postingsOffset = header.trigramOffsetsOffset + (header.trigramCount + 1) * sizeof(uint32_t);
+    header.trigramTokensOffset = header.postingsOffset + header.postingCount * sizeof(uint16_t);
+    header.textOffset = align4(header.trigramTokensOffset + header.trigramTokenCount * sizeof(uint16_t));
+    header.textSize = store.textSize();
+    header.imageSize = align4(header.textOffset + header.textSize);
+    return header;
+  }
+
+  static uint32_t align4(uint32_t value) {
+    return (value + 3) & ~3u;
+  }
+
+  template <typename Sink>
+  static bool emit(Sink& sink, uint32_t& offset, const void* data, size_t length, uint32_t& crc) {
+    if (length == 0) return true;
+    crc = kbCrc32((const uint8_t*)data, length, crc);
+    if (!sink(offset, (const uint8_t*)data, length)) return false;
+    offset += length;
+    return true;
+  }
+
+  template <typename Sink>
+  static bool pad(Sink& sink, uint32_t& offset, uint32_t target, uint32_t& crc) {
+    static const uint8_t zeros[4] = {0, 0, 0, 0};
+    return emit(sink, offset, zeros, target - offset, crc);
+  }
+};
+
+#ifdef ARDUINO
+
+// Image storage in the "kb" data partition, mapped into the data cache.
+// The partition holds two images, one per half. A new image is written
+// into the half not in use, header last, and only replaces the current
+// one once it reads back valid, so a failed or interrupted write leaves
+// the previous image to boot from. The valid image with the higher
+// generation is the current one
+class KnowledgeImageStorage {
+private:
+  const esp_partition_t* partition = nullptr;
+  const void* mapped = nullptr;
+  spi_flash_mmap_handle_t handle = 0;
+  int active = -1;  // half holding the current image, -1 when neither does
+  uint32_t generation = 0;
+
+public:
+  bool begin(const char* label = KB_PARTITION_LABEL) {
+    end();
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (partition == nullptr || !map()) return false;
+    pickActive();
+    return true;
+  }
+
+  void end() {
+    if (mapped != nullptr) spi_flash_munmap(handle);
+    mapped = nullptr;
+  }
+
+  // The current image, or the first half when there is none, which then
+  // fails to open
+  const uint8_t* data() const {
+    return mapped ? (const uint8_t*)mapped + std::max(active, 0) * halfSize() : nullptr;
+  }
+  size_t size() const { return mapped ? halfSize() : 0; }
+
+  // Write a new image into the unused half and make it current. Views into
+  // the old mapping become invalid. On failure the previous image stays
+  // current, in flash and after a reboot
+  bool write(const KnowledgeStore& store) {
+    if (partition == nullptr) return false;
+
+    size_t imageSize = KnowledgeImageWriter::imageSize(store);
+    if (imageSize > halfSize()) return false;
+
+    int target = active == 0 ? 1 : 0;
+    uint32_t base = target * halfSize();
+    end();
+    size_t eraseSize = (imageSize + SPI_FLASH_SEC_SIZE - 1) & ~(SPI_FLASH_SEC_SIZE - 1);
+    bool ok = esp_partition_erase_range(partition, base, eraseSize) == ESP_OK &&
+      KnowledgeImageWriter::write(store, [this, base](uint32_t offset, const uint8_t* data, size_t length) {
+        return esp_partition_write(partition, base + offset, data, length) == ESP_OK;
+      }, generation + 1);
+    if (!map()) return false;
+
+    // Read the new image back through the cache before switching to it
+    KnowledgeImage check;
+    if (!ok || !check.open((const uint8_t*)mapped + base, halfSize())) return false;
+    active = target;
+    generation++;
+    return true;
+  }
+
+private:
+  // Halves start on a sector boundary
+  size_t halfSize() const { return (partition->size / 2) & ~(SPI_FLASH_SEC_SIZE - 1); }
+
+  // The newest half holding a valid image, so a damaged image falls back
+  // to the one before it
+  void pickActive() {
+    active = -1;
+    generation = 0;
+    for (int half = 0; half < 2; half++) {
+      const uint8_t* image = (const uint8_t*)mapped + half * halfSize();
+      KnowledgeImage check;
+      if (!check.open(image, halfSize())) continue;
+
+      uint32_t stored = ((const KnowledgeImageHeader*)image)->generation;
+      if (active < 0 || (int32_t)(stored - generation) > 0) {
+        active = half;
+        generation = stored;
+      }
+    }
+  }
+
+  bool map() {
+#if ESP_IDF_VERSION_MAJOR >= 5
+    return esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &mapped, &handle) == ESP_OK;
+#else
+    return esp_partition_mmap(partition, 0, partition->size, SPI_FLASH_MMAP_DATA, &mapped, &handle) == ESP_OK;
+#endif
+  }
+};
+
+#else
+
+// Host build: image storage in a plain file, mapped read-only
+class KnowledgeImageStorage {
+private:
+  std::string path;
+  const void* mapped = nullptr;
+  size_t mappedSize = 0;
+
+public:
+  bool begin(const char* filePath) {
+    end();
+    path = filePath;
+    return map();
+  }
+
+  void end() {
+    if (mapped != nullptr) munmap((void*)mapped, mappedSize);
+    mapped = nullptr;
+    mappedSize = 0;
+  }
+
+  const uint8_t* data() const { return (const uint8_t*)mapped; }
+  size_t size() const { return mappedSize; }
+
+  // Write to a temporary file and rename it over the old image
+  bool write(const KnowledgeStore& store) {
+    std::string tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (file == nullptr) return false;
+
+    bool ok = KnowledgeImageWriter::write(store, [file](uint32_t offset, const uint8_t* data, size_t length) {
+      return fseek(file, offset, SEEK_SET) == 0 && fwrite(data, 1, length, file) == length;
+    });
+    ok = fclose(file) == 0 && ok;
+    if (!ok || rename(tempPath.c_str(), path.c_str()) != 0) {
+      remove(tempPath.c_str());
+      return false;
+    }
+
+    end();
+    return map();
+  }
+
+private:
+  bool map() {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+      void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        mapped = data;
+        mappedSize = info.st_size;
+      }
+    }
+    ::close(fd);
+    return mapped != nullptr;
+  }
+};
+
+#endif
+
+#endif
\ No newline at end of file
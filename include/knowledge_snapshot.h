@@ -0,0 +1,276 @@
+#ifndef KNOWLEDGE_SNAPSHOT_H
+#define KNOWLEDGE_SNAPSHOT_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <math.h>
+#include <string.h>
+#endif
+#include <vector>
+#include <algorithm>
+#include "knowledge_store.h"
+#include "knowledge_image.h"
+#include "embedding_index.h"
+#include "trigram_index.h"
+#include "query_normalizer.h"
+
+// BM25 ranking parameters
+#ifndef KB_BM25_K1
+#define KB_BM25_K1 1.2f
+#endif
+#ifndef KB_BM25_B
+#define KB_BM25_B 0.75f
+#endif
+#ifndef KB_MIN_SCORE
+#define KB_MIN_SCORE 0.5f
+#endif
+
+// A ranked search result
+struct KnowledgeMatch {
+  int index;
+  float score;
+};
+
+// One version of the knowledge base, immutable once published. Readers
+// hold it through a KnowledgeView, so concurrent updates never change it
+// underneath them
+class KnowledgeSnapshot {
+private:
+  KnowledgeImage image;  // compiled-in tables or a persisted image, read in place
+  KnowledgeStore store;  // runtime additions, finalized before publishing
+  TrigramIndex storeTrigrams;  // fuzzy lookup over the runtime tokens
+  EmbeddingIndex embeddings;  // entry embeddings of the compiled corpus
+  std::vector<bool> removed;  // tombstones by entry index, dropped on persist
+
+  friend class KnowledgeBase;
+  friend class KnowledgeUpdate;
+
+public:
+  // Entry ids in use, including removed entries
+  int getSize() const {
+    return image.size() + store.size();
+  }
+
+  bool isRemoved(int index) const {
+    return index < (int)removed.size() && removed[index];
+  }
+
+  int removedCount() const {
+    int count = 0;
+    for (bool entry : removed) count += entry;
+    return count;
+  }
+
+  // Entry text, or "" for an unknown or removed entry
+  const char* content(int index) const {
+    if (index >= 0 && index < getSize() && !isRemoved(index)) {
+      return entryContent(index);
+    }
+    return "";
+  }
+
+#ifdef ARDUINO
+  String getContent(int index) const {
+    return content(index);
+  }
+#endif
+
+  bool hasEmbeddings() const { return embeddings.isOpen(); }
+  uint16_t embeddingDim() const { return embeddings.dim(); }
+
+  // Heap bytes used by entries, text and index; the compiled corpus and
+  // attached images are read from flash and not counted
+  size_t memoryUsage() const {
+    return store.memoryUsage() + storeTrigrams.memoryUsage() + removed.capacity() / 8;
+  }
+
+  // Add an entry to the runtime store; call finalize() before searching
+  bool addEntry(const char* keywords, size_t keywordsLength,
+                const char* content, size_t contentLength, float importance) {
+    return store.addEntry(keywords, keywordsLength, content, contentLength, importance);
+  }
+
+  // Rebuild the runtime postings and trigram index after additions
+  void finalize() {
+    store.finalize();
+    storeTrigrams.build(store);
+  }
+
+  // Copy every entry that was not removed into a finalized store
+  void exportTo(KnowledgeStore& out) const {
+    out.reserve(getSize(), image.imageSize() + store.textSize());
+    for (int i = 0; i < getSize(); i++) {
+      if (isRemoved(i)) continue;
+      const KnowledgeRecord& record = entryRecord(i);
+      out.addEntry(entryKeywords(i), record.keywordsLength, entryContent(i), record.contentLength, record.importance);
+    }
+    out.finalize();
+  }
+
+  // Rank compiled-corpus entries by cosine similarity to a query embedding,
+  // scaled by importance. Entries added at runtime have no embedding
+  std::vector<KnowledgeMatch> findSemanticMatches(const float* vector, int maxResults, float minScore) const {
+    std::vector<KnowledgeMatch> results;
+    if (!embeddings.isOpen() || maxResults <= 0) return results;
+
+    // Over-fetch so importance weighting can still reorder the top results
+    results.resize(std::min((size_t)maxResults * 4, embeddings.size()));
+    results.resize(embeddings.search(vector, results.data(), results.size(), minScore));
+
+    size_t kept = 0;
+    for (size_t i = 0; i < results.size(); i++) {
+      if (isRemoved(results[i].index)) continue;
+      results[i].score *= entryRecord(results[i].index).importance;
+      results[kept++] = results[i];
+    }
+    results.resize(kept);
+    return topMatches(results, maxResults);
+  }
+
+  // Rank entries against a query with BM25 over the keyword tokens, scaled
+  // by importance. Returns at most maxResults matches scoring at least
+  // minScore, best first
+  std::vector<KnowledgeMatch> findKeywordMatches(const char* query, size_t queryLength,
+                                                 int maxResults, float minScore) const {
+    std::vector<KnowledgeMatch> results;
+    if (getSize() == 0 || maxResults <= 0) return results;
+
+    // Lowercased words without punctuation, stopwords or synonyms
+    char normalized[KB_MAX_QUERY_LENGTH];
+    size_t normalizedLength = QueryNormalizer::normalize(query, queryLength, normalized, sizeof(normalized));
+
+    float n = getSize();
+    float avgLength = (image.getTotalTokens() + store.getTotalTokens()) / n;
+    if (avgLength <= 0) avgLength = 1;
+
+    // Per-entry contributions of every query word, summed after sorting so
+    // only entries sharing a token with the query are ever touched
+    std::vector<KnowledgeMatch> contributions;
+    std::vector<KnowledgeMatch> wordScores;
+    size_t start = 0;
+    while (start < normalizedLength) {
+      size_t end = start;
+      while (end < normalizedLength && normalized[end] != ' ') end++;
+
+      const char* word = normalized + start;
+      size_t length = std::min(end - start, (size_t)KB_MAX_TOKEN_LENGTH);
+      wordScores.clear();
+      scoreWord(image, image.trigrams(), 0, word, length, n, avgLength, wordScores);
+      scoreWord(store, storeTrigrams, image.size(), word, length, n, avgLength, wordScores);
+      mergeByEntry(wordScores, false);
+      contributions.insert(contributions.end(), wordScores.begin(), wordScores.end());
+
+      start = end + 1;
+    }
+
+    mergeByEntry(contributions, true);
+
+    for (size_t i = 0; i < contributions.size(); i++) {
+      KnowledgeMatch match = contributions[i];
+      match.score *= entryRecord(match.index).importance;
+      if (match.score >= minScore && !isRemoved(match.index)) results.push_back(match);
+    }
+
+    return topMatches(results, maxResults);
+  }
+
+#ifdef ARDUINO
+  std::vector<KnowledgeMatch> findKeywordMatches(const String& query, int maxResults, float minScore) const {
+    return findKeywordMatches(query.c_str(), query.length(), maxResults, minScore);
+  }
+#endif
+
+private:
+  // Image entries come first, RAM entries follow
+  const KnowledgeRecord& entryRecord(int index) const {
+    if (index < (int)image.size()) return image.record(index);
+    return store.record(index - image.size());
+  }
+
+  const char* entryKeywords(int index) const {
+    if (index < (int)image.size()) return image.keywords(index);
+    return store.keywords(index - image.size());
+  }
+
+  const char* entryContent(int index) const {
+    if (index < (int)image.size()) return image.content(index);
+    return store.content(index - image.size());
+  }
+
+  // BM25 weight of one query word for every entry of a source holding a
+  // keyword that starts with it. Prefix hits are discounted by how much of
+  // the keyword the word covers. Words without a prefix hit fall back to
+  // keywords with similar trigrams, weighted by their similarity, so
+  // misspelled and split words still match. Document frequencies are per
+  // source
+  template <typename Source>
+  void scoreWord(const Source& source, const TrigramIndex& trigrams, int indexBase,
+                 const char* word, size_t length, float n, float avgLength,
+                 std::vector<KnowledgeMatch>& out) const {
+    bool matched = false;
+    for (size_t pos = source.lowerBound(word, length); pos < source.sortedTokenCount(); pos++) {
+      uint16_t id = source.sortedToken(pos);
+      if (!source.tokenStartsWith(id, word, length)) break;
+
+      scoreToken(source, indexBase, id, (float)length / source.token(id).length, n, avgLength, out);
+      matched = true;
+    }
+
+    if (!matched && length >= KB_FUZZY_MIN_LENGTH) {
+      std::vector<TrigramMatch> similar;
+      trigrams.findSimilar(source, word, length, KB_FUZZY_MIN_SIMILARITY, similar);
+      for (size_t i = 0; i < similar.size(); i++) {
+        scoreToken(source, indexBase, similar[i].token, similar[i].similarity, n, avgLength, out);
+      }
+    }
+  }
+
+  // BM25 weight of one token, scaled by how well it matched, for each
+  // entry in its posting list
+  template <typename Source>
+  void scoreToken(const Source& source, int indexBase, uint16_t id, float weight,
+                  float n, float avgLength, std::vector<KnowledgeMatch>& out) const {
+    const KnowledgeToken& token = source.token(id);
+    const uint16_t* postings = source.tokenPostings(id);
+    float df = token.postingsCount;
+    float idf = logf(1.0f + (n - df + 0.5f) / (df + 0.5f));
+
+    for (size_t i = 0; i < token.postingsCount; i++) {
+      float norm = 1.0f - KB_BM25_B + KB_BM25_B * source.record(postings[i]).tokenCount / avgLength;
+      KnowledgeMatch match = {indexBase + postings[i], idf * weight * (KB_BM25_K1 + 1.0f) / (1.0f + KB_BM25_K1 * norm)};
+      out.push_back(match);
+    }
+  }
+
+  // Keep the best maxResults matches, best score first and earlier entries
+  // winning ties
+  static std::vector<KnowledgeMatch> topMatches(std::vector<KnowledgeMatch>& results, int maxResults) {
+    size_t count = std::min((size_t)maxResults, results.size());
+    std::partial_sort(results.begin(), results.begin() + count, results.end(),
+      [](const KnowledgeMatch& x, const KnowledgeMatch& y) {
+        return x.score > y.score || (x.score == y.score && x.index < y.index);
+      });
+    results.resize(count);
+    return results;
+  }
+
+  // Collapse matches to one per entry, summing or keeping the best score
+  static void mergeByEntry(std::vector<KnowledgeMatch>& matches, bool sum) {
+    std::sort(matches.begin(), matches.end(),
+      [](const KnowledgeMatch& x, const KnowledgeMatch& y) { return x.index < y.index; });
+
+    size_t out = 0;
+    for (size_t i = 0; i < matches.size(); i++) {
+      if (out > 0 && matches[out - 1].index == matches[i].index) {
+        if (sum) matches[out - 1].score += matches[i].score;
+        else matches[out - 1].score = std::max(matches[out - 1].score, matches[i].score);
+      } else {
+        matches[out++] = matches[i];
+      }
+    }
+    matches.resize(out);
+  }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,299 @@
+#ifndef KNOWLEDGE_STORE_H
+#define KNOWLEDGE_STORE_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <ctype.h>
+#include <stdint.h>
+#include <string.h>
+#endif
+#include <vector>
+#include <algorithm>
+
+// Store limits: entry and token ids are 16-bit, text fields are at most
+// 64 KB each and keyword tokens longer than this are truncated
+#define KB_MAX_ENTRIES 65535
+#define KB_MAX_TOKENS 65535
+#define KB_MAX_FIELD_LENGTH 65535
+#define KB_MAX_TOKEN_LENGTH 32
+
+#define KB_NO_TOKEN 0xFFFF
+
+// FNV-1a hash of a token. The seed perturbs the basis for the perfect
+// hash displacement in compiled tables. constexpr so fixed word lists can
+// be hashed by the compiler
+constexpr uint32_t kbHashToken(const char* text, size_t length, uint32_t seed = 0) {
+  uint32_t hash = 2166136261u ^ seed;
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ (uint8_t)text[i]) * 16777619u;
+  }
+  return hash;
+}
+
+// Split text into lowercase words, the same way for keywords and queries:
+// letters, digits, '+' and '#' make up words ("c++", "c#"), hyphens inside
+// a word join ("wi-fi" is "wifi") and anything else separates. Words are
+// cut to KB_MAX_TOKEN_LENGTH; visit(word, length) gets each one
+template <typename Visitor>
+void kbForEachWord(const char* text, size_t length, Visitor visit) {
+  char word[KB_MAX_TOKEN_LENGTH];
+  size_t wordLength = 0;
+  for (size_t i = 0; i <= length; i++) {
+    char c = i < length ? tolower((unsigned char)text[i]) : ' ';
+    if (isalnum((unsigned char)c) || c == '+' || c == '#') {
+      if (wordLength < KB_MAX_TOKEN_LENGTH) word[wordLength++] = c;
+      continue;
+    }
+    if (c == '-' && wordLength > 0) continue;
+    if (wordLength == 0) continue;
+
+    visit(word, wordLength);
+    wordLength = 0;
+  }
+}
+
+// Fixed-size entry record. Text lives in the store's arena and is
+// NUL-terminated, so offsets can be handed out as C strings
+struct KnowledgeRecord {
+  uint32_t keywordsOffset;
+  uint32_t contentOffset;
+  uint32_t tokensOffset;    // first token id in the entry token list
+  uint16_t keywordsLength;
+  uint16_t contentLength;
+  uint16_t tokenCount;      // keyword tokens, the BM25 document length
+  uint16_t reserved;
+  float importance;
+};
+
+// Interned lowercase keyword token and its posting list
+struct KnowledgeToken {
+  uint32_t textOffset;
+  uint32_t postingsOffset;  // first entry id in the posting array
+  uint16_t postingsCount;
+  uint8_t length;
+  uint8_t reserved;
+};
+
+// Compact knowledge storage: one contiguous text arena, interned keyword
+// tokens with 16-bit ids and fixed-size records of offsets. Postings are
+// laid out as one flat array that finalize() rebuilds after insertions,
+// so a bulk load is reserve(), many addEntry() calls and one finalize()
+class KnowledgeStore {
+private:
+  std::vector<char> arena;
+  std::vector<KnowledgeRecord> records;
+  std::vector<KnowledgeToken> tokens;
+  std::vector<uint16_t> entryTokens;   // token ids of every entry, in order
+  std::vector<uint16_t> tokenSlots;    // open-addressing intern table
+  std::vector<uint16_t> postings;      // entry ids grouped by token
+  std::vector<uint16_t> sortedTokens;  // token ids in lexical order
+  uint32_t totalTokens = 0;
+  bool finalized = true;
+
+public:
+  // Pre-size every array for a bulk load so the arena and tables are
+  // allocated once instead of growing through repeated reallocation
+  void reserve(size_t entryCount, size_t textBytes, size_t tokenCount = 0) {
+    if (tokenCount == 0) tokenCount = entryCount * 4;
+    arena.reserve(textBytes);
+    records.reserve(entryCount);
+    tokens.reserve(tokenCount);
+    entryTokens.reserve(entryCount * 4);
+    postings.reserve(entryCount * 4);
+    sortedTokens.reserve(tokenCount);
+    resizeSlots(tokenCount);
+  }
+
+  // Append an entry, returning false when a store limit is reached
+  bool addEntry(const char* keywords, size_t keywordsLength,
+                const char* content, size_t contentLength, float importance) {
+    if (records.size() >= KB_MAX_ENTRIES ||
+        keywordsLength > KB_MAX_FIELD_LENGTH || contentLength > KB_MAX_FIELD_LENGTH) {
+      return false;
+    }
+
+    KnowledgeRecord record = {};
+    record.keywordsOffset = appendText(keywords, keywordsLength);
+    record.keywordsLength = keywordsLength;
+    record.contentOffset = appendText(content, contentLength);
+    record.contentLength = contentLength;
+    record.tokensOffset = entryTokens.size();
+    record.importance = importance;
+
+    // Intern each keyword word, tokenized like queries are
+    kbForEachWord(keywords, keywordsLength, [&](const char* word, size_t length) {
+      uint16_t id = intern(word, length);
+      if (id != KB_NO_TOKEN) {
+        entryTokens.push_back(id);
+        record.tokenCount++;
+      }
+    });
+
+    records.push_back(record);
+    totalTokens += record.tokenCount;
+    finalized = false;
+    return true;
+  }
+
+  // Rebuild the flat posting array and the lexical token order
+  void finalize() {
+    if (finalized) return;
+
+    for (size_t t = 0; t < tokens.size(); t++) {
+      tokens[t].postingsCount = 0;
+    }
+
+    // Count each token once per entry, then lay postings out by token
+    forEachDistinctToken([this](uint16_t, uint16_t id) {
+      tokens[id].postingsCount++;
+    });
+
+    uint32_t offset = 0;
+    for (size_t t = 0; t < tokens.size(); t++) {
+      tokens[t].postingsOffset = offset;
+      offset += tokens[t].postingsCount;
+      tokens[t].postingsCount = 0;
+    }
+
+    postings.resize(offset);
+    forEachDistinctToken([this](uint16_t entry, uint16_t id) {
+      KnowledgeToken& token = tokens[id];
+      postings[token.postingsOffset + token.postingsCount++] = entry;
+    });
+
+    sortedTokens.resize(tokens.size());
+    for (size_t t = 0; t < tokens.size(); t++) {
+      sortedTokens[t] = t;
+    }
+    std::sort(sortedTokens.begin(), sortedTokens.end(), [this](uint16_t x, uint16_t y) {
+      return strcmp(tokenText(x), tokenText(y)) < 0;
+    });
+
+    finalized = true;
+  }
+
+  bool isFinalized() const { return finalized; }
+
+  size_t size() const { return records.size(); }
+  uint32_t getTotalTokens() const { return totalTokens; }
+  const KnowledgeRecord& record(size_t index) const { return records[index]; }
+  const char* keywords(size_t index) const { return &arena[records[index].keywordsOffset]; }
+  const char* content(size_t index) const { return &arena[records[index].contentOffset]; }
+
+  size_t tokenCount() const { return tokens.size(); }
+  const KnowledgeToken& token(uint16_t id) const { return tokens[id]; }
+  const char* tokenText(uint16_t id) const { return &arena[tokens[id].textOffset]; }
+  const uint16_t* tokenPostings(uint16_t id) const { return postings.data() + tokens[id].postingsOffset; }
+
+  // Position in lexical token order of the first token not less than the
+  // word; tokens sharing the word as a prefix follow it contiguously
+  size_t lowerBound(const char* word, size_t length) const {
+    size_t lo = 0;
+    size_t hi = sortedTokens.size();
+    while (lo < hi) {
+      size_t mid = (lo + hi) / 2;
+      if (compareToken(sortedTokens[mid], word, length) < 0) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  const uint16_t* postingData() const { return postings.data(); }
+  size_t postingCount() const { return postings.size(); }
+  const char* textData() const { return arena.data(); }
+  size_t textSize() const { return arena.size(); }
+
+  size_t sortedTokenCount() const { return sortedTokens.size(); }
+  uint16_t sortedToken(size_t position) const { return sortedTokens[position]; }
+
+  bool tokenStartsWith(uint16_t id, const char* word, size_t length) const {
+    return tokens[id].length >= length && memcmp(tokenText(id), word, length) == 0;
+  }
+
+  // Bytes held by the store, including reserved but unused capacity
+  size_t memoryUsage() const {
+    return sizeof(*this) +
+      arena.capacity() * sizeof(char) +
+      records.capacity() * sizeof(KnowledgeRecord) +
+      tokens.capacity() * sizeof(KnowledgeToken) +
+      entryTokens.capacity() * sizeof(uint16_t) +
+      tokenSlots.capacity() * sizeof(uint16_t) +
+      postings.capacity() * sizeof(uint16_t) +
+      sortedTokens.capacity() * sizeof(uint16_t);
+  }
+
+private:
+  uint32_t appendText(const char* text, size_t length) {
+    uint32_t offset = arena.size();
+    arena.insert(arena.end(), text, text + length);
+    arena.push_back('\0');
+    return offset;
+  }
+
+  // Compare a stored token with a lowercase word of the given length
+  int compareToken(uint16_t id, const char* word, size_t length) const {
+    const KnowledgeToken& token = tokens[id];
+    int result = memcmp(tokenText(id), word, std::min((size_t)token.length, length));
+    if (result != 0) return result;
+    return (int)token.length - (int)length;
+  }
+
+  // Return the id of a lowercase word, adding it on first use
+  uint16_t intern(const char* lower, size_t length) {
+    if ((tokens.size() + 1) * 2 > tokenSlots.size()) {
+      resizeSlots(std::max(tokens.size() * 2, (size_t)16));
+    }
+
+    size_t mask = tokenSlots.size() - 1;
+    size_t slot = kbHashToken(lower, length) & mask;
+    while (tokenSlots[slot] != KB_NO_TOKEN) {
+      uint16_t id = tokenSlots[slot];
+      if (compareToken(id, lower, length) == 0) return id;
+      slot = (slot + 1) & mask;
+    }
+
+    if (tokens.size() >= KB_MAX_TOKENS) return KB_NO_TOKEN;
+
+    KnowledgeToken token = {};
+    token.textOffset = appendText(lower, length);
+    token.length = length;
+    tokenSlots[slot] = tokens.size();
+    tokens.push_back(token);
+    return tokens.size() - 1;
+  }
+
+  // Size the intern table to a power of two with room for the tokens
+  void resizeSlots(size_t tokenCount) {
+    size_t size = 16;
+    while (size < tokenCount * 2) size *= 2;
+    if (size <= tokenSlots.size()) return;
+
+    tokenSlots.assign(size, KB_NO_TOKEN);
+    for (size_t t = 0; t < tokens.size(); t++) {
+      size_t slot = kbHashToken(tokenText(t), tokens[t].length) & (size - 1);
+      while (tokenSlots[slot] != KB_NO_TOKEN) slot = (slot + 1) & (size - 1);
+      tokenSlots[slot] = t;
+    }
+  }
+
+  // Visit every (entry, token) pair once, skipping repeated tokens
+  template <typename Visitor>
+  void forEachDistinctToken(Visitor visit) {
+    for (size_t e = 0; e < records.size(); e++) {
+      const uint16_t* ids = entryTokens.data() + records[e].tokensOffset;
+      for (size_t i = 0; i < records[e].tokenCount; i++) {
+        bool repeated = false;
+        for (size_t j = 0; j < i && !repeated; j++) {
+          repeated = ids[j] == ids[i];
+        }
+        if (!repeated) visit(e, ids[i]);
+      }
+    }
+  }
+};
+
+#endif
\ No newline at end of file
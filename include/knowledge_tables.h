@@ -0,0 +1,271 @@
+// Generated by tools/kb_compile.py from kb/benchmark.csv, kb/corpus.csv, kb/embeddings.jsonl. Do not edit.
+#ifndef KNOWLEDGE_TABLES_H
+#define KNOWLEDGE_TABLES_H
+
+#include "knowledge_image.h"
+#include "embedding_index.h"
+
+constexpr KnowledgeRecord kbTableRecords[] = {
+  {0, 27, 0, 26, 38, 3, 0, 1.0f},
+  {66, 103, 0, 36, 64, 4, 0, 1.0f},
+  {168, 193, 0, 24, 43, 3, 0, 1.0f},
+  {237, 271, 0, 33, 115, 4, 0, 1.2f},
+  {387, 426, 0, 38, 110, 4, 0, 1.0f},
+  {537, 567, 0, 29, 98, 3, 0, 1.0f},
+};
+
+constexpr KnowledgeToken kbTableTokens[] = {
+  {666, 0, 1, 2, 0},
+  {669, 1, 2, 7, 0},
+  {677, 3, 1, 10, 0},
+  {688, 4, 1, 9, 0},
+  {698, 5, 1, 12, 0},
+  {711, 6, 1, 10, 0},
+  {722, 7, 1, 11, 0},
+  {734, 8, 1, 11, 0},
+  {746, 9, 2, 5, 0},
+  {752, 11, 1, 8, 0},
+  {761, 12, 1, 9, 0},
+  {771, 13, 1, 3, 0},
+  {775, 14, 1, 12, 0},
+  {788, 15, 1, 5, 0},
+  {794, 16, 1, 15, 0},
+  {810, 17, 1, 10, 0},
+  {821, 18, 1, 11, 0},
+  {833, 19, 1, 5, 0},
+  {839, 20, 1, 4, 0},
+};
+
+constexpr uint16_t kbTablePostings[] = {
+  0, 2, 5, 0, 1, 3, 2, 4, 4, 1, 3, 3, 5, 4, 0, 2,
+  1, 4, 5, 3, 1,
+};
+
+constexpr uint16_t kbTableHashSeeds[] = {
+  1, 33, 6, 8, 1,
+};
+
+constexpr uint16_t kbTableHashSlots[] = {
+  2, 18, 0, 9, 11, 7, 3, 65535, 14, 16, 65535, 12, 17, 6, 13, 4,
+  5, 65535, 65535, 65535, 1, 10, 8, 15,
+};
+
+constexpr uint32_t kbTableTrigramKeys[] = {
+  0x016169, 0x016172, 0x01626c, 0x016361, 0x016465, 0x01656e, 0x016573, 0x016665,
+  0x016672, 0x016964, 0x01696e, 0x016974, 0x016d69, 0x01706c, 0x017072, 0x017370,
+  0x017769, 0x333202, 0x616269, 0x616902, 0x616c02, 0x616c79, 0x616d65, 0x616d6d,
+  0x617061, 0x617264, 0x617274, 0x617466, 0x617475, 0x62696c, 0x626c75, 0x636170,
+  0x636502, 0x636961, 0x636f6e, 0x63726f, 0x637302, 0x646502, 0x646576, 0x647569,
+  0x656174, 0x656373, 0x656c6c, 0x656c6f, 0x656e63, 0x656e74, 0x656e76, 0x657202,
+  0x657273, 0x657302, 0x657370, 0x65746f, 0x657665, 0x65776f, 0x666561, 0x666902,
+  0x666963, 0x666f72, 0x667261, 0x67656e, 0x677261, 0x69616c, 0x696369, 0x696372,
+  0x696465, 0x696573, 0x696669, 0x696765, 0x696c69, 0x696e67, 0x696e6f, 0x696e74,
+  0x696f02, 0x69726f, 0x697461, 0x697469, 0x6c6174, 0x6c6572, 0x6c6967, 0x6c6974,
+  0x6c6c65, 0x6c6c69, 0x6c6f70, 0x6c7565, 0x6c7902, 0x6d656e, 0x6d6577, 0x6d6963,
+  0x6d696e, 0x6d696f, 0x6d6d69, 0x6e6365, 0x6e6702, 0x6e6d65, 0x6e6f02, 0x6e7402,
+  0x6e7465, 0x6e7472, 0x6e7669, 0x6f636f, 0x6f6772, 0x6f6c6c, 0x6f6e6d, 0x6f6e74,
+  0x6f6f74, 0x6f7065, 0x6f706d, 0x6f726b, 0x6f726d, 0x6f7468, 0x703332, 0x706162,
+  0x706563, 0x706572, 0x706c61, 0x706d65, 0x70726f, 0x72616d, 0x726475, 0x726573,
+  0x726b02, 0x726d69, 0x726f63, 0x726f67, 0x726f6c, 0x726f6e, 0x727302, 0x727469,
+  0x737033, 0x737065, 0x74616c, 0x74656c, 0x74666f, 0x746802, 0x746965, 0x746966,
+  0x746f6f, 0x74726f, 0x747572, 0x756574, 0x75696e, 0x757265, 0x76656c, 0x766972,
+  0x776966, 0x776f72,
+};
+
+constexpr uint32_t kbTableTrigramOffsets[] = {
+  0, 1, 3, 4, 5, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17,
+  18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33,
+  34, 35, 36, 37, 38, 39, 40, 42, 43, 44, 45, 46, 48, 49, 51, 52,
+  53, 54, 56, 57, 58, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70,
+  71, 72, 73, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87,
+  88, 89, 90, 92, 93, 94, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105,
+  107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122,
+  123, 124, 125, 126, 127, 128, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139,
+  140, 141, 142, 143, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 156,
+  157, 158, 159,
+};
+
+constexpr uint16_t kbTableTrigramTokens[] = {
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+  16, 17, 18, 8, 4, 0, 2, 13, 10, 16, 4, 1, 2, 15, 9, 4,
+  3, 4, 12, 2, 14, 14, 17, 11, 5, 6, 1, 9, 17, 12, 5, 6,
+  12, 6, 7, 7, 14, 5, 4, 9, 8, 3, 5, 6, 10, 9, 18, 2,
+  15, 10, 12, 16, 2, 2, 14, 11, 4, 2, 18, 12, 4, 16, 1, 12,
+  15, 7, 13, 4, 15, 14, 12, 4, 14, 12, 5, 6, 3, 13, 6, 7,
+  10, 14, 16, 15, 16, 12, 16, 7, 1, 6, 7, 12, 14, 7, 14, 16,
+  14, 7, 14, 3, 5, 6, 10, 15, 3, 8, 4, 17, 5, 15, 6, 16,
+  10, 16, 1, 9, 10, 15, 14, 16, 14, 7, 5, 2, 8, 17, 13, 12,
+  15, 3, 4, 2, 3, 14, 9, 3, 1, 9, 5, 6, 7, 18, 10,
+};
+
+constexpr char kbTableText[] =
+  "AI artificial intelligence\000"
+  "AI stands for Artificial Intelligence.\000"
+  "ESP32 microcontroller wifi bluetooth\000"
+  "ESP32 is a microcontroller with WiFi and Bluetooth capabilities.\000"
+  "Arduino Italy developers\000"
+  "Arduino was created by developers in Italy.\000"
+  "ESP32 features capabilities specs\000"
+  "The ESP32 is a powerful microcontroller with dual-core processor, WiFi, Bluetooth, and extensive GPIO capabilities.\000"
+  "PlatformIO IDE development environment\000"
+  "PlatformIO is a cross-platform IDE and unified debugger that supports many development boards including ESP32.\000"
+  "Arduino framework programming\000"
+  "The Arduino framework provides a simple and accessible way to program microcontrollers with C/C++.\000"
+  "ai\000"
+  "arduino\000"
+  "artificial\000"
+  "bluetooth\000"
+  "capabilities\000"
+  "developers\000"
+  "development\000"
+  "environment\000"
+  "esp32\000"
+  "features\000"
+  "framework\000"
+  "ide\000"
+  "intelligence\000"
+  "italy\000"
+  "microcontroller\000"
+  "platformio\000"
+  "programming\000"
+  "specs\000"
+  "wifi\000";
+
+constexpr KnowledgeTables kbCompiledTables = {
+  kbTableRecords, kbTableTokens, kbTablePostings, kbTableText,
+  kbTableHashSeeds, kbTableHashSlots,
+  6, 19, 21, 5, 24,
+  {kbTableTrigramKeys, kbTableTrigramOffsets, kbTableTrigramTokens, 146}
+};
+
+
+// Entries were embedded by the local stand-in, so queries must be too
+#ifndef KB_EMBEDDING_HASHING
+#define KB_EMBEDDING_HASHING
+#endif
+
+alignas(KB_EMBEDDING_ALIGN) constexpr int8_t kbTableEmbeddings[] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 64, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 64, 64, 0, 0, -32, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 32, 0, 0, -64, 0, 0, 0, 0, 64, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, -64, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -64, 0,
+  0, 64, 0, 0, 64, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -64, 0, 0, 0, 32, 0,
+  -64, 0, 0, 0, 0, 0, 0, 0, 0, 0, 64, 0, 0, 0, 64, 0,
+  -95, 0, 0, 0, 0, 0, 0, 0, 32, 0, 0, 0, 0, 0, 0, 127,
+  0, 0, 0, -64, 64, 0, 32, 0, 0, 0, 0, 0, -32, 0, 0, 0,
+  0, 0, 0, 0, -64, 0, 0, 0, 0, 0, 0, 0, 0, -64, 0, 0,
+  0, 0, 127, 0, 0, 0, 0, 0, 0, -64, 0, 64, 0, 0, 0, 0,
+  0, 127, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  32, 0, 64, 0, 0, 0, 0, 0, 0, 0, 0, 64, 64, 0, 0, 0,
+  -64, 0, 0, 64, 32, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  -21, -21, -42, 0, -42, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, -42, 0, 0, 0, 42, 0, 42, 0, 0, 0, 0, -42, 85, 0, 42,
+  0, 0, 0, 21, 0, 0, 0, 0, 0, 0, 0, 0, -85, 42, 0, 0,
+  0, 64, 0, 0, 0, -42, 0, -21, 21, 0, 0, 0, 0, 0, -85, 0,
+  0, 42, 0, 0, 0, 0, 42, 0, 85, 0, 0, -42, -21, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 42, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 21, 0, 0, 0, 0, 0, 0, 0, 0, -42, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 42, -21, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 42, 0, 0, 0, 0, 0, 0, 0,
+  0, 21, -42, 0, 0, 0, 0, 85, 21, 21, 0, 0, 42, -42, 0, 0,
+  0, 0, 0, 0, 0, 0, 64, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, -42, 21, 85, 0, 0, 0, 21, 0, -42, 0, 42,
+  42, 0, 0, -21, 0, 0, 0, 0, 0, 0, 21, 0, 0, 42, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  -42, 0, 0, 0, 0, 0, 0, 0, -21, 0, 0, 0, 0, 0, 0, 127,
+  0, 64, 0, 0, 0, 0, -42, 0, -42, 0, 0, 21, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -32, 0, 0, 0, 63,
+  32, 0, 0, 0, 63, 0, 0, 32, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 63, 32, 63, 32, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, -32, 0, 0, 63, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 63, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, -63, 0, 0, 0, 0, 0, 0, 0, 0, -127, 0, 63, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 63, 0, 63, 0, 0, 0, 0, 0,
+  0, -63, 63, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 63, 0, 0, 0, 0, 32, 127, -127, 0, 0, 63, 0,
+  0, 0, 0, 0, 63, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 63, 63, -63, 0, -63, 63,
+  0, 0, 0, 0, 0, 63, 0, 0, 0, 0, 0, 0, 0, 0, 32, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 32, -63, 0, -32,
+  32, 0, 0, -63, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 95, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  -51, -51, -25, 0, -25, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 25,
+  25, -25, -25, 0, 0, 51, 0, 25, 0, 51, 0, 0, -102, 102, 0, 51,
+  0, 0, 0, 25, 0, 25, 0, 25, 0, 0, 0, 0, -76, 25, 0, -25,
+  25, 76, 0, -25, 25, -25, 0, -76, 25, 0, 0, 0, 0, 0, -76, 0,
+  0, 25, 0, 25, 0, 0, 25, 25, 51, 0, 0, -25, -25, 0, 0, -25,
+  0, 0, 0, 0, -25, 0, 0, 0, 25, 0, 0, 51, 0, 0, 0, -51,
+  0, 0, 0, 0, 25, 51, 0, 25, 0, 0, -51, 0, 0, 0, -25, 0,
+  0, 0, 25, 0, 25, 25, 0, 0, 0, 0, 25, -51, 25, 0, -25, 0,
+  0, 0, 0, 0, -25, -25, -25, 0, 25, 0, 0, 25, 0, 0, 0, 0,
+  0, 25, -51, 0, 0, 0, 0, 76, 51, 51, 0, 0, 25, -25, 0, 0,
+  -25, 0, 0, 0, 0, 0, 76, 0, 0, -25, 0, 0, 0, 0, 0, 0,
+  -25, 0, 0, 0, 0, -25, 51, 0, 0, 0, 0, 51, 0, -25, 0, 102,
+  51, 25, 0, -51, 0, 25, 25, -51, 0, 0, 76, 0, 0, 51, 0, 0,
+  0, 0, 0, 0, 0, 25, -25, 0, 0, -51, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, -25, 0, 0, 0, -25, -25, -25, 0, 25, 0, 25, 127,
+  0, 51, 0, 0, 0, 0, -25, 0, -25, 0, -51, 51, 0, 0, 0, -25,
+  0, -42, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 21, 42,
+  0, 0, 0, 42, 42, 42, 0, 21, 0, 0, 0, 0, 0, 64, 0, 21,
+  21, 0, 0, 21, 21, 0, 21, 0, 0, 21, 0, 0, -85, 0, 0, 0,
+  0, 21, 21, 0, 21, -21, 0, 0, -21, 0, 0, 0, -21, 21, -42, 0,
+  0, 0, 0, 0, 0, -42, 0, -21, 0, 21, 0, 0, -21, 21, 0, 0,
+  -21, 42, 0, 0, 42, 0, 0, 0, 0, 0, 0, 21, 0, 0, 42, 127,
+  0, -64, 0, 0, 0, 0, 0, 0, 0, 0, 0, -64, -21, 0, 64, -21,
+  0, 0, 0, 0, 0, 21, 0, 0, 42, 0, 0, 0, 0, 0, 0, 0,
+  -21, 0, 21, 0, 0, 0, 21, -21, 106, 0, 0, 0, 0, -21, 0, 0,
+  -64, 21, -21, 0, 0, 0, 0, 0, 0, 0, 21, 42, 21, -21, 64, 0,
+  0, 0, -42, 21, 0, 0, 64, 0, 0, 0, 85, 0, -21, -42, 0, 21,
+  21, 0, 42, 0, 21, 0, 21, 0, 0, 21, 21, 0, -42, -21, 0, -21,
+  0, 0, -21, 0, -42, 42, 0, 21, 0, 0, 21, -64, 0, 0, 0, 0,
+  -42, 0, 0, 0, 0, 0, 21, 0, 0, 0, 64, 0, 21, 0, 0, 0,
+  0, 0, 42, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -21,
+  21, 21, -42, 0, 0, 0, 21, 0, 0, 42, 42, -21, 0, 0, 0, 21,
+  32, 0, 64, -32, -32, 0, 0, 0, 0, 0, 64, 127, 0, 0, -64, 64,
+  0, 0, -32, 0, 0, 0, 64, 32, 0, 0, 0, 0, -127, 0, 0, 64,
+  0, 0, 64, 0, 64, 0, 0, 0, 0, 0, 0, 0, -95, 0, -64, 0,
+  0, 32, 0, 0, 0, 0, 0, -32, 0, 0, 0, 0, 0, -64, 0, 0,
+  0, 0, 0, 95, 0, 0, 95, 64, 0, 0, 32, 95, -32, 0, 0, -64,
+  0, 0, -127, 0, 0, 32, 0, -32, 95, 0, -64, 0, 0, 0, 0, 32,
+  0, 0, 0, 64, 95, 0, 0, 0, 0, 32, 0, 0, 0, 0, -32, 0,
+  -64, 0, 0, 0, 0, 0, 0, 0, 0, 32, 64, 0, 0, 0, 0, 64,
+  0, -64, 32, -32, 0, 0, 0, 0, 32, 0, 0, 0, 64, 0, 0, 0,
+  0, 0, -32, 0, -32, 0, 0, 64, 0, 32, 32, -127, 0, -32, 0, 0,
+  0, -32, 0, 0, 0, 0, 95, 0, 0, 0, 0, -64, 0, 0, 0, 0,
+  -64, 0, 0, 0, 0, -32, 0, 0, 0, 0, 64, 0, 0, 0, -32, 32,
+  64, 0, 0, 0, 0, 32, 0, 0, 0, 0, 32, 64, 32, 32, 0, 0,
+  0, 0, 0, 0, 32, 0, -32, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  -32, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 32, 32,
+  0, 64, 0, 0, 0, 64, 0, 0, -32, 0, 0, 0, 0, 0, 0, 0,
+};
+
+constexpr float kbTableEmbeddingScales[] = {
+  0.0024822374999656717f, 0.002803421239828001f, 0.002489982409581402f, 0.002296112405518465f, 0.002636901812809945f, 0.0019097293309947472f,
+};
+
+constexpr EmbeddingTables kbCompiledEmbeddings = {
+  kbTableEmbeddings, kbTableEmbeddingScales, 6, 256
+};
+
+#define KB_BENCHMARK_QUERY_COUNT 12
+
+constexpr KnowledgeQuerySample kbBenchmarkQueries[] = {
+  {"what is AI", 0},
+  {"explain machine intelligence", 0},
+  {"microcontroller radio", 1},
+  {"which chip has wireless networking", 1},
+  {"who invented arduino", 2},
+  {"where does arduino come from", 2},
+  {"esp32 specifications", 3},
+  {"how many cores does the esp32 processor have", 3},
+  {"platformio editor", 4},
+  {"what tool can I use to debug boards", 4},
+  {"how to program with the arduino framework", 5},
+  {"writing C++ for microcontrollers", 5},
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <Arduino.h>
+
+// Values below 16 get a bucket each; above that every power of two is
+// split into 8 buckets, so percentiles are within 12.5% of the true value
+#define LATENCY_EXACT_BUCKETS 16
+#define LATENCY_SUB_BUCKETS 8
+#define LATENCY_BUCKETS (LATENCY_EXACT_BUCKETS + (32 - 4) * LATENCY_SUB_BUCKETS)
+
+// Log-bucketed histogram of durations, for percentiles without keeping
+// samples. Fixed size, and recording is a few instructions
+class LatencyHistogram {
+private:
+  uint32_t counts[LATENCY_BUCKETS] = {};
+  uint32_t total = 0;
+  uint32_t largest = 0;
+  uint64_t sum = 0;
+
+public:
+  void record(uint32_t value) {
+    counts[bucketOf(value)]++;
+    total++;
+    sum += value;
+    if (value > largest) largest = value;
+  }
+
+  void reset() { *this = LatencyHistogram(); }
+
+  uint32_t count() const { return total; }
+  uint32_t maxValue() const { return largest; }
+  uint32_t mean() const { return total > 0 ? (uint32_t)(sum / total) : 0; }
+
+  // Smallest bucket bound that at least fraction of the values fall under
+  uint32_t percentile(float fraction) const {
+    if (total == 0) return 0;
+    float exact = fraction * total;
+    uint32_t rank = (uint32_t)exact;
+    if (rank < exact || rank == 0) rank++;
+    uint32_t seen = 0;
+    for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+      seen += counts[i];
+      if (seen >= rank) return min(upperBound(i), largest);
+    }
+    return largest;
+  }
+
+  // One line: count, p50, p95, p99 and max, in the recorded unit
+  void print(Print& out, const char* name, const char* unit) const {
+    out.printf("%s: %u samples, p50 %u %s, p95 %u %s, p99 %u %s, max %u %s\n", name, total,
+               percentile(0.50f), unit, percentile(0.95f), unit, percentile(0.99f), unit, largest, unit);
+  }
+
+private:
+  static size_t bucketOf(uint32_t value) {
+    if (value < LATENCY_EXACT_BUCKETS) return value;
+    int exponent = 31 - __builtin_clz(value);
+    return LATENCY_EXACT_BUCKETS + (exponent - 4) * LATENCY_SUB_BUCKETS + ((value >> (exponent - 3)) & 7);
+  }
+
+  static uint32_t upperBound(size_t bucket) {
+    if (bucket < LATENCY_EXACT_BUCKETS) return bucket;
+    size_t exponent = (bucket - LATENCY_EXACT_BUCKETS) / LATENCY_SUB_BUCKETS + 4;
+    size_t sub = (bucket - LATENCY_EXACT_BUCKETS) % LATENCY_SUB_BUCKETS;
+    return (uint32_t)(((uint64_t)(LATENCY_SUB_BUCKETS + sub + 1) << (exponent - 3)) - 1);
+  }
+};
+
+#endif
\ No newline at end of file
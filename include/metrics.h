@@ -0,0 +1,120 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <string>
+
+// Bucket upper bounds of stage histograms, in microseconds, and the same
+// in seconds as Prometheus labels them; one more bucket holds the rest
+#define STAGE_BUCKETS 16
+
+// Fixed-bucket histogram of stage durations, recorded from any task.
+// Recording is a bucket search and two or three relaxed atomic adds: no
+// locks and no allocation, so it can sit on the request path. A reader
+// may see a sample's count before its sum; scrapes tolerate that
+class StageHistogram {
+public:
+  static constexpr uint32_t bounds[STAGE_BUCKETS] = {
+    100, 250, 500, 1000, 2500, 5000, 10000, 25000,
+    50000, 100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000
+  };
+  static constexpr const char* labels[STAGE_BUCKETS] = {
+    "0.0001", "0.00025", "0.0005", "0.001", "0.0025", "0.005", "0.01", "0.025",
+    "0.05", "0.1", "0.25", "0.5", "1", "2.5", "5", "10"
+  };
+
+private:
+  std::atomic<uint32_t> counts[STAGE_BUCKETS + 1];
+  // The sum in microseconds overflows 32 bits in about an hour, so it is
+  // kept as two words with the carry added separately
+  std::atomic<uint32_t> sumLow;
+  std::atomic<uint32_t> sumHigh;
+
+public:
+  StageHistogram() {
+    for (std::atomic<uint32_t>& count : counts) count.store(0, std::memory_order_relaxed);
+    sumLow.store(0, std::memory_order_relaxed);
+    sumHigh.store(0, std::memory_order_relaxed);
+  }
+
+  void record(uint32_t micros) {
+    size_t bucket = 0;
+    while (bucket < STAGE_BUCKETS && micros > bounds[bucket]) bucket++;
+    counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    uint32_t before = sumLow.fetch_add(micros, std::memory_order_relaxed);
+    if (before + micros < before) sumHigh.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Samples in bucket alone, not counting those below it
+  uint32_t bucketCount(size_t bucket) const { return counts[bucket].load(std::memory_order_relaxed); }
+
+  uint64_t sumMicros() const {
+    return ((uint64_t)sumHigh.load(std::memory_order_relaxed) << 32) | sumLow.load(std::memory_order_relaxed);
+  }
+};
+
+// Writes metrics in the Prometheus text exposition format
+class MetricsWriter {
+private:
+  std::string& out;
+
+public:
+  explicit MetricsWriter(std::string& text) : out(text) {}
+
+  // The HELP and TYPE lines that precede a metric's samples
+  void describe(const char* name, const char* type, const char* help) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+  }
+
+  // One sample; labels, if any, without braces, e.g. stage="connect"
+  void sample(const char* name, const char* labels, double value) {
+    char number[24];
+    snprintf(number, sizeof(number), "%.9g", value);
+    out += name;
+    if (labels != nullptr && labels[0] != '\0') {
+      out += '{';
+      out += labels;
+      out += '}';
+    }
+    out += ' ';
+    out += number;
+    out += '\n';
+  }
+
+  void counter(const char* name, const char* help, double value) {
+    describe(name, "counter", help);
+    sample(name, nullptr, value);
+  }
+
+  void gauge(const char* name, const char* help, double value) {
+    describe(name, "gauge", help);
+    sample(name, nullptr, value);
+  }
+
+  // The cumulative buckets, sum and count of a histogram already
+  // described, in seconds
+  void histogram(const char* name, const char* labels, const StageHistogram& histogram) {
+    std::string bucketName = std::string(name) + "_bucket";
+    std::string prefix = labels != nullptr && labels[0] != '\0' ? std::string(labels) + "," : std::string();
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i <= STAGE_BUCKETS; i++) {
+      cumulative += histogram.bucketCount(i);
+      std::string bucketLabels = prefix + "le=\"" + (i < STAGE_BUCKETS ? StageHistogram::labels[i] : "+Inf") + "\"";
+      sample(bucketName.c_str(), bucketLabels.c_str(), (double)cumulative);
+    }
+    sample((std::string(name) + "_sum").c_str(), labels, histogram.sumMicros() / 1e6);
+    sample((std::string(name) + "_count").c_str(), labels, (double)cumulative);
+  }
+};
+
+#endif
\ No newline at end of file
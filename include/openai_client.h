@@ -2,114 +2,349 @@
 #define OPENAI_CLIENT_H
 
 #include <Arduino.h>
-#include <WiFiClientSecure.h>
 #include <ArduinoJson.h>
 #include "../lib/config.h"
+#include "async_log.h"
+#include "embedding_index.h"
+#include "metrics.h"
+#include "response_cache.h"
+#include "response_codec.h"
+#include "persistent_cache.h"
+#include "profiler.h"
+#include "semantic_cache.h"
+#include "sse_parser.h"
+#include "upstream_connection.h"
+
+// Point these at tools/tls_standin.py to measure the client locally
+#ifndef OPENAI_API_HOST
+#define OPENAI_API_HOST "api.openai.com"
+#endif
+#ifndef OPENAI_API_PORT
+#define OPENAI_API_PORT 443
+#endif
+
+// Bytes of an unsuccessful streamed reply kept for its error message
+#ifndef OPENAI_ERROR_BODY
+#define OPENAI_ERROR_BODY 512
+#endif
+
+// Must match the model used by tools/kb_embed.py
+#ifndef KB_EMBEDDING_MODEL
+#define KB_EMBEDDING_MODEL "text-embedding-3-small"
+#endif
+
+// Log the timings of one successful API request in this many
+#ifndef API_LOG_EVERY
+#define API_LOG_EVERY 10
+#endif
+
+// Time spent in each stage of an API request, for /metrics
+struct OpenAIStageTimes {
+  StageHistogram connect;    // TCP connect and TLS handshake, when not kept alive
+  StageHistogram firstByte;  // request sent until the status line arrived
+  StageHistogram bodyRead;   // status line until the end of the body
+  StageHistogram jsonParse;  // parsing the reply, without waiting for it
+};
 
 class OpenAIClient {
 private:
-  const char* host = "api.openai.com";
-  const int port = 443;
-  
-  // Simple LRU cache for responses
-  struct CacheEntry {
-    String prompt;
-    String response;
-    unsigned long timestamp;
-  };
+  // Kept-alive TLS connection shared by chat and embedding requests
+  UpstreamConnection upstream;
+  OpenAIStageTimes times;
   
-  static const int MAX_CACHE_SIZE = 5;
-  CacheEntry cache[MAX_CACHE_SIZE];
-  int cacheCount = 0;
+  // Compressed responses keyed by a digest of the system prompt and
+  // prompt, in RAM and optionally on flash behind it
+  ResponseCache cache;
+  PersistentCache* persistentCache = nullptr;
+  SemanticCache similarQuestions;  // paraphrases -> response cache keys
+
+  // Reply filters, built once here so concurrent requests only read them
+  JsonDocument embeddingFilter;  // the vector and any error
+  JsonDocument chatFilter;       // the answer and any error
+  JsonDocument deltaFilter;      // the content of a streamed chunk
 
 public:
-  OpenAIClient() {
-    // Initialize cache
-    for (int i = 0; i < MAX_CACHE_SIZE; i++) {
-      cache[i] = {"", "", 0};
-    }
+  OpenAIClient() : upstream(OPENAI_API_HOST, OPENAI_API_PORT) {
+    embeddingFilter["data"][0]["embedding"] = true;
+    embeddingFilter["error"] = true;
+    chatFilter["choices"][0]["message"]["content"] = true;
+    chatFilter["error"] = true;
+    deltaFilter["choices"][0]["delta"]["content"] = true;
+  }
+
+  // Keep responses on flash too, so they survive reboots and OTA updates
+  void setPersistentCache(PersistentCache* store) {
+    persistentCache = store;
+  }
+
+  // Cache key of a prompt under a system prompt
+  static uint64_t cacheKey(const String& prompt, const String& systemPrompt) {
+    uint64_t key = responseDigest(systemPrompt.c_str(), systemPrompt.length() + 1);
+    return responseDigest(prompt.c_str(), prompt.length(), key);
+  }
+
+  // Answer paraphrased questions from the cache. A similarity above 1
+  // turns near-duplicate lookups off
+  void setSemanticCache(bool enabled, float minSimilarity = SEMANTIC_CACHE_MIN_SIMILARITY) {
+    similarQuestions.configure(enabled, minSimilarity);
   }
 
+  const SemanticCacheStats& semanticCacheStats() const { return similarQuestions.stats(); }
+
   // Check if a response is in the cache
-  String getCachedResponse(String prompt) {
-    for (int i = 0; i < cacheCount; i++) {
-      if (cache[i].prompt == prompt) {
-        // Update timestamp to mark as recently used
-        cache[i].timestamp = millis();
-        return cache[i].response;
-      }
+  String getCachedResponse(const String& prompt, const String& systemPrompt = "You are a helpful assistant.") {
+    return getCachedResponse(cacheKey(prompt, systemPrompt));
+  }
+
+  String getCachedResponse(uint64_t key) {
+    std::vector<uint8_t> blob;
+    String response;
+    if (getCachedBlob(key, blob)) ResponseCodec::decode(blob.data(), blob.size(), response);
+    return response;
+  }
+
+  // The cached response for key as stored, a ResponseCodec blob
+  bool getCachedBlob(uint64_t key, std::vector<uint8_t>& blob) {
+    if (cache.get(key, blob)) return true;
+
+    // Promote flash hits so repeats are served from RAM
+    if (persistentCache != nullptr && persistentCache->get(key, blob) &&
+        ResponseCodec::valid(blob.data(), blob.size())) {
+      cache.put(key, blob.data(), blob.size());
+      return true;
     }
-    return "";
+    return false;
   }
 
   // Add a response to the cache
-  void cacheResponse(String prompt, String response) {
-    // If cache is full, find the least recently used entry
-    if (cacheCount >= MAX_CACHE_SIZE) {
-      int oldestIndex = 0;
-      unsigned long oldestTime = cache[0].timestamp;
-      
-      for (int i = 1; i < MAX_CACHE_SIZE; i++) {
-        if (cache[i].timestamp < oldestTime) {
-          oldestTime = cache[i].timestamp;
-          oldestIndex = i;
-        }
-      }
-      
-      // Replace the oldest entry
-      cache[oldestIndex].prompt = prompt;
-      cache[oldestIndex].response = response;
-      cache[oldestIndex].timestamp = millis();
-    } else {
-      // Add to cache
-      cache[cacheCount].prompt = prompt;
-      cache[cacheCount].response = response;
-      cache[cacheCount].timestamp = millis();
-      cacheCount++;
+  void cacheResponse(const String& prompt, const String& response,
+                     const String& systemPrompt = "You are a helpful assistant.") {
+    cacheResponse(cacheKey(prompt, systemPrompt), response);
+  }
+
+  // Responses are compressed once here and stay compressed in RAM and on
+  // flash until they are served
+  void cacheResponse(uint64_t key, const String& response) {
+    if (response.length() > RESPONSE_CODEC_MAX_LENGTH) return;
+
+    std::vector<uint8_t> blob;
+    ResponseCodec::encode(response.c_str(), response.length(), blob);
+    cache.put(key, blob.data(), blob.size());
+    if (persistentCache != nullptr) {
+      persistentCache->put(key, blob.data(), blob.size());
+    }
+  }
+
+  const ResponseCacheStats& cacheStats() const { return cache.stats(); }
+
+  // Handshake and request timings of the API connection
+  const UpstreamStats& upstreamStats() const { return upstream.stats(); }
+  const OpenAIStageTimes& stageTimes() const { return times; }
+
+  // Upkeep: one bounded step of flash cache compaction, and closing the
+  // API connection once it has been idle too long. Call it from the task
+  // that makes the requests
+  void tick() {
+    if (persistentCache != nullptr) persistentCache->tick();
+    upstream.closeIfIdle();
+  }
+
+  // Find the cached answer to a question sent inside a larger prompt,
+  // still compressed. Besides the exact prompt, the cache is searched for
+  // earlier questions with the same contextId (a digest of the retrieved
+  // passages) that are near-duplicates of this one
+  bool findCachedResponse(const String& prompt, const String& question, uint64_t contextId,
+                          std::vector<uint8_t>& blob,
+                          const String& systemPrompt = "You are a helpful assistant.") {
+    PROFILE_ZONE("cache.lookup");
+    if (getCachedBlob(cacheKey(prompt, systemPrompt), blob)) return true;
+
+    uint64_t similarKey;
+    if (similarQuestions.find(contextId, SemanticCache::signature(question), similarKey) &&
+        getCachedBlob(similarKey, blob)) {
+      LOG_DEBUG("Using cached response to a similar question");
+      return true;
     }
+    return false;
+  }
+
+  // Query the API for a question findCachedResponse() missed, and cache
+  // the answer for it and its paraphrases
+  String requestResponse(const String& prompt, const String& question, uint64_t contextId,
+                         const String& systemPrompt = "You are a helpful assistant.") {
+    uint64_t key = cacheKey(prompt, systemPrompt);
+    String response = queryAndCache(key, prompt, systemPrompt);
+    if (!response.startsWith("Error:")) {
+      similarQuestions.remember(contextId, SemanticCache::signature(question), key);
+    }
+    return response;
+  }
+
+  // Like requestResponse(), but with the answer streamed: each piece is
+  // passed to onText(const String&) as the model generates it, and the
+  // whole answer is returned and cached once it is complete
+  template <typename TextSink>
+  String streamResponse(const String& prompt, const String& question, uint64_t contextId, TextSink onText,
+                        const String& systemPrompt = "You are a helpful assistant.") {
+    uint64_t key = cacheKey(prompt, systemPrompt);
+    String response = queryStream(prompt, systemPrompt, onText);
+    if (response.length() > 0 && !response.startsWith("Error:")) {
+      cacheResponse(key, response);
+      similarQuestions.remember(contextId, SemanticCache::signature(question), key);
+    }
+    return response;
+  }
+
+  // Get a response for a question sent inside a larger prompt, from the
+  // cache when it or a paraphrase was answered before
+  String getResponse(const String& prompt, const String& question, uint64_t contextId,
+                     const String& systemPrompt = "You are a helpful assistant.") {
+    std::vector<uint8_t> blob;
+    String response;
+    if (findCachedResponse(prompt, question, contextId, blob, systemPrompt) &&
+        ResponseCodec::decode(blob.data(), blob.size(), response)) {
+      return response;
+    }
+    return requestResponse(prompt, question, contextId, systemPrompt);
   }
 
   // Get a response from OpenAI, using cache if available
   String getResponse(String prompt, String systemPrompt = "You are a helpful assistant.") {
     // Check cache first
-    String cachedResponse = getCachedResponse(prompt);
+    uint64_t key = cacheKey(prompt, systemPrompt);
+    String cachedResponse = getCachedResponse(key);
     if (cachedResponse.length() > 0) {
-      Serial.println("Using cached response");
+      LOG_DEBUG("Using cached response (%u hits, %u misses, %u evictions)",
+                cache.stats().hits, cache.stats().misses, cache.stats().evictions);
       return cachedResponse;
     }
     
     // Not in cache, query the API
+    return queryAndCache(key, prompt, systemPrompt);
+  }
+
+  // Embed text with the embeddings API into a dim-sized vector
+  bool getEmbedding(const char* text, size_t length, float* out, size_t dim) {
+    JsonDocument doc;
+    doc["model"] = KB_EMBEDDING_MODEL;
+    doc["input"] = JsonString(text, length);
+    doc["dimensions"] = dim;
+
+    JsonDocument resDoc;
+    String error = postJson("/v1/embeddings", doc, resDoc, embeddingFilter);
+    if (error.length() > 0) {
+      LOG_WARN("%s", error.c_str());
+      return false;
+    }
+
+    JsonArray values = resDoc["data"][0]["embedding"].as<JsonArray>();
+    if (values.size() != dim) return false;
+
+    size_t i = 0;
+    for (JsonVariant value : values) {
+      out[i++] = value.as<float>();
+    }
+    return true;
+  }
+
+private:
+  // Query the API and cache a valid response under key
+  String queryAndCache(uint64_t key, const String& prompt, const String& systemPrompt) {
     String response = queryAPI(prompt, systemPrompt);
-    
-    // Cache the response if valid
     if (response.length() > 0 && !response.startsWith("Error:")) {
-      cacheResponse(prompt, response);
+      cacheResponse(key, response);
     }
-    
     return response;
   }
 
-private:
   // Make the actual API call
   String queryAPI(String prompt, String systemPrompt) {
-    WiFiClientSecure client;
-    client.setInsecure();  // Note: In production, use proper certificate validation
-    
-    Serial.println("Connecting to OpenAI API...");
+    // Create JSON request
+    JsonDocument doc;
+    chatRequest(doc, prompt, systemPrompt);
     
-    // Connection with timeout
-    unsigned long connectionStart = millis();
-    while (!client.connect(host, port)) {
-      if (millis() - connectionStart > 10000) {
-        return "Error: Connection timeout";
-      }
-      delay(100);
+    JsonDocument resDoc;
+    String error = postJson("/v1/chat/completions", doc, resDoc, chatFilter);
+    if (error.length() > 0) {
+      return error;
     }
     
-    Serial.println("Connected to API server");
+    String result = resDoc["choices"][0]["message"]["content"] | "No response";
+    result.trim();
     
-    // Create JSON request
+    return result;
+  }
+
+  // Make the API call with a streamed reply. The model sends the answer
+  // as server-sent events, one per token or so, ending with [DONE]
+  template <typename TextSink>
+  String queryStream(const String& prompt, const String& systemPrompt, TextSink& onText) {
     JsonDocument doc;
+    chatRequest(doc, prompt, systemPrompt);
+    doc["stream"] = true;
+    
+    SseParser events;
+    String result;
+    String errorBody;  // failures come back as a plain JSON reply
+    bool done = false;
+    uint32_t parseUs = 0;
+    int status = sendJson("/v1/chat/completions", doc, [&](UpstreamConnection::Body& body) {
+      bool failed = body.status() < 200 || body.status() >= 300;
+      size_t length;
+      const char* data;
+      while ((data = body.next(length)) != nullptr) {
+        if (failed) {
+          if (errorBody.length() < OPENAI_ERROR_BODY) {
+            errorBody.concat(data, min(length, (size_t)OPENAI_ERROR_BODY - errorBody.length()));
+          }
+          continue;
+        }
+        events.feed(data, length, [&](const String& event) {
+          if (event == "[DONE]") {
+            done = true;
+            return;
+          }
+          String delta;
+          unsigned long parseStart = micros();
+          bool parsed = chatDelta(event, delta);
+          parseUs += micros() - parseStart;
+          if (!parsed) return;
+          
+          // Leading whitespace is trimmed, as for a whole reply
+          if (result.length() == 0) delta.trim();
+          if (delta.length() == 0) return;
+          result += delta;
+          onText(delta);
+        });
+      }
+    });
+    if (status > 0) times.jsonParse.record(parseUs);
+    
+    if (status == 200 && done) {
+      result.trim();
+      return result.length() > 0 ? result : String("No response");
+    }
+    if (status == 0 || status == 200) {
+      // Dropped part way through; what was streamed is not cached
+      return result.length() > 0 ? "Error: Response interrupted" : "Error: Connection failed";
+    }
+    
+    JsonDocument resDoc;
+    if (!deserializeJson(resDoc, errorBody) && resDoc["error"].is<JsonObject>()) {
+      return "Error: " + String(resDoc["error"]["message"].as<const char*>());
+    }
+    return "Error: HTTP " + String(status);
+  }
+
+  // Text of one streamed completion chunk; false if it is not valid JSON
+  bool chatDelta(const String& event, String& delta) {
+    JsonDocument chunk;
+    if (deserializeJson(chunk, event, DeserializationOption::Filter(deltaFilter))) return false;
+    delta = chunk["choices"][0]["delta"]["content"] | "";
+    return true;
+  }
+
+  static void chatRequest(JsonDocument& doc, const String& prompt, const String& systemPrompt) {
     doc["model"] = "gpt-3.5-turbo";
     JsonArray messages = doc["messages"].to<JsonArray>();
     
@@ -120,76 +355,88 @@ private:
     JsonObject user = messages.add<JsonObject>();
     user["role"] = "user";
     user["content"] = prompt;
-    
-    String body;
-    serializeJson(doc, body);
-    
-    // Create HTTP request
-    String request =
-      "POST /v1/chat/completions HTTP/1.1\r\n" +
-      String("Host: ") + host + "\r\n" +
-      "Authorization: Bearer " + OPENAI_API_KEY + "\r\n" +
-      "Content-Type: application/json\r\n" +
-      "Content-Length: " + body.length() + "\r\n\r\n" +
-      body;
-    
-    // Send request
-    client.print(request);
-    
-    // Read response with timeout
-    String response = "";
-    unsigned long timeout = millis();
-    bool headerComplete = false;
-    
-    while (client.connected() || client.available()) {
-      if (client.available()) {
-        String line = client.readStringUntil('\n');
-        
-        // Skip headers until we find an empty line
-        if (!headerComplete) {
-          if (line == "\r") {
-            headerComplete = true;
-          }
-          continue;
-        }
-        
-        response += line;
-        timeout = millis();
-      }
-      
-      if (millis() - timeout > 15000) {
-        Serial.println("Response timeout");
-        break;
-      }
-      
-      // Small delay to allow data to arrive
-      delay(10);
+  }
+
+  static String apiHeaders() {
+    return String("Authorization: Bearer ") + OPENAI_API_KEY + "\r\n" +
+           "Content-Type: application/json\r\n";
+  }
+
+  void logRequest(int status) {
+    const UpstreamTimings& timings = upstream.lastTimings();
+    if (status != 200) {
+      LOG_WARN("API: HTTP %d after %u ms", status, (unsigned)timings.requestMs);
+      return;
     }
-    
-    // Parse JSON response
-    int jsonStart = response.indexOf('{');
-    if (jsonStart == -1) {
-      return "Error: Invalid response format";
+    // Timings of successful requests are in /metrics; log a sample
+    LOG_EVERY(API_LOG_EVERY, LOG_INFO, "API %s: HTTP %d, connect %u ms, handshake %u ms, first byte %u ms, total %u ms",
+              timings.reused ? "kept-alive" : timings.resumed ? "resumed session" : "full handshake",
+              status, (unsigned)timings.connectMs, (unsigned)timings.handshakeMs,
+              (unsigned)timings.firstByteMs, (unsigned)timings.requestMs);
+  }
+
+  // POST a JSON document to the API, serialized straight onto the
+  // connection, and pass the reply body to readBody(UpstreamConnection::Body&)
+  template <typename BodyReader>
+  int sendJson(const char* path, JsonDocument& doc, BodyReader readBody) {
+    PROFILE_ZONE("api.request");
+    int status = upstream.post(path, apiHeaders(), measureJson(doc),
+                               [&doc](UpstreamWriter& out) { serializeJson(doc, out); },
+                               readBody);
+    logRequest(status);
+    if (status > 0) recordTimings();
+    return status;
+  }
+
+  void recordTimings() {
+    const UpstreamTimings& timings = upstream.lastTimings();
+    if (!timings.reused) times.connect.record((timings.connectMs + timings.handshakeMs) * 1000);
+    times.firstByte.record(timings.firstByteMs * 1000);
+    times.bodyRead.record((timings.requestMs - timings.firstByteMs) * 1000);
+  }
+
+  // POST a JSON document to the API and parse the JSON reply as it is
+  // received, keeping only what filter selects. Returns an "Error: ..."
+  // string on failure, or "" on success
+  String postJson(const char* path, JsonDocument& doc, JsonDocument& resDoc, JsonDocument& filter) {
+    DeserializationError error;
+    uint32_t parseUs = 0;
+    int status = sendJson(path, doc, [&](UpstreamConnection::Body& body) {
+      // The reply is parsed as it arrives; waiting for it is not parsing
+      PROFILE_ZONE("api.json_parse");
+      unsigned long start = micros();
+      uint32_t waitBefore = upstream.lastTimings().waitUs;
+      error = deserializeJson(resDoc, body, DeserializationOption::Filter(filter));
+      parseUs = micros() - start - (upstream.lastTimings().waitUs - waitBefore);
+    });
+    if (status == 0) {
+      return "Error: Connection failed";
     }
-    
-    String jsonBody = response.substring(jsonStart);
-    
-    JsonDocument resDoc;
-    DeserializationError error = deserializeJson(resDoc, jsonBody);
+    times.jsonParse.record(parseUs);
     
     if (error) {
       return "Error: JSON parsing failed - " + String(error.c_str());
     }
     
-    // Extract the response text
     if (resDoc["error"].is<JsonObject>()) {
       return "Error: " + String(resDoc["error"]["message"].as<const char*>());
     }
     
-    String result = resDoc["choices"][0]["message"]["content"] | "No response";
-    result.trim();
-    
-    return result;
+    return "";
+  }
+};
+
+// Query embeddings from the OpenAI embeddings API, for semantic knowledge
+// base search against entries embedded by tools/kb_embed.py --provider openai
+class OpenAIEmbeddingProvider : public EmbeddingProvider {
+private:
+  OpenAIClient& client;
+
+public:
+  OpenAIEmbeddingProvider(OpenAIClient& aiClient) : client(aiClient) {}
+
+  bool embed(const char* text, size_t length, float* out, size_t dim) override {
+    return client.getEmbedding(text, length, out, dim);
   }
 };
 
@@ -0,0 +1,596 @@
+#ifndef PERSISTENT_CACHE_H
+#define PERSISTENT_CACHE_H
+
+#include <algorithm>
+#include <vector>
+#include "knowledge_image.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_partition.h>
+#else
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#endif
+
+#define PCACHE_PARTITION_LABEL "cache"
+#define PCACHE_SECTOR_SIZE 4096
+#define PCACHE_REGION_MAGIC 0x32435043   // "CPC2", compressed values
+#define PCACHE_RECORD_MAGIC 0x52435043   // "CPCR"
+#define PCACHE_ERASED 0xFFFFFFFFu
+#define PCACHE_NONE 0xFFFFFFFFu
+
+// Lifetime of a cached response, in seconds the device has been powered
+#ifndef PCACHE_DEFAULT_TTL
+#define PCACHE_DEFAULT_TTL (7 * 24 * 3600)
+#endif
+// Flash bytes that may be written per hour of uptime, appends and
+// compaction together; writes beyond it are skipped or deferred
+#ifndef PCACHE_WRITE_BUDGET
+#define PCACHE_WRITE_BUDGET (64 * 1024)
+#endif
+// Start compacting once the active region is this full
+#ifndef PCACHE_COMPACT_PERCENT
+#define PCACHE_COMPACT_PERCENT 75
+#endif
+// Record bytes copied per compaction step
+#ifndef PCACHE_COMPACT_STEP_BYTES
+#define PCACHE_COMPACT_STEP_BYTES 4096
+#endif
+#ifndef PCACHE_MAX_VALUE
+#define PCACHE_MAX_VALUE 8192
+#endif
+// Host builds back the cache with a file of this size
+#ifndef PCACHE_HOST_SIZE
+#define PCACHE_HOST_SIZE 0x70000
+#endif
+
+#ifdef ARDUINO
+
+// Raw access to the "cache" data partition
+class PersistentCacheStorage {
+private:
+  const esp_partition_t* partition = nullptr;
+
+public:
+  bool begin(const char* label = PCACHE_PARTITION_LABEL) {
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    return partition != nullptr;
+  }
+
+  size_t size() const { return partition ? partition->size : 0; }
+
+  bool read(uint32_t offset, void* data, size_t length) {
+    return esp_partition_read(partition, offset, data, length) == ESP_OK;
+  }
+
+  bool write(uint32_t offset, const void* data, size_t length) {
+    return esp_partition_write(partition, offset, data, length) == ESP_OK;
+  }
+
+  bool erase(uint32_t offset, size_t length) {
+    return esp_partition_erase_range(partition, offset, length) == ESP_OK;
+  }
+};
+
+#else
+
+// Host build: a fixed-size file standing in for the partition, erased to
+// 0xFF like flash
+class PersistentCacheStorage {
+private:
+  FILE* file = nullptr;
+  size_t bytes = 0;
+
+public:
+  ~PersistentCacheStorage() {
+    if (file != nullptr) fclose(file);
+  }
+
+  bool begin(const char* path, size_t size = PCACHE_HOST_SIZE) {
+    if (file != nullptr) fclose(file);
+    file = fopen(path, "r+b");
+    if (file == nullptr) file = fopen(path, "w+b");
+    if (file == nullptr) return false;
+
+    fseek(file, 0, SEEK_END);
+    size_t existing = ftell(file);
+    bytes = size;
+    return existing >= size || erase(existing, size - existing);
+  }
+
+  size_t size() const { return bytes; }
+
+  bool read(uint32_t offset, void* data, size_t length) {
+    return fseek(file, offset, SEEK_SET) == 0 && fread(data, 1, length, file) == length;
+  }
+
+  bool write(uint32_t offset, const void* data, size_t length) {
+    return fseek(file, offset, SEEK_SET) == 0 && fwrite(data, 1, length, file) == length && fflush(file) == 0;
+  }
+
+  bool erase(uint32_t offset, size_t length) {
+    uint8_t erased[256];
+    memset(erased, 0xFF, sizeof(erased));
+    if (fseek(file, offset, SEEK_SET) != 0) return false;
+    for (size_t done = 0; done < length; done += sizeof(erased)) {
+      size_t chunk = std::min(sizeof(erased), length - done);
+      if (fwrite(erased, 1, chunk, file) != chunk) return false;
+    }
+    return fflush(file) == 0;
+  }
+};
+
+#endif
+
+// Start of each region; the region with the highest valid generation is
+// the active log
+struct PersistentCacheRegionHeader {
+  uint32_t magic;
+  uint32_t generation;
+  uint32_t reserved;
+  uint32_t crc;  // over the header with crc = 0
+};
+
+// Log record, followed by the value padded to 4 bytes
+struct PersistentCacheRecord {
+  uint32_t magic;
+  uint32_t length;   // value bytes
+  uint64_t key;
+  uint32_t created;  // cache clock seconds
+  uint32_t expires;
+  uint32_t crc;      // over the header with crc = 0, then the value
+  uint32_t reserved;
+};
+
+struct PersistentCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t expired;
+  uint32_t appends;
+  uint32_t budgetSkips;  // appends dropped by the write budget
+  uint32_t bytesWritten;
+  uint32_t sectorsErased;
+  uint32_t compactions;
+  uint32_t records;      // live records in the index
+};
+
+// Append-only response cache on flash, used as a second tier behind the
+// RAM cache. The partition holds two log regions: records are appended to
+// the active one and compaction copies live, unexpired records into the
+// other before switching. The RAM index (key -> record offset) is rebuilt
+// by scanning the log at boot. Compaction runs in small steps from tick()
+// so it never stalls the caller for long. Time is a cache clock that
+// continues from the newest record after a reboot, so TTLs count time the
+// device was powered
+class PersistentCache {
+private:
+  struct IndexSlot {
+    uint64_t key;
+    uint32_t offset;   // PCACHE_NONE when empty
+    uint32_t expires;
+  };
+
+  enum CompactState {
+    COMPACT_IDLE,
+    COMPACT_ERASE,
+    COMPACT_COPY
+  };
+
+  PersistentCacheStorage storage;
+  std::vector<IndexSlot> index;
+  uint32_t regionSize = 0;
+  uint32_t activeRegion = 0;
+  uint32_t generation = 0;
+  uint32_t tail = 0;          // append offset in the active region
+  bool damaged = false;       // torn record found; compact before appending
+  bool ready = false;
+
+  CompactState state = COMPACT_IDLE;
+  uint32_t eraseOffset = 0;
+  uint32_t copyOffset = 0;    // next record to copy from the active region
+  uint32_t copyEnd = 0;
+  uint32_t targetTail = 0;    // append offset in the region being filled
+
+  uint32_t clockBase = 0;
+  uint64_t clockMillis = 0;   // uptime, carried past the 49-day wrap of millis()
+  uint32_t clockRead = 0;     // uptimeMillis() when clockMillis was last advanced
+  float writeTokens = PCACHE_WRITE_BUDGET;
+  uint32_t lastRefill = 0;
+  PersistentCacheStats counters = {};
+
+public:
+  // Open the partition (or, on host builds, the file) and rebuild the
+  // index from the active log, formatting the storage if it holds none
+#ifdef ARDUINO
+  bool begin(const char* label = PCACHE_PARTITION_LABEL) {
+    if (!storage.begin(label)) return false;
+#else
+  bool begin(const char* path, size_t size = PCACHE_HOST_SIZE) {
+    if (!storage.begin(path, size)) return false;
+#endif
+    ready = false;
+    regionSize = (storage.size() / 2) & ~(uint32_t)(PCACHE_SECTOR_SIZE - 1);
+    if (regionSize < 2 * PCACHE_SECTOR_SIZE) return false;
+
+    PersistentCacheRegionHeader headers[2];
+    bool valid[2];
+    for (uint32_t r = 0; r < 2; r++) {
+      valid[r] = readRegionHeader(r, headers[r]);
+    }
+
+    if (!valid[0] && !valid[1]) {
+      if (!storage.erase(regionStart(0), regionSize) || !writeRegionHeader(0, 1)) return false;
+      counters.sectorsErased += regionSize / PCACHE_SECTOR_SIZE;
+      headers[0].generation = 1;
+      valid[0] = true;
+    }
+
+    activeRegion = !valid[1] || (valid[0] && headers[0].generation > headers[1].generation) ? 0 : 1;
+    generation = headers[activeRegion].generation;
+    state = COMPACT_IDLE;
+    lastRefill = uptimeMillis();
+    ready = true;
+    return scan();
+  }
+
+  bool isReady() const { return ready; }
+
+  // Copy the unexpired value for key into out
+  bool get(uint64_t key, std::vector<uint8_t>& out) {
+    IndexSlot* slot = ready ? findSlot(key) : nullptr;
+    if (slot == nullptr || slot->offset == PCACHE_NONE) {
+      counters.misses++;
+      return false;
+    }
+    if (expired(slot->expires)) {
+      eraseSlot(slot);
+      counters.expired++;
+      counters.misses++;
+      return false;
+    }
+
+    PersistentCacheRecord record;
+    if (!storage.read(slot->offset, &record, sizeof(record)) || record.key != key) {
+      counters.misses++;
+      return false;
+    }
+
+    out.resize(record.length);
+    if (!storage.read(slot->offset + sizeof(record), out.data(), record.length)) {
+      counters.misses++;
+      return false;
+    }
+    counters.hits++;
+    return true;
+  }
+
+  // Append a value for key. Skipped when the write budget is spent or the
+  // log is full until compaction frees space
+  bool put(uint64_t key, const uint8_t* value, size_t length, uint32_t ttl = PCACHE_DEFAULT_TTL) {
+    if (!ready || length > PCACHE_MAX_VALUE) return false;
+
+    // Appends land in the region being filled once compaction is copying
+    uint32_t size = recordSize(length);
+    uint32_t region = state == COMPACT_COPY ? 1 - activeRegion : activeRegion;
+    uint32_t& offset = state == COMPACT_COPY ? targetTail : tail;
+    if (damaged && state != COMPACT_COPY) return false;
+    if (offset + size > regionStart(region) + regionSize) return false;
+
+    if (!spend(size)) {
+      counters.budgetSkips++;
+      return false;
+    }
+
+    PersistentCacheRecord record = {};
+    record.magic = PCACHE_RECORD_MAGIC;
+    record.length = length;
+    record.key = key;
+    record.created = now();
+    record.expires = record.created + ttl;
+    record.crc = recordCrc(record, value);
+
+    if (!writeRecord(offset, record, value)) {
+      damaged = true;
+      return false;
+    }
+
+    setSlot(key, offset, record.expires);
+    offset += size;
+    counters.appends++;
+    return true;
+  }
+
+  // Do one bounded step of background work: start compaction when the
+  // active region is full enough, erase one sector or copy a batch of
+  // live records
+  void tick() {
+    if (!ready) return;
+    now();  // keeps the clock across millis() wrapping
+
+    if (state == COMPACT_IDLE) {
+      uint32_t used = tail - regionStart(activeRegion);
+      if (damaged || used * 100 >= regionSize * PCACHE_COMPACT_PERCENT) {
+        state = COMPACT_ERASE;
+        eraseOffset = regionStart(1 - activeRegion);
+      }
+      return;
+    }
+
+    if (state == COMPACT_ERASE) {
+      if (!storage.erase(eraseOffset, PCACHE_SECTOR_SIZE)) return;
+      counters.sectorsErased++;
+      eraseOffset += PCACHE_SECTOR_SIZE;
+      if (eraseOffset >= regionStart(1 - activeRegion) + regionSize) {
+        state = COMPACT_COPY;
+        copyOffset = regionStart(activeRegion) + sizeof(PersistentCacheRegionHeader);
+        copyEnd = tail;
+        targetTail = regionStart(1 - activeRegion) + sizeof(PersistentCacheRegionHeader);
+      }
+      return;
+    }
+
+    uint32_t copied = 0;
+    while (copyOffset < copyEnd && copied < PCACHE_COMPACT_STEP_BYTES) {
+      PersistentCacheRecord record;
+      if (!storage.read(copyOffset, &record, sizeof(record))) return;
+
+      uint32_t size = recordSize(record.length);
+      IndexSlot* slot = findSlot(record.key);
+      bool live = slot != nullptr && slot->offset == copyOffset;
+      if (live && (expired(slot->expires) || targetTail + size > regionStart(1 - activeRegion) + regionSize)) {
+        // Expired, or no room left next to newer appends
+        eraseSlot(slot);
+        counters.expired++;
+      } else if (live) {
+        if (!spend(size)) return;  // resume when the budget refills
+        if (!copyRecord(copyOffset, targetTail, size)) {
+          abortCompaction();
+          return;
+        }
+        slot->offset = targetTail;
+        targetTail += size;
+        copied += size;
+      }
+      copyOffset += size;
+    }
+
+    if (copyOffset >= copyEnd) finishCompaction();
+  }
+
+  const PersistentCacheStats& stats() const { return counters; }
+
+  // Live bytes in the active log
+  uint32_t used() const {
+    return ready ? tail - regionStart(activeRegion) : 0;
+  }
+
+private:
+  uint32_t regionStart(uint32_t region) const { return region * regionSize; }
+
+  static uint32_t recordSize(size_t length) {
+    return sizeof(PersistentCacheRecord) + ((length + 3) & ~(size_t)3);
+  }
+
+#ifdef ARDUINO
+  static uint32_t uptimeMillis() { return millis(); }
+#else
+  static uint32_t uptimeMillis() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+#endif
+
+  // Seconds of uptime. The millisecond counter wraps after 49 days, so
+  // only differences between readings are added up; called at least
+  // that often through tick()
+  uint32_t uptimeSeconds() {
+    uint32_t current = uptimeMillis();
+    clockMillis += (uint32_t)(current - clockRead);
+    clockRead = current;
+    return (uint32_t)(clockMillis / 1000);
+  }
+
+  uint32_t now() {
+    return clockBase + uptimeSeconds();
+  }
+
+  // Expiry times are compared by difference, so the comparison holds
+  // even if the cache clock wraps
+  bool expired(uint32_t expires) {
+    return (int32_t)(expires - now()) <= 0;
+  }
+
+  // Token bucket over flash writes
+  bool spend(uint32_t bytes) {
+    uint32_t current = uptimeMillis();
+    writeTokens = std::min((float)PCACHE_WRITE_BUDGET,
+                           writeTokens + (uint32_t)(current - lastRefill) * (PCACHE_WRITE_BUDGET / 3600000.0f));
+    lastRefill = current;
+    if (writeTokens < bytes) return false;
+    writeTokens -= bytes;
+    return true;
+  }
+
+  bool readRegionHeader(uint32_t region, PersistentCacheRegionHeader& header) {
+    if (!storage.read(regionStart(region), &header, sizeof(header))) return false;
+    uint32_t crc = header.crc;
+    header.crc = 0;
+    return header.magic == PCACHE_REGION_MAGIC && kbCrc32((const uint8_t*)&header, sizeof(header)) == crc;
+  }
+
+  bool writeRegionHeader(uint32_t region, uint32_t regionGeneration) {
+    PersistentCacheRegionHeader header = {PCACHE_REGION_MAGIC, regionGeneration, 0, 0};
+    header.crc = kbCrc32((const uint8_t*)&header, sizeof(header));
+    counters.bytesWritten += sizeof(header);
+    return storage.write(regionStart(region), &header, sizeof(header));
+  }
+
+  static uint32_t recordCrc(PersistentCacheRecord record, const uint8_t* value) {
+    record.crc = 0;
+    uint32_t crc = kbCrc32((const uint8_t*)&record, sizeof(record));
+    return kbCrc32(value, record.length, crc);
+  }
+
+  bool writeRecord(uint32_t offset, const PersistentCacheRecord& record, const uint8_t* value) {
+    static const uint8_t padding[4] = {0, 0, 0, 0};
+    uint32_t aligned = record.length & ~3u;
+    uint32_t rest = record.length - aligned;
+
+    bool ok = storage.write(offset + sizeof(record), value, aligned);
+    if (ok && rest > 0) {
+      uint8_t last[4];
+      memcpy(last, value + aligned, rest);
+      memcpy(last + rest, padding, 4 - rest);
+      ok = storage.write(offset + sizeof(record) + aligned, last, 4);
+    }
+    // The header goes last, so a torn write never looks like a record
+    ok = ok && storage.write(offset, &record, sizeof(record));
+    counters.bytesWritten += recordSize(record.length);
+    return ok;
+  }
+
+  bool copyRecord(uint32_t from, uint32_t to, uint32_t size) {
+    uint8_t chunk[256];
+    // Value first and header last, as in writeRecord()
+    for (uint32_t done = sizeof(PersistentCacheRecord); done < size; done += sizeof(chunk)) {
+      uint32_t length = std::min((uint32_t)sizeof(chunk), size - done);
+      if (!storage.read(from + done, chunk, length) || !storage.write(to + done, chunk, length)) return false;
+    }
+    if (!storage.read(from, chunk, sizeof(PersistentCacheRecord)) ||
+        !storage.write(to, chunk, sizeof(PersistentCacheRecord))) {
+      return false;
+    }
+    counters.bytesWritten += size;
+    return true;
+  }
+
+  // Rebuild the index from the active log, verifying every record
+  bool scan() {
+    index.assign(64, IndexSlot{0, PCACHE_NONE, 0});
+    counters.records = 0;
+    damaged = false;
+    uint32_t uptime = uptimeSeconds();
+
+    uint32_t end = regionStart(activeRegion) + regionSize;
+    uint32_t offset = regionStart(activeRegion) + sizeof(PersistentCacheRegionHeader);
+    std::vector<uint8_t> value;
+    while (offset + sizeof(PersistentCacheRecord) <= end) {
+      PersistentCacheRecord record;
+      if (!storage.read(offset, &record, sizeof(record))) return false;
+      if (record.magic == PCACHE_ERASED) {
+        // A write torn before its header leaves value bytes past the
+        // tail, which the next append can't be written over
+        if (!erasedUntil(offset, std::min(end, offset + recordSize(PCACHE_MAX_VALUE)))) damaged = true;
+        break;
+      }
+
+      if (record.magic != PCACHE_RECORD_MAGIC || record.length > PCACHE_MAX_VALUE ||
+          offset + recordSize(record.length) > end) {
+        damaged = true;
+        break;
+      }
+
+      value.resize(record.length);
+      if (!storage.read(offset + sizeof(record), value.data(), record.length)) return false;
+      if (recordCrc(record, value.data()) != record.crc) {
+        damaged = true;
+        break;
+      }
+
+      setSlot(record.key, offset, record.expires);
+      // The clock resumes after the newest record and never runs back
+      if (record.created + 1 > uptime) clockBase = std::max(clockBase, record.created + 1 - uptime);
+      offset += recordSize(record.length);
+    }
+
+    tail = offset;
+    return true;
+  }
+
+  bool erasedUntil(uint32_t offset, uint32_t end) {
+    uint32_t chunk[64];
+    while (offset < end) {
+      uint32_t length = std::min((uint32_t)sizeof(chunk), end - offset);
+      if (!storage.read(offset, chunk, length)) return false;
+      for (uint32_t i = 0; i < length / 4; i++) {
+        if (chunk[i] != PCACHE_ERASED) return false;
+      }
+      offset += length;
+    }
+    return true;
+  }
+
+  void finishCompaction() {
+    if (!writeRegionHeader(1 - activeRegion, generation + 1)) {
+      abortCompaction();
+      return;
+    }
+    generation++;
+    activeRegion = 1 - activeRegion;
+    tail = targetTail;
+    damaged = false;
+    state = COMPACT_IDLE;
+    counters.compactions++;
+  }
+
+  // The active log was left intact; rebuild the index from it, dropping
+  // anything already moved to the other region
+  void abortCompaction() {
+    state = COMPACT_IDLE;
+    scan();
+  }
+
+  // Open-addressing index with linear probing, kept at most half full
+  IndexSlot* findSlot(uint64_t key) {
+    size_t mask = index.size() - 1;
+    for (size_t i = (size_t)(key ^ (key >> 32)) & mask;; i = (i + 1) & mask) {
+      if (index[i].offset == PCACHE_NONE) return nullptr;
+      if (index[i].key == key) return &index[i];
+    }
+  }
+
+  void setSlot(uint64_t key, uint32_t offset, uint32_t expires) {
+    IndexSlot* existing = findSlot(key);
+    if (existing != nullptr) {
+      existing->offset = offset;
+      existing->expires = expires;
+      return;
+    }
+
+    if ((counters.records + 1) * 2 > index.size()) grow();
+    size_t mask = index.size() - 1;
+    size_t i = (size_t)(key ^ (key >> 32)) & mask;
+    while (index[i].offset != PCACHE_NONE) i = (i + 1) & mask;
+    index[i] = IndexSlot{key, offset, expires};
+    counters.records++;
+  }
+
+  // Backward-shift deletion keeps probe chains unbroken without tombstones
+  void eraseSlot(IndexSlot* slot) {
+    size_t mask = index.size() - 1;
+    size_t hole = slot - index.data();
+    for (size_t i = (hole + 1) & mask; index[i].offset != PCACHE_NONE; i = (i + 1) & mask) {
+      size_t home = (size_t)(index[i].key ^ (index[i].key >> 32)) & mask;
+      if (((i - home) & mask) >= ((i - hole) & mask)) {
+        index[hole] = index[i];
+        hole = i;
+      }
+    }
+    index[hole].offset = PCACHE_NONE;
+    counters.records--;
+  }
+
+  void grow() {
+    std::vector<IndexSlot> old;
+    old.swap(index);
+    index.assign(old.size() * 2, IndexSlot{0, PCACHE_NONE, 0});
+    counters.records = 0;
+    for (size_t i = 0; i < old.size(); i++) {
+      if (old[i].offset != PCACHE_NONE) setSlot(old[i].key, old[i].offset, old[i].expires);
+    }
+  }
+};
+
+#endif
\ No newline at end of file
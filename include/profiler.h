@@ -0,0 +1,180 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Scoped profiling zones for following single requests end to end.
+// PROFILE_ZONE("name") records when the enclosing scope began and ended;
+// GET /trace returns the recent zones as Chrome trace-event JSON, to
+// open in chrome://tracing or ui.perfetto.dev as a flame chart. Built
+// without PROFILE_ENABLED, the macros expand to nothing and no buffers
+// are allocated
+
+// Build with -DPROFILE_ENABLED=1 to record zones
+#ifndef PROFILE_ENABLED
+#define PROFILE_ENABLED 0
+#endif
+
+#if PROFILE_ENABLED
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <string>
+
+#ifdef ESP_PLATFORM
+#include <Arduino.h>
+#define PROFILE_CORES 2
+#else
+#include <chrono>
+#define PROFILE_CORES 1
+#endif
+
+// Zones kept per core; older ones are overwritten
+#ifndef PROFILE_EVENTS
+#define PROFILE_EVENTS 128
+#endif
+
+// One finished zone, timed in microseconds since boot and in CPU cycles.
+// Cycles are exact but count separately on each core and wrap every 18 s
+// at 240 MHz, so they are only used for zones that ended on the core they
+// started on, well within one wrap; the rest fall back to microseconds
+struct ProfileEvent {
+  std::atomic<uint32_t> sequence;  // 0 while being written
+  const char* name;
+  uint32_t startMicros;
+  uint32_t endMicros;
+  uint32_t startCycles;
+  uint32_t endCycles;
+  bool inCycles;  // whether endCycles - startCycles is the duration
+};
+
+// A ring of recent zones for each core. Zones on a core only write to
+// its ring, claiming a slot with one atomic add; tasks that preempt each
+// other on the core each get their own slot. Readers copy a slot and
+// check its sequence number did not change, so /trace never waits for
+// the tasks it is tracing
+class Profiler {
+private:
+  struct Ring {
+    ProfileEvent events[PROFILE_EVENTS];
+    std::atomic<uint32_t> next;
+  };
+  Ring rings[PROFILE_CORES];
+
+public:
+  Profiler() {
+    for (Ring& ring : rings) {
+      for (ProfileEvent& event : ring.events) event.sequence.store(0, std::memory_order_relaxed);
+      ring.next.store(0, std::memory_order_relaxed);
+    }
+  }
+
+#ifdef ESP_PLATFORM
+  static uint32_t cycles() { return ESP.getCycleCount(); }
+  static uint32_t cyclesPerMicro() { return ESP.getCpuFreqMHz(); }
+  static uint32_t clockMicros() { return micros(); }
+  static uint32_t core() { return xPortGetCoreID(); }
+#else
+  // On the host the steady clock in nanoseconds stands in for cycles
+  static uint32_t cycles() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+  static uint32_t cyclesPerMicro() { return 1000; }
+  static uint32_t clockMicros() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+  static uint32_t core() { return 0; }
+#endif
+
+  // Longest zone, in microseconds, timed in cycles: half a counter wrap
+  static uint32_t cycleRangeMicros() { return UINT32_MAX / cyclesPerMicro() / 2; }
+
+  // name must outlive the trace, which string literals do
+  void record(const char* name, uint32_t startCore, uint32_t startMicros, uint32_t startCycles,
+              uint32_t endMicros, uint32_t endCycles) {
+    uint32_t endCore = core();
+    Ring& ring = rings[endCore];
+    uint32_t position = ring.next.fetch_add(1, std::memory_order_relaxed);
+    ProfileEvent& event = ring.events[position % PROFILE_EVENTS];
+    event.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name = name;
+    event.startMicros = startMicros;
+    event.endMicros = endMicros;
+    event.startCycles = startCycles;
+    event.endCycles = endCycles;
+    event.inCycles = startCore == endCore && endMicros - startMicros < cycleRangeMicros();
+    event.sequence.store(position + 1, std::memory_order_release);
+  }
+
+  // Append the recorded zones as a Chrome trace-event JSON object, one
+  // thread per core
+  void writeTrace(std::string& out) const {
+    char line[160];
+    double perMicro = cyclesPerMicro();
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (uint32_t core = 0; core < PROFILE_CORES; core++) {
+      snprintf(line, sizeof(line), "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"core %u\"}}",
+               first ? "" : ",", (unsigned)core, (unsigned)core);
+      out += line;
+      first = false;
+
+      const Ring& ring = rings[core];
+      for (const ProfileEvent& event : ring.events) {
+        uint32_t sequence = event.sequence.load(std::memory_order_acquire);
+        if (sequence == 0) continue;
+        const char* name = event.name;
+        uint32_t startMicros = event.startMicros;
+        double duration = event.inCycles ? (event.endCycles - event.startCycles) / perMicro
+                                         : (double)(event.endMicros - event.startMicros);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (event.sequence.load(std::memory_order_relaxed) != sequence) continue;  // rewritten while read
+
+        snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%u,\"dur\":%.3f}",
+                 name, (unsigned)core, (unsigned)startMicros, duration);
+        out += line;
+      }
+    }
+    out += "\n]}\n";
+  }
+
+  // Upper bound on the size of writeTrace() output, to reserve for it
+  static size_t traceSize() { return 64 + PROFILE_CORES * (96 + PROFILE_EVENTS * 112); }
+};
+
+inline Profiler profiler;
+
+// Records the scope it is declared in when it ends
+class ProfileZone {
+private:
+  const char* name;
+  uint32_t startCore;
+  uint32_t startMicros;
+  uint32_t startCycles;
+
+public:
+  explicit ProfileZone(const char* zoneName)
+    : name(zoneName), startCore(Profiler::core()), startMicros(Profiler::clockMicros()),
+      startCycles(Profiler::cycles()) {}
+  ~ProfileZone() {
+    uint32_t endCycles = Profiler::cycles();
+    profiler.record(name, startCore, startMicros, startCycles, Profiler::clockMicros(), endCycles);
+  }
+
+  ProfileZone(const ProfileZone&) = delete;
+  ProfileZone& operator=(const ProfileZone&) = delete;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+
+#else
+
+#define PROFILE_ZONE(name) do {} while (0)
+
+#endif
+
+#endif
\ No newline at end of file
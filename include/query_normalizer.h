@@ -0,0 +1,199 @@
+#ifndef QUERY_NORMALIZER_H
+#define QUERY_NORMALIZER_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <ctype.h>
+#include <string.h>
+#endif
+#include "knowledge_store.h"
+
+// Longest normalized query kept; the rest is dropped
+#ifndef KB_MAX_QUERY_LENGTH
+#define KB_MAX_QUERY_LENGTH 256
+#endif
+
+constexpr size_t kbLength(const char* text) {
+  size_t length = 0;
+  while (text[length] != '\0') length++;
+  return length;
+}
+
+// Perfect hash over a fixed word list, built entirely by the compiler:
+// the first seed that sends every word to its own slot is kept. Slots hold
+// word index + 1, 0 when empty
+template <size_t Size>
+struct PerfectHashTable {
+  uint32_t seed;
+  uint8_t slots[Size];
+};
+
+template <size_t Size, size_t Count>
+constexpr PerfectHashTable<Size> kbBuildPerfectHash(const char* const (&words)[Count]) {
+  static_assert(Count < 255, "word list too long for 8-bit slots");
+  static_assert((Size & (Size - 1)) == 0, "table size must be a power of two");
+
+  PerfectHashTable<Size> table = {};
+  for (uint32_t seed = 1; seed < 100000; seed++) {
+    for (size_t s = 0; s < Size; s++) table.slots[s] = 0;
+
+    bool collision = false;
+    for (size_t i = 0; i < Count && !collision; i++) {
+      size_t slot = kbHashToken(words[i], kbLength(words[i]), seed) & (Size - 1);
+      collision = table.slots[slot] != 0;
+      table.slots[slot] = i + 1;
+    }
+    if (!collision) {
+      table.seed = seed;
+      return table;
+    }
+  }
+  table.seed = 0;
+  return table;
+}
+
+// Index of word in the list, or -1, with a single probe
+template <size_t Size, size_t Count>
+int kbPerfectHashFind(const PerfectHashTable<Size>& table, const char* const (&words)[Count],
+                      const char* word, size_t length) {
+  uint8_t entry = table.slots[kbHashToken(word, length, table.seed) & (Size - 1)];
+  if (entry == 0) return -1;
+
+  const char* candidate = words[entry - 1];
+  if (strncmp(candidate, word, length) != 0 || candidate[length] != '\0') return -1;
+  return entry - 1;
+}
+
+// Words that carry no retrieval signal
+constexpr const char* kbStopwords[] = {
+  "a", "about", "an", "and", "are", "as", "at", "be", "by", "can", "could",
+  "do", "does", "for", "from", "give", "has", "have", "hello",
+  "hi", "how", "i", "in", "is", "it", "its", "me", "my", "of", "on", "or",
+  "please", "s", "should", "t", "tell", "that", "the", "this", "to", "was",
+  "what", "whats", "when", "where", "which", "who", "why", "will", "with",
+  "would", "you", "your"
+};
+
+// Filler dropped from questions before they are compared with each other.
+// Question words and negations are not filler there: "when" and "where",
+// or "does" and "does not", ask different things
+constexpr const char* kbSignatureStopwords[] = {
+  "a", "am", "an", "are", "be", "did", "do", "does", "hello", "hey", "hi",
+  "i", "is", "me", "please", "s", "tell", "the", "was", "were", "you"
+};
+
+// Abbreviations rewritten to the word they stand for. Only spellings of
+// the same term belong here: the corpus is searched by prefix and stems
+// are handled by kbStemLength(), so neither needs an entry
+constexpr const char* kbSynonymWords[] = {
+  "bt", "cpp", "js", "py"
+};
+constexpr const char* kbSynonymTargets[] = {
+  "bluetooth", "c++", "javascript", "python"
+};
+static_assert(sizeof(kbSynonymWords) == sizeof(kbSynonymTargets), "synonym lists must pair up");
+
+constexpr PerfectHashTable<512> kbStopwordTable = kbBuildPerfectHash<512>(kbStopwords);
+constexpr PerfectHashTable<32> kbSynonymTable = kbBuildPerfectHash<32>(kbSynonymWords);
+constexpr PerfectHashTable<128> kbSignatureStopwordTable = kbBuildPerfectHash<128>(kbSignatureStopwords);
+static_assert(kbStopwordTable.seed != 0, "no perfect hash seed for stopwords");
+static_assert(kbSynonymTable.seed != 0, "no perfect hash seed for synonyms");
+static_assert(kbSignatureStopwordTable.seed != 0, "no perfect hash seed for signature stopwords");
+
+// Length of word without its inflection: plural "s"/"es"/"ies", then
+// "ing" or "ed". Keywords are matched by prefix, so the stem only needs to
+// be cut, not respelled: "libraries" keeps "librar", "processes" keeps
+// "process", "created" keeps "creat". Short words are left whole
+inline size_t kbStemLength(const char* word, size_t length) {
+  auto endsWith = [&](const char* suffix, size_t suffixLength) {
+    return length >= suffixLength && memcmp(word + length - suffixLength, suffix, suffixLength) == 0;
+  };
+
+  if (endsWith("ies", 3) && length >= 7) {
+    length -= 3;
+  } else if ((endsWith("ses", 3) && length >= 6) ||
+             ((endsWith("xes", 3) || endsWith("zes", 3) || endsWith("ches", 4) || endsWith("shes", 4)) &&
+              length >= 5)) {
+    length -= 2;
+  } else if (endsWith("s", 1) && !endsWith("ss", 2) && !endsWith("us", 2) && !endsWith("is", 2) && length >= 4) {
+    length -= 1;
+  }
+  if (endsWith("ing", 3) && length >= 7) {
+    length -= 3;
+  } else if (endsWith("ed", 2) && length >= 6) {
+    length -= 2;
+  }
+  return length;
+}
+
+// Query normalization in front of the knowledge base: lowercase, drop
+// punctuation, remove stopwords, expand abbreviations and strip
+// inflections. Works in a caller-provided buffer and never allocates
+class QueryNormalizer {
+public:
+  // Write the normalized, space-separated words of query into out and
+  // return their length. out must hold outSize bytes including the NUL
+  static size_t normalize(const char* query, size_t length, char* out, size_t outSize) {
+    return normalizeWords(query, length, out, outSize, true);
+  }
+
+  // Like normalize(), but for telling questions apart rather than finding
+  // passages: only kbSignatureStopwords are dropped and no word is
+  // rewritten, so question words and negations are kept
+  static size_t normalizeQuestion(const char* query, size_t length, char* out, size_t outSize) {
+    return normalizeWords(query, length, out, outSize, false);
+  }
+
+  static bool isStopword(const char* word, size_t length) {
+    return kbPerfectHashFind(kbStopwordTable, kbStopwords, word, length) >= 0;
+  }
+
+  static bool isSignatureStopword(const char* word, size_t length) {
+    return kbPerfectHashFind(kbSignatureStopwordTable, kbSignatureStopwords, word, length) >= 0;
+  }
+
+  // Full form of an abbreviation, or nullptr
+  static const char* canonical(const char* word, size_t length) {
+    int index = kbPerfectHashFind(kbSynonymTable, kbSynonymWords, word, length);
+    return index >= 0 ? kbSynonymTargets[index] : nullptr;
+  }
+
+private:
+  static size_t normalizeWords(const char* query, size_t length, char* out, size_t outSize, bool retrieval) {
+    if (outSize == 0) return 0;
+
+    // Split exactly like keywords are, so every word can meet a token
+    size_t written = 0;
+    kbForEachWord(query, length, [&](const char* word, size_t wordLength) {
+      written = appendWord(word, wordLength, out, written, outSize, retrieval);
+    });
+
+    out[written] = '\0';
+    return written;
+  }
+
+  static size_t appendWord(const char* word, size_t length, char* out, size_t written, size_t outSize,
+                           bool retrieval) {
+    if (retrieval ? isStopword(word, length) : isSignatureStopword(word, length)) return written;
+
+    if (retrieval) {
+      const char* mapped = canonical(word, length);
+      if (mapped != nullptr) {
+        word = mapped;
+        length = kbLength(mapped);
+      } else {
+        length = kbStemLength(word, length);
+      }
+    }
+
+    size_t separator = written > 0 ? 1 : 0;
+    if (written + separator + length >= outSize) return written;
+
+    if (separator) out[written++] = ' ';
+    memcpy(out + written, word, length);
+    return written + length;
+  }
+};
+
+#endif
\ No newline at end of file
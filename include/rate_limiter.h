@@ -0,0 +1,75 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+#include <algorithm>
+
+// Clients tracked at once; beyond that the one seen longest ago makes way
+#ifndef RATE_LIMIT_CLIENTS
+#define RATE_LIMIT_CLIENTS 16
+#endif
+
+// Token bucket per client address. Each request takes a token; tokens
+// come back at a steady rate up to a burst. Fixed size, so a flood of
+// addresses costs no heap: forgetting a client only ever hands it a full
+// bucket again
+class RateLimiter {
+private:
+  struct Bucket {
+    uint32_t client;
+    float tokens;
+    unsigned long updated;
+  };
+
+  Bucket buckets[RATE_LIMIT_CLIENTS] = {};
+  size_t used = 0;
+  float perMs;
+  float burst;
+  uint32_t refused = 0;
+
+public:
+  RateLimiter(float perMinute, float burstSize) : perMs(perMinute / 60000.0f), burst(burstSize) {}
+
+#ifdef ARDUINO
+  uint32_t take(uint32_t client) {
+    return take(client, millis());
+  }
+#endif
+
+  // Take a token for client at uptime now, in ms. Returns 0 if it had one,
+  // otherwise the ms until it will
+  uint32_t take(uint32_t client, unsigned long now) {
+    Bucket& bucket = find(client, now);
+    bucket.tokens = std::min(burst, bucket.tokens + (now - bucket.updated) * perMs);
+    bucket.updated = now;
+    if (bucket.tokens >= 1.0f) {
+      bucket.tokens -= 1.0f;
+      return 0;
+    }
+    refused++;
+    return (uint32_t)((1.0f - bucket.tokens) / perMs) + 1;
+  }
+
+  uint32_t refusedCount() const { return refused; }
+
+private:
+  Bucket& find(uint32_t client, unsigned long now) {
+    Bucket* oldest = nullptr;
+    for (size_t i = 0; i < used; i++) {
+      if (buckets[i].client == client) return buckets[i];
+      if (oldest == nullptr || now - buckets[i].updated > now - oldest->updated) oldest = &buckets[i];
+    }
+    Bucket* bucket = used < RATE_LIMIT_CLIENTS ? &buckets[used++] : oldest;
+    bucket->client = client;
+    bucket->tokens = burst;
+    bucket->updated = now;
+    return *bucket;
+  }
+};
+
+#endif
\ No newline at end of file
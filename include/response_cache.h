@@ -0,0 +1,217 @@
+#ifndef RESPONSE_CACHE_H
+#define RESPONSE_CACHE_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <string.h>
+#endif
+#include <vector>
+
+// Heap budget for cached responses, counting each entry's bookkeeping
+#ifndef RESPONSE_CACHE_BYTES
+#define RESPONSE_CACHE_BYTES 32768
+#endif
+#ifndef RESPONSE_CACHE_MAX_ENTRIES
+#define RESPONSE_CACHE_MAX_ENTRIES 1024
+#endif
+
+#define RESPONSE_CACHE_NONE 0xFFFFFFFFu
+
+// 64-bit FNV-1a digest; chain calls by passing the previous digest
+inline uint64_t responseDigest(const char* text, size_t length, uint64_t hash = 14695981039346656037ull) {
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ (uint8_t)text[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+
+struct ResponseCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t inserts;
+  uint32_t evictions;
+  uint32_t entries;
+  uint32_t bytes;
+};
+
+// LRU cache of responses keyed by a 64-bit prompt digest, so prompts are
+// never stored. Values are opaque bytes (compressed by OpenAIClient).
+// Entries live in a node pool linked by index: hash chains give O(1)
+// lookup, and an intrusive recency list gives O(1) promotion and
+// eviction. Bounded by total bytes as well as entry count
+class ResponseCache {
+private:
+  struct Node {
+    uint64_t key;
+    uint8_t* value;
+    uint32_t length;
+    uint32_t prev;      // towards the most recently used end
+    uint32_t next;
+    uint32_t hashNext;
+  };
+
+  std::vector<Node> nodes;
+  std::vector<uint32_t> buckets;
+  uint32_t head = RESPONSE_CACHE_NONE;  // most recently used
+  uint32_t tail = RESPONSE_CACHE_NONE;  // least recently used
+  uint32_t freeList = RESPONSE_CACHE_NONE;
+  size_t byteBudget;
+  size_t maxEntries;
+  ResponseCacheStats counters = {};
+
+public:
+  ResponseCache(size_t budget = RESPONSE_CACHE_BYTES, size_t entryLimit = RESPONSE_CACHE_MAX_ENTRIES)
+    : byteBudget(budget), maxEntries(entryLimit) {}
+
+  ResponseCache(const ResponseCache&) = delete;
+  ResponseCache& operator=(const ResponseCache&) = delete;
+
+  ~ResponseCache() { clear(); }
+
+  // Copy the cached value for key into out and mark it recently used
+  bool get(uint64_t key, std::vector<uint8_t>& out) {
+    uint32_t index = find(key);
+    if (index == RESPONSE_CACHE_NONE) {
+      counters.misses++;
+      return false;
+    }
+
+    unlink(index);
+    pushFront(index);
+    out.assign(nodes[index].value, nodes[index].value + nodes[index].length);
+    counters.hits++;
+    return true;
+  }
+
+  // Insert or replace the value for key, evicting least recently used
+  // entries until it fits. Values larger than the budget are skipped
+  void put(uint64_t key, const uint8_t* value, size_t length) {
+    if (entryBytes(length) > byteBudget || maxEntries == 0) return;
+    if (buckets.empty()) allocate();
+
+    remove(key);
+    while (tail != RESPONSE_CACHE_NONE &&
+           (counters.bytes + entryBytes(length) > byteBudget || counters.entries >= maxEntries)) {
+      remove(nodes[tail].key);
+      counters.evictions++;
+    }
+
+    uint32_t index = freeList;
+    if (index != RESPONSE_CACHE_NONE) {
+      freeList = nodes[index].next;
+    } else {
+      index = nodes.size();
+      nodes.push_back(Node());
+    }
+
+    Node& node = nodes[index];
+    node.key = key;
+    node.length = length;
+    node.value = new uint8_t[length];
+    memcpy(node.value, value, length);
+
+    uint32_t& bucket = buckets[bucketOf(key)];
+    node.hashNext = bucket;
+    bucket = index;
+    pushFront(index);
+
+    counters.entries++;
+    counters.bytes += entryBytes(length);
+    counters.inserts++;
+  }
+
+  bool remove(uint64_t key) {
+    if (buckets.empty()) return false;
+
+    uint32_t* link = &buckets[bucketOf(key)];
+    while (*link != RESPONSE_CACHE_NONE && nodes[*link].key != key) {
+      link = &nodes[*link].hashNext;
+    }
+    if (*link == RESPONSE_CACHE_NONE) return false;
+
+    uint32_t index = *link;
+    Node& node = nodes[index];
+    *link = node.hashNext;
+    unlink(index);
+
+    counters.entries--;
+    counters.bytes -= entryBytes(node.length);
+    delete[] node.value;
+    node.value = nullptr;
+    node.next = freeList;
+    freeList = index;
+    return true;
+  }
+
+  void clear() {
+    for (size_t i = 0; i < nodes.size(); i++) {
+      delete[] nodes[i].value;
+    }
+    nodes.clear();
+    buckets.clear();
+    head = tail = freeList = RESPONSE_CACHE_NONE;
+    counters.entries = 0;
+    counters.bytes = 0;
+  }
+
+  const ResponseCacheStats& stats() const { return counters; }
+
+  // Bytes charged to each entry besides its value
+  static size_t entryOverhead() { return sizeof(Node); }
+
+  // Heap bytes held, including the index and pool
+  size_t memoryUsage() const {
+    size_t usage = nodes.capacity() * sizeof(Node) + buckets.capacity() * sizeof(uint32_t);
+    for (size_t i = 0; i < nodes.size(); i++) {
+      if (nodes[i].value != nullptr) usage += nodes[i].length;
+    }
+    return usage;
+  }
+
+private:
+  static size_t entryBytes(size_t length) {
+    return length + entryOverhead();
+  }
+
+  // Bucket table sized once to a power of two covering the entry limit
+  void allocate() {
+    size_t size = 16;
+    while (size < maxEntries) size *= 2;
+    buckets.assign(size, RESPONSE_CACHE_NONE);
+  }
+
+  size_t bucketOf(uint64_t key) const {
+    return (size_t)(key ^ (key >> 32)) & (buckets.size() - 1);
+  }
+
+  uint32_t find(uint64_t key) const {
+    if (buckets.empty()) return RESPONSE_CACHE_NONE;
+
+    uint32_t index = buckets[bucketOf(key)];
+    while (index != RESPONSE_CACHE_NONE && nodes[index].key != key) {
+      index = nodes[index].hashNext;
+    }
+    return index;
+  }
+
+  void unlink(uint32_t index) {
+    Node& node = nodes[index];
+    if (node.prev != RESPONSE_CACHE_NONE) nodes[node.prev].next = node.next;
+    else head = node.next;
+    if (node.next != RESPONSE_CACHE_NONE) nodes[node.next].prev = node.prev;
+    else tail = node.prev;
+  }
+
+  void pushFront(uint32_t index) {
+    Node& node = nodes[index];
+    node.prev = RESPONSE_CACHE_NONE;
+    node.next = head;
+    if (head != RESPONSE_CACHE_NONE) nodes[head].prev = index;
+    head = index;
+    if (tail == RESPONSE_CACHE_NONE) tail = index;
+  }
+};
+
+#endif
\ No newline at end of file
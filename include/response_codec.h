@@ -0,0 +1,747 @@
+#ifndef RESPONSE_CODEC_H
+#define RESPONSE_CODEC_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <string.h>
+#endif
+#include <algorithm>
+#include <new>
+#include <vector>
+#include "knowledge_image.h"
+
+// Back-reference window. The decoder keeps this much history, which bounds
+// the heap a cache hit needs; a power of two no larger than 32768
+#ifndef RESPONSE_CODEC_WINDOW
+#define RESPONSE_CODEC_WINDOW 4096
+#endif
+// Hash chain candidates tried per position when compressing
+#ifndef RESPONSE_CODEC_MAX_CHAIN
+#define RESPONSE_CODEC_MAX_CHAIN 32
+#endif
+// Tokens buffered per DEFLATE block; each block picks its own codes
+#ifndef RESPONSE_CODEC_BLOCK_TOKENS
+#define RESPONSE_CODEC_BLOCK_TOKENS 2048
+#endif
+// Longest response that is compressed and cached
+#ifndef RESPONSE_CODEC_MAX_LENGTH
+#define RESPONSE_CODEC_MAX_LENGTH 65535
+#endif
+
+#define RESPONSE_CODEC_HEADER 8        // CRC-32 and length of the original text
+#define RESPONSE_CODEC_HASH_BITS 10
+#define RESPONSE_CODEC_MIN_MATCH 3
+#define RESPONSE_CODEC_MAX_MATCH 258
+#define RESPONSE_GZIP_HEADER 10
+
+constexpr uint16_t codecLengthBase[29] = {
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+constexpr uint8_t codecLengthExtra[29] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+constexpr uint16_t codecDistanceBase[30] = {
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+constexpr uint8_t codecDistanceExtra[30] = {
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+constexpr uint8_t codecCodeLengthOrder[19] = {
+  16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+// Compressed form of cached responses: the CRC-32 and length of the text,
+// little-endian, followed by a raw DEFLATE stream (RFC 1951). Those eight
+// bytes are also the gzip trailer, so a blob goes to browsers that accept
+// gzip as header + stream + blob[0..8) without being decompressed. The
+// encoder keeps matches within a small window, so the decoder inflates
+// into the HTTP response through a RESPONSE_CODEC_WINDOW ring buffer
+// instead of the whole text
+class ResponseCodec {
+private:
+  // Literal (distance 0) or back-reference
+  struct Token {
+    uint16_t length;
+    uint16_t distance;
+  };
+
+  class BitWriter {
+  private:
+    std::vector<uint8_t>& out;
+    uint32_t buffer = 0;
+    uint8_t count = 0;
+
+  public:
+    BitWriter(std::vector<uint8_t>& target) : out(target) {}
+
+    void put(uint32_t value, uint8_t bits) {
+      buffer |= value << count;
+      count += bits;
+      while (count >= 8) {
+        out.push_back(buffer & 0xFF);
+        buffer >>= 8;
+        count -= 8;
+      }
+    }
+
+    void align() {
+      if (count > 0) out.push_back(buffer & 0xFF);
+      buffer = 0;
+      count = 0;
+    }
+  };
+
+  class BitReader {
+  private:
+    const uint8_t* data;
+    size_t size;
+    size_t offset = 0;
+    uint32_t buffer = 0;
+    uint8_t count = 0;
+
+  public:
+    bool overrun = false;
+
+    BitReader(const uint8_t* input, size_t length) : data(input), size(length) {}
+
+    uint32_t get(uint8_t bits) {
+      while (count < bits) {
+        if (offset >= size) {
+          overrun = true;
+          return 0;
+        }
+        buffer |= (uint32_t)data[offset++] << count;
+        count += 8;
+      }
+      uint32_t value = buffer & ((1u << bits) - 1);
+      buffer >>= bits;
+      count -= bits;
+      return value;
+    }
+
+    void align() {
+      buffer = 0;
+      count = 0;
+    }
+
+    // Whole bytes for stored blocks, after align()
+    const uint8_t* take(size_t length) {
+      if (length > size - offset) {
+        overrun = true;
+        return nullptr;
+      }
+      const uint8_t* bytes = data + offset;
+      offset += length;
+      return bytes;
+    }
+  };
+
+  // Canonical Huffman decoding table: codes per length and symbols in
+  // code order
+  struct Decoder {
+    uint16_t count[16];
+    uint16_t symbol[288];
+  };
+
+public:
+  // Compress text into blob, replacing its contents
+  static void encode(const char* text, size_t length, std::vector<uint8_t>& blob) {
+    const uint8_t* input = (const uint8_t*)text;
+    blob.clear();
+    blob.reserve(RESPONSE_CODEC_HEADER + length / 2 + 16);
+    putWord(blob, kbCrc32(input, length));
+    putWord(blob, length);
+
+    BitWriter bits(blob);
+    std::vector<uint16_t> head(1 << RESPONSE_CODEC_HASH_BITS, 0);
+    std::vector<uint16_t> chain(RESPONSE_CODEC_WINDOW, 0);
+    std::vector<Token> tokens;
+    tokens.reserve(std::min(length + 1, (size_t)RESPONSE_CODEC_BLOCK_TOKENS));
+
+    // Greedy matching with one step of lazy evaluation: a literal is
+    // emitted instead when the next position has a longer match
+    size_t blockStart = 0;
+    size_t pos = 0;
+    while (pos < length) {
+      Token match = longestMatch(input, length, pos, head, chain);
+      insert(input, length, pos, head, chain);
+      if (match.length >= RESPONSE_CODEC_MIN_MATCH && match.length < RESPONSE_CODEC_MAX_MATCH &&
+          longestMatch(input, length, pos + 1, head, chain).length > match.length) {
+        match.length = 0;
+      }
+
+      if (match.length >= RESPONSE_CODEC_MIN_MATCH) {
+        for (size_t i = 1; i < match.length; i++) insert(input, length, pos + i, head, chain);
+        tokens.push_back(match);
+        pos += match.length;
+      } else {
+        tokens.push_back({input[pos], 0});
+        pos++;
+      }
+
+      if (tokens.size() >= RESPONSE_CODEC_BLOCK_TOKENS && pos < length) {
+        writeBlock(bits, tokens, input + blockStart, pos - blockStart, false);
+        tokens.clear();
+        blockStart = pos;
+      }
+    }
+    writeBlock(bits, tokens, input + blockStart, pos - blockStart, true);
+    bits.align();
+  }
+
+  // A blob from encode(); anything else fails to decode
+  static bool valid(const uint8_t* blob, size_t size) {
+    return size > RESPONSE_CODEC_HEADER && rawLength(blob) <= RESPONSE_CODEC_MAX_LENGTH;
+  }
+
+  static uint32_t rawLength(const uint8_t* blob) { return getWord(blob + 4); }
+
+  // The DEFLATE stream, as sent between the gzip header and trailer
+  static const uint8_t* stream(const uint8_t* blob) { return blob + RESPONSE_CODEC_HEADER; }
+  static size_t streamSize(size_t size) { return size - RESPONSE_CODEC_HEADER; }
+
+  // The gzip trailer is the first RESPONSE_CODEC_HEADER bytes of the blob
+  static void gzipHeader(uint8_t header[RESPONSE_GZIP_HEADER]) {
+    static const uint8_t fields[RESPONSE_GZIP_HEADER] = {0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF};
+    memcpy(header, fields, RESPONSE_GZIP_HEADER);
+  }
+
+  // Inflate blob, passing the text to sink(const uint8_t*, size_t) a window
+  // at a time. Checks length and CRC at the end, after sink has seen the text
+  template <typename Sink>
+  static bool decode(const uint8_t* blob, size_t size, Sink sink) {
+    if (!valid(blob, size)) return false;
+
+    uint8_t* window = new (std::nothrow) uint8_t[RESPONSE_CODEC_WINDOW];
+    if (window == nullptr) return false;
+
+    BitReader bits(stream(blob), streamSize(size));
+    uint32_t expected = rawLength(blob);
+    uint32_t crc = 0;
+    size_t total = 0;
+    size_t fill = 0;     // write position in window
+    size_t flushed = 0;  // window bytes already passed to sink
+    bool ok = true;
+    bool last = false;
+
+    auto flush = [&]() {
+      if (fill > flushed) {
+        crc = kbCrc32(window + flushed, fill - flushed, crc);
+        sink(window + flushed, fill - flushed);
+      }
+      flushed = fill = fill == RESPONSE_CODEC_WINDOW ? 0 : fill;
+    };
+    auto emit = [&](uint8_t value) {
+      window[fill++] = value;
+      total++;
+      if (fill == RESPONSE_CODEC_WINDOW) flush();
+    };
+
+    Decoder literals;
+    Decoder distances;
+    while (ok && !last) {
+      last = bits.get(1);
+      uint32_t type = bits.get(2);
+
+      if (type == 0) {
+        bits.align();
+        const uint8_t* header = bits.take(4);
+        if (header == nullptr) break;
+        uint16_t storedLength = header[0] | (header[1] << 8);
+        uint16_t check = header[2] | (header[3] << 8);
+        const uint8_t* bytes = bits.take(storedLength);
+        if (bytes == nullptr || (uint16_t)~storedLength != check || total + storedLength > expected) {
+          ok = false;
+          break;
+        }
+        for (size_t i = 0; i < storedLength; i++) emit(bytes[i]);
+        continue;
+      }
+
+      if (type == 1) {
+        fixedDecoders(literals, distances);
+      } else if (type != 2 || !readDecoders(bits, literals, distances)) {
+        ok = false;
+        break;
+      }
+
+      for (;;) {
+        int symbol = decodeSymbol(bits, literals);
+        if (symbol < 256) {
+          if (symbol < 0 || total >= expected) {
+            ok = false;
+            break;
+          }
+          emit(symbol);
+          continue;
+        }
+        if (symbol == 256) break;
+
+        symbol -= 257;
+        if (symbol >= 29) {
+          ok = false;
+          break;
+        }
+        size_t length = codecLengthBase[symbol] + bits.get(codecLengthExtra[symbol]);
+        int code = decodeSymbol(bits, distances);
+        if (code < 0 || code >= 30) {
+          ok = false;
+          break;
+        }
+        size_t distance = codecDistanceBase[code] + bits.get(codecDistanceExtra[code]);
+        if (bits.overrun || distance >= RESPONSE_CODEC_WINDOW || distance > total || total + length > expected) {
+          ok = false;
+          break;
+        }
+        for (size_t i = 0; i < length; i++) {
+          emit(window[(fill - distance) & (RESPONSE_CODEC_WINDOW - 1)]);
+        }
+      }
+      if (bits.overrun) ok = false;
+    }
+    if (ok) flush();
+    delete[] window;
+    return ok && total == expected && crc == getWord(blob);
+  }
+
+#ifdef ARDUINO
+  static bool decode(const uint8_t* blob, size_t size, String& out) {
+    out = "";
+    if (!valid(blob, size) || !out.reserve(rawLength(blob))) return false;
+    bool ok = decode(blob, size, [&out](const uint8_t* data, size_t length) {
+      out.concat((const char*)data, length);
+    });
+    if (!ok) out = "";
+    return ok;
+  }
+#endif
+
+private:
+  static void putWord(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back(value >> (8 * i));
+  }
+
+  static uint32_t getWord(const uint8_t* bytes) {
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+  }
+
+  // Hash chains hold positions modulo 65536. Candidates are checked byte by
+  // byte, so a stale or aliased entry can only cost a comparison
+  static uint32_t hashAt(const uint8_t* input, size_t pos) {
+    uint32_t value = input[pos] | (input[pos + 1] << 8) | (input[pos + 2] << 16);
+    return (value * 2654435761u) >> (32 - RESPONSE_CODEC_HASH_BITS);
+  }
+
+  static void insert(const uint8_t* input, size_t length, size_t pos,
+                     std::vector<uint16_t>& head, std::vector<uint16_t>& chain) {
+    if (pos + RESPONSE_CODEC_MIN_MATCH > length) return;
+    uint16_t& bucket = head[hashAt(input, pos)];
+    chain[pos & (RESPONSE_CODEC_WINDOW - 1)] = bucket;
+    bucket = pos;
+  }
+
+  static Token longestMatch(const uint8_t* input, size_t length, size_t pos,
+                            const std::vector<uint16_t>& head, const std::vector<uint16_t>& chain) {
+    Token best = {0, 0};
+    if (pos + RESPONSE_CODEC_MIN_MATCH > length) return best;
+
+    size_t limit = std::min(length - pos, (size_t)RESPONSE_CODEC_MAX_MATCH);
+    uint16_t candidate = head[hashAt(input, pos)];
+    size_t lastDistance = 0;
+    for (int steps = 0; steps < RESPONSE_CODEC_MAX_CHAIN; steps++) {
+      size_t distance = (uint16_t)(pos - candidate);
+      if (distance <= lastDistance || distance >= RESPONSE_CODEC_WINDOW || distance > pos) break;
+      lastDistance = distance;
+
+      const uint8_t* a = input + pos;
+      const uint8_t* b = a - distance;
+      if (b[best.length] == a[best.length]) {
+        size_t matched = 0;
+        while (matched < limit && a[matched] == b[matched]) matched++;
+        if (matched > best.length) {
+          best.length = matched;
+          best.distance = distance;
+          if (matched == limit) break;
+        }
+      }
+      candidate = chain[(pos - distance) & (RESPONSE_CODEC_WINDOW - 1)];
+    }
+    if (best.length < RESPONSE_CODEC_MIN_MATCH) best.length = 0;
+    return best;
+  }
+
+  static int lengthCode(size_t length) {
+    int code = 28;
+    while (codecLengthBase[code] > length) code--;
+    return code;
+  }
+
+  static int distanceCode(size_t distance) {
+    int code = 29;
+    while (codecDistanceBase[code] > distance) code--;
+    return code;
+  }
+
+  // Emit one block as stored, fixed or dynamic Huffman, whichever is smallest
+  static void writeBlock(BitWriter& bits, const std::vector<Token>& tokens,
+                         const uint8_t* input, size_t length, bool last) {
+    uint32_t literalFreq[286] = {};
+    uint32_t distanceFreq[30] = {};
+    size_t extraBits = 0;
+    for (const Token& token : tokens) {
+      if (token.distance == 0) {
+        literalFreq[token.length]++;
+      } else {
+        int lengthSymbol = lengthCode(token.length);
+        int distanceSymbol = distanceCode(token.distance);
+        literalFreq[257 + lengthSymbol]++;
+        distanceFreq[distanceSymbol]++;
+        extraBits += codecLengthExtra[lengthSymbol] + codecDistanceExtra[distanceSymbol];
+      }
+    }
+    literalFreq[256] = 1;
+
+    uint8_t fixedLiterals[288];
+    uint8_t fixedDistances[30];
+    fixedLengths(fixedLiterals, fixedDistances);
+
+    // Dynamic codes, leaving 286 and 287 unused. zlib rejects incomplete
+    // trees, so each tree gets at least two symbols
+    useTwo(literalFreq, 286);
+    useTwo(distanceFreq, 30);
+    uint8_t literalLengths[288] = {};
+    uint8_t distanceLengths[30];
+    buildLengths(literalFreq, 286, 15, literalLengths);
+    buildLengths(distanceFreq, 30, 15, distanceLengths);
+
+    size_t literalCount = 286;
+    while (literalCount > 257 && literalLengths[literalCount - 1] == 0) literalCount--;
+    size_t distanceCount = 30;
+    while (distanceCount > 1 && distanceLengths[distanceCount - 1] == 0) distanceCount--;
+
+    uint8_t lengths[286 + 30];
+    memcpy(lengths, literalLengths, literalCount);
+    memcpy(lengths + literalCount, distanceLengths, distanceCount);
+    std::vector<Token> runs;  // code length symbol and its repeat bits
+    encodeLengths(lengths, literalCount + distanceCount, runs);
+
+    uint32_t codeLengthFreq[19] = {};
+    for (const Token& run : runs) codeLengthFreq[run.length]++;
+    useTwo(codeLengthFreq, 19);
+    uint8_t codeLengthLengths[19];
+    buildLengths(codeLengthFreq, 19, 7, codeLengthLengths);
+    size_t codeLengthCount = 19;
+    while (codeLengthCount > 4 && codeLengthLengths[codecCodeLengthOrder[codeLengthCount - 1]] == 0) {
+      codeLengthCount--;
+    }
+
+    size_t dynamicBits = 14 + 3 * codeLengthCount + extraBits;
+    for (const Token& run : runs) {
+      dynamicBits += codeLengthLengths[run.length] + (run.length == 16 ? 2 : run.length == 17 ? 3 : run.length == 18 ? 7 : 0);
+    }
+    size_t fixedBits = extraBits;
+    for (size_t i = 0; i < 286; i++) {
+      dynamicBits += literalFreq[i] * literalLengths[i];
+      fixedBits += literalFreq[i] * fixedLiterals[i];
+    }
+    for (size_t i = 0; i < 30; i++) {
+      dynamicBits += distanceFreq[i] * distanceLengths[i];
+      fixedBits += distanceFreq[i] * fixedDistances[i];
+    }
+    size_t storedBits = (length + 5 * (length / 65535 + 1)) * 8 + 7;
+
+    if (storedBits < fixedBits && storedBits < dynamicBits) {
+      writeStored(bits, input, length, last);
+      return;
+    }
+
+    bits.put(last, 1);
+    if (fixedBits <= dynamicBits) {
+      bits.put(1, 2);
+      writeTokens(bits, tokens, fixedLiterals, fixedDistances);
+      return;
+    }
+
+    bits.put(2, 2);
+    bits.put(literalCount - 257, 5);
+    bits.put(distanceCount - 1, 5);
+    bits.put(codeLengthCount - 4, 4);
+    for (size_t i = 0; i < codeLengthCount; i++) {
+      bits.put(codeLengthLengths[codecCodeLengthOrder[i]], 3);
+    }
+    uint16_t codeLengthCodes[19];
+    buildCodes(codeLengthLengths, 19, codeLengthCodes);
+    for (const Token& run : runs) {
+      bits.put(codeLengthCodes[run.length], codeLengthLengths[run.length]);
+      if (run.length == 16) bits.put(run.distance, 2);
+      else if (run.length == 17) bits.put(run.distance, 3);
+      else if (run.length == 18) bits.put(run.distance, 7);
+    }
+    writeTokens(bits, tokens, literalLengths, distanceLengths);
+  }
+
+  static void writeStored(BitWriter& bits, const uint8_t* input, size_t length, bool last) {
+    size_t done = 0;
+    do {
+      size_t chunk = std::min(length - done, (size_t)65535);
+      bits.put(last && done + chunk == length, 1);
+      bits.put(0, 2);
+      bits.align();
+      bits.put(chunk, 16);
+      bits.put(~chunk & 0xFFFF, 16);
+      for (size_t i = 0; i < chunk; i++) bits.put(input[done + i], 8);
+      done += chunk;
+    } while (done < length);
+  }
+
+  static void writeTokens(BitWriter& bits, const std::vector<Token>& tokens,
+                          const uint8_t* literalLengths, const uint8_t* distanceLengths) {
+    uint16_t literalCodes[288];
+    uint16_t distanceCodes[30];
+    buildCodes(literalLengths, 288, literalCodes);
+    buildCodes(distanceLengths, 30, distanceCodes);
+
+    for (const Token& token : tokens) {
+      if (token.distance == 0) {
+        bits.put(literalCodes[token.length], literalLengths[token.length]);
+        continue;
+      }
+      int lengthSymbol = lengthCode(token.length);
+      bits.put(literalCodes[257 + lengthSymbol], literalLengths[257 + lengthSymbol]);
+      bits.put(token.length - codecLengthBase[lengthSymbol], codecLengthExtra[lengthSymbol]);
+      int distanceSymbol = distanceCode(token.distance);
+      bits.put(distanceCodes[distanceSymbol], distanceLengths[distanceSymbol]);
+      bits.put(token.distance - codecDistanceBase[distanceSymbol], codecDistanceExtra[distanceSymbol]);
+    }
+    bits.put(literalCodes[256], literalLengths[256]);
+  }
+
+  static void fixedLengths(uint8_t* literals, uint8_t* distances) {
+    for (size_t i = 0; i < 288; i++) {
+      literals[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+    }
+    for (size_t i = 0; i < 30; i++) distances[i] = 5;
+  }
+
+  static void useTwo(uint32_t* freq, size_t count) {
+    size_t used = 0;
+    for (size_t i = 0; i < count; i++) used += freq[i] != 0;
+    for (size_t i = 0; used < 2 && i < count; i++) {
+      if (freq[i] == 0) {
+        freq[i] = 1;
+        used++;
+      }
+    }
+  }
+
+  // Huffman code lengths of at most maxBits. Frequencies are flattened
+  // until the tree is shallow enough, which is rare for text this short
+  static void buildLengths(const uint32_t* freq, size_t count, uint8_t maxBits, uint8_t* lengths) {
+    std::vector<uint32_t> weights(freq, freq + count);
+    while (huffmanLengths(weights, lengths) > maxBits) {
+      for (uint32_t& weight : weights) {
+        if (weight > 0) weight = (weight + 1) / 2;
+      }
+    }
+  }
+
+  // Two-queue Huffman construction over leaves sorted by weight; returns
+  // the longest code length
+  static uint8_t huffmanLengths(const std::vector<uint32_t>& weights, uint8_t* lengths) {
+    size_t count = weights.size();
+    memset(lengths, 0, count);
+
+    std::vector<uint16_t> leaves;
+    for (size_t i = 0; i < count; i++) {
+      if (weights[i] > 0) leaves.push_back(i);
+    }
+    size_t used = leaves.size();
+    if (used == 0) return 0;
+    if (used == 1) {
+      lengths[leaves[0]] = 1;
+      return 1;
+    }
+    std::stable_sort(leaves.begin(), leaves.end(), [&weights](uint16_t a, uint16_t b) {
+      return weights[a] < weights[b];
+    });
+
+    std::vector<uint32_t> weight(2 * used - 1);
+    std::vector<uint16_t> parent(2 * used - 1);
+    for (size_t i = 0; i < used; i++) weight[i] = weights[leaves[i]];
+
+    size_t leaf = 0;
+    size_t internal = used;
+    for (size_t created = used; created < 2 * used - 1; created++) {
+      size_t pair[2];
+      for (size_t& pick : pair) {
+        if (leaf < used && (internal >= created || weight[leaf] <= weight[internal])) pick = leaf++;
+        else pick = internal++;
+      }
+      weight[created] = weight[pair[0]] + weight[pair[1]];
+      parent[pair[0]] = parent[pair[1]] = created;
+    }
+
+    // Parents come after their children, so depths fill in from the root
+    std::vector<uint8_t> depth(2 * used - 1, 0);
+    uint8_t longest = 0;
+    for (size_t i = 2 * used - 1; i-- > 0;) {
+      if (i < 2 * used - 2) depth[i] = depth[parent[i]] + 1;
+      if (i < used) {
+        lengths[leaves[i]] = depth[i];
+        longest = std::max(longest, depth[i]);
+      }
+    }
+    return longest;
+  }
+
+  // Canonical codes, bit-reversed for the LSB-first stream
+  static void buildCodes(const uint8_t* lengths, size_t count, uint16_t* codes) {
+    uint16_t lengthCount[16] = {};
+    for (size_t i = 0; i < count; i++) lengthCount[lengths[i]]++;
+    lengthCount[0] = 0;
+
+    uint16_t next[16];
+    uint16_t code = 0;
+    for (int bits = 1; bits < 16; bits++) {
+      code = (code + lengthCount[bits - 1]) << 1;
+      next[bits] = code;
+    }
+    for (size_t i = 0; i < count; i++) {
+      uint8_t length = lengths[i];
+      if (length == 0) continue;
+      uint16_t value = next[length]++;
+      uint16_t reversed = 0;
+      for (uint8_t b = 0; b < length; b++) {
+        reversed = (reversed << 1) | (value & 1);
+        value >>= 1;
+      }
+      codes[i] = reversed;
+    }
+  }
+
+  // Run-length code the concatenated code lengths with symbols 16-18
+  static void encodeLengths(const uint8_t* lengths, size_t count, std::vector<Token>& runs) {
+    size_t i = 0;
+    while (i < count) {
+      uint8_t length = lengths[i];
+      size_t run = 1;
+      while (i + run < count && lengths[i + run] == length) run++;
+      i += run;
+
+      if (length == 0) {
+        while (run >= 11) {
+          size_t take = std::min(run, (size_t)138);
+          runs.push_back({18, (uint16_t)(take - 11)});
+          run -= take;
+        }
+        if (run >= 3) {
+          runs.push_back({17, (uint16_t)(run - 3)});
+          run = 0;
+        }
+      } else {
+        runs.push_back({length, 0});
+        run--;
+        while (run >= 3) {
+          size_t take = std::min(run, (size_t)6);
+          runs.push_back({16, (uint16_t)(take - 3)});
+          run -= take;
+        }
+      }
+      while (run-- > 0) runs.push_back({length, 0});
+    }
+  }
+
+  static bool buildDecoder(Decoder& decoder, const uint8_t* lengths, size_t count) {
+    memset(decoder.count, 0, sizeof(decoder.count));
+    for (size_t i = 0; i < count; i++) decoder.count[lengths[i]]++;
+    if (decoder.count[0] == count) return false;
+
+    // Reject oversubscribed codes; incomplete ones fail when decoded
+    int left = 1;
+    for (int bits = 1; bits < 16; bits++) {
+      left = (left << 1) - decoder.count[bits];
+      if (left < 0) return false;
+    }
+
+    uint16_t offsets[16];
+    offsets[1] = 0;
+    for (int bits = 1; bits < 15; bits++) offsets[bits + 1] = offsets[bits] + decoder.count[bits];
+    for (size_t i = 0; i < count; i++) {
+      if (lengths[i] != 0) decoder.symbol[offsets[lengths[i]]++] = i;
+    }
+    return true;
+  }
+
+  static int decodeSymbol(BitReader& bits, const Decoder& decoder) {
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (int length = 1; length < 16; length++) {
+      code |= bits.get(1);
+      int count = decoder.count[length];
+      if (code - first < count) return decoder.symbol[index + code - first];
+      index += count;
+      first = (first + count) << 1;
+      code <<= 1;
+      if (bits.overrun) break;
+    }
+    return -1;
+  }
+
+  static void fixedDecoders(Decoder& literals, Decoder& distances) {
+    uint8_t literalLengths[288];
+    uint8_t distanceLengths[30];
+    fixedLengths(literalLengths, distanceLengths);
+    buildDecoder(literals, literalLengths, 288);
+    buildDecoder(distances, distanceLengths, 30);
+  }
+
+  static bool readDecoders(BitReader& bits, Decoder& literals, Decoder& distances) {
+    size_t literalCount = bits.get(5) + 257;
+    size_t distanceCount = bits.get(5) + 1;
+    size_t codeLengthCount = bits.get(4) + 4;
+    if (literalCount > 286 || distanceCount > 30) return false;
+
+    uint8_t codeLengthLengths[19] = {};
+    for (size_t i = 0; i < codeLengthCount; i++) {
+      codeLengthLengths[codecCodeLengthOrder[i]] = bits.get(3);
+    }
+    Decoder codeLengths;
+    if (!buildDecoder(codeLengths, codeLengthLengths, 19)) return false;
+
+    uint8_t lengths[286 + 30];
+    size_t index = 0;
+    while (index < literalCount + distanceCount) {
+      int symbol = decodeSymbol(bits, codeLengths);
+      if (symbol < 0) return false;
+      if (symbol < 16) {
+        lengths[index++] = symbol;
+        continue;
+      }
+
+      uint8_t value = 0;
+      size_t repeat;
+      if (symbol == 16) {
+        if (index == 0) return false;
+        value = lengths[index - 1];
+        repeat = 3 + bits.get(2);
+      } else if (symbol == 17) {
+        repeat = 3 + bits.get(3);
+      } else {
+        repeat = 11 + bits.get(7);
+      }
+      if (index + repeat > literalCount + distanceCount) return false;
+      while (repeat-- > 0) lengths[index++] = value;
+    }
+    if (bits.overrun || lengths[256] == 0) return false;
+
+    return buildDecoder(literals, lengths, literalCount) &&
+           buildDecoder(distances, lengths + literalCount, distanceCount);
+  }
+};
+
+#endif
\ No newline at end of file
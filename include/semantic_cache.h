@@ -0,0 +1,188 @@
+#ifndef SEMANTIC_CACHE_H
+#define SEMANTIC_CACHE_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <string.h>
+#endif
+#include <algorithm>
+#include "query_normalizer.h"
+
+// MinHash signature length; more hashes estimate similarity more closely
+#ifndef SEMANTIC_CACHE_HASHES
+#define SEMANTIC_CACHE_HASHES 32
+#endif
+#ifndef SEMANTIC_CACHE_ENTRIES
+#define SEMANTIC_CACHE_ENTRIES 128
+#endif
+// Estimated Jaccard similarity of question trigram sets needed for a hit
+#ifndef SEMANTIC_CACHE_MIN_SIMILARITY
+#define SEMANTIC_CACHE_MIN_SIMILARITY 0.8f
+#endif
+
+// Words that change what a question asks, however similar the rest is.
+// Each question word has its own bit; the negations share the last one
+constexpr const char* semanticIntentWords[] = {
+  "how", "what", "when", "where", "which", "who", "whom", "whose", "why",
+  "cannot", "never", "no", "none", "nor", "not", "t", "without"
+};
+constexpr size_t semanticNegationBit = 9;
+constexpr PerfectHashTable<64> semanticIntentTable = kbBuildPerfectHash<64>(semanticIntentWords);
+static_assert(semanticIntentTable.seed != 0, "no perfect hash seed for intent words");
+
+// MinHash signature of a normalized question
+struct QuestionSignature {
+  uint16_t minima[SEMANTIC_CACHE_HASHES];
+  uint16_t intent;  // bits of the semanticIntentWords it contains
+  bool empty;
+};
+
+struct SemanticCacheStats {
+  uint32_t lookups;
+  uint32_t hits;
+  uint32_t entries;
+};
+
+// Near-duplicate index over answered questions. Questions are normalized
+// (case, punctuation, filler words) and reduced to a MinHash signature of
+// their word trigrams, so "What is ESP32?" and "what's the esp32" land on
+// the same answer. Question words and negations must also match exactly:
+// "When was Arduino created?" never answers "Where was Arduino created?".
+// Synonyms are not mapped, since the knowledge base table is tuned for
+// finding passages, not for deciding two questions mean the same. A hit
+// also requires the same context ID,
+// the digest of the knowledge base passages sent with the question, so
+// answers never cross contexts. Entries point at response cache keys and
+// are replaced oldest first
+class SemanticCache {
+private:
+  struct Entry {
+    uint64_t contextId;
+    uint64_t responseKey;
+    QuestionSignature signature;
+  };
+
+  Entry* entries = nullptr;
+  size_t count = 0;
+  size_t next = 0;
+  float minSimilarity = SEMANTIC_CACHE_MIN_SIMILARITY;
+  bool enabled = true;
+  SemanticCacheStats counters = {};
+
+public:
+  SemanticCache() {}
+  SemanticCache(const SemanticCache&) = delete;
+  SemanticCache& operator=(const SemanticCache&) = delete;
+
+  ~SemanticCache() { delete[] entries; }
+
+  // Similarity above 1 never matches, which turns the cache off
+  void configure(bool enable, float similarity = SEMANTIC_CACHE_MIN_SIMILARITY) {
+    enabled = enable;
+    minSimilarity = similarity;
+  }
+
+  bool isEnabled() const { return enabled; }
+
+  static QuestionSignature signature(const char* question, size_t questionLength) {
+    QuestionSignature result;
+    for (size_t i = 0; i < SEMANTIC_CACHE_HASHES; i++) result.minima[i] = 0xFFFF;
+    result.intent = 0;
+    result.empty = true;
+
+    char normalized[KB_MAX_QUERY_LENGTH];
+    size_t length = QueryNormalizer::normalizeQuestion(question, questionLength, normalized, sizeof(normalized));
+
+    // Trigrams of each word padded as "^word$"; words are kept apart
+    size_t start = 0;
+    while (start < length) {
+      size_t end = start;
+      while (end < length && normalized[end] != ' ') end++;
+
+      int intent = kbPerfectHashFind(semanticIntentTable, semanticIntentWords, normalized + start, end - start);
+      if (intent >= 0) result.intent |= 1 << std::min((size_t)intent, semanticNegationBit);
+
+      char padded[KB_MAX_TOKEN_LENGTH + 2];
+      size_t wordLength = std::min(end - start, (size_t)KB_MAX_TOKEN_LENGTH);
+      padded[0] = '^';
+      memcpy(padded + 1, normalized + start, wordLength);
+      padded[wordLength + 1] = '$';
+      for (size_t t = 0; t + 3 <= wordLength + 2; t++) {
+        addFeature(result, kbHashToken(padded + t, 3));
+      }
+      start = end + 1;
+    }
+    return result;
+  }
+
+#ifdef ARDUINO
+  static QuestionSignature signature(const String& question) {
+    return signature(question.c_str(), question.length());
+  }
+#endif
+
+  // Estimated Jaccard similarity: the share of equal minima. Questions
+  // asking something different score 0
+  static float similarity(const QuestionSignature& a, const QuestionSignature& b) {
+    if (a.empty || b.empty || a.intent != b.intent) return 0;
+    size_t equal = 0;
+    for (size_t i = 0; i < SEMANTIC_CACHE_HASHES; i++) {
+      if (a.minima[i] == b.minima[i]) equal++;
+    }
+    return (float)equal / SEMANTIC_CACHE_HASHES;
+  }
+
+  // Response key of the most similar earlier question in this context
+  bool find(uint64_t contextId, const QuestionSignature& question, uint64_t& responseKey) {
+    if (!enabled || question.empty) return false;
+    counters.lookups++;
+
+    float best = minSimilarity;
+    bool found = false;
+    for (size_t i = 0; i < count; i++) {
+      if (entries[i].contextId != contextId) continue;
+      float score = similarity(entries[i].signature, question);
+      if (score >= best) {
+        best = score;
+        responseKey = entries[i].responseKey;
+        found = true;
+      }
+    }
+    if (found) counters.hits++;
+    return found;
+  }
+
+  void remember(uint64_t contextId, const QuestionSignature& question, uint64_t responseKey) {
+    if (!enabled || question.empty) return;
+    if (entries == nullptr) entries = new Entry[SEMANTIC_CACHE_ENTRIES];
+
+    Entry& entry = entries[next];
+    entry.contextId = contextId;
+    entry.responseKey = responseKey;
+    entry.signature = question;
+    next = (next + 1) % SEMANTIC_CACHE_ENTRIES;
+    count = std::min(count + 1, (size_t)SEMANTIC_CACHE_ENTRIES);
+    counters.entries = count;
+  }
+
+  const SemanticCacheStats& stats() const { return counters; }
+
+private:
+  // One base hash per trigram, remixed per signature slot
+  static void addFeature(QuestionSignature& signature, uint32_t hash) {
+    for (size_t i = 0; i < SEMANTIC_CACHE_HASHES; i++) {
+      uint32_t h = hash ^ (0x9E3779B9u * (i + 1));
+      h ^= h >> 16;
+      h *= 0x85EBCA6Bu;
+      h ^= h >> 13;
+      h *= 0xC2B2AE35u;
+      h ^= h >> 16;
+      signature.minima[i] = std::min(signature.minima[i], (uint16_t)h);
+    }
+    signature.empty = false;
+  }
+};
+
+#endif
\ No newline at end of file
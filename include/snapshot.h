@@ -0,0 +1,178 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Versions that may be alive at once: the current one plus those still
+// held by readers. Publishing waits for a free slot
+#ifndef SNAPSHOT_SLOTS
+#define SNAPSHOT_SLOTS 8
+#endif
+
+#define SNAPSHOT_READER_BITS 16
+#define SNAPSHOT_READER_MASK ((1u << SNAPSHOT_READER_BITS) - 1)
+
+template <typename T>
+class SnapshotCell;
+
+// A reader's hold on one published version, released when destroyed.
+// Move-only; the version it points to never changes while held
+template <typename T>
+class SnapshotRef {
+private:
+  SnapshotCell<T>* cell = nullptr;
+  uint32_t slot = 0;
+  const T* value = nullptr;
+
+  friend class SnapshotCell<T>;
+  SnapshotRef(SnapshotCell<T>* owner, uint32_t index, const T* version)
+    : cell(owner), slot(index), value(version) {}
+
+public:
+  SnapshotRef() {}
+  SnapshotRef(const SnapshotRef&) = delete;
+  SnapshotRef& operator=(const SnapshotRef&) = delete;
+
+  SnapshotRef(SnapshotRef&& other) : cell(other.cell), slot(other.slot), value(other.value) {
+    other.cell = nullptr;
+    other.value = nullptr;
+  }
+
+  SnapshotRef& operator=(SnapshotRef&& other) {
+    if (this != &other) {
+      reset();
+      cell = other.cell;
+      slot = other.slot;
+      value = other.value;
+      other.cell = nullptr;
+      other.value = nullptr;
+    }
+    return *this;
+  }
+
+  ~SnapshotRef() { reset(); }
+
+  void reset() {
+    if (cell != nullptr) cell->release(slot);
+    cell = nullptr;
+    value = nullptr;
+  }
+
+  const T* get() const { return value; }
+  const T* operator->() const { return value; }
+  const T& operator*() const { return *value; }
+  explicit operator bool() const { return value != nullptr; }
+};
+
+// Publishes immutable versions of a value to concurrent readers without
+// locks, using split reference counts. The current version is one 32-bit
+// word: its slot index and the number of readers holding it. Acquiring is
+// a single atomic increment of that word. Publishing swaps in a new word
+// and moves the old reader count into the old slot's own counter, which
+// those readers decrement on release. Whoever brings it to zero deletes
+// the version. Publishers must be serialized by the caller
+template <typename T>
+class SnapshotCell {
+private:
+  struct Slot {
+    T* value;                     // written before publish, read after acquire
+    std::atomic<int32_t> readers; // held references once replaced
+    std::atomic<bool> used;
+  };
+
+  Slot slots[SNAPSHOT_SLOTS];
+  std::atomic<uint32_t> current;
+
+  friend class SnapshotRef<T>;
+
+public:
+  // Starts with an empty version in slot 0, acquired as a null reference
+  SnapshotCell() : current(0) {
+    static_assert(SNAPSHOT_SLOTS <= (1u << (32 - SNAPSHOT_READER_BITS)), "too many snapshot slots");
+    for (size_t i = 0; i < SNAPSHOT_SLOTS; i++) {
+      slots[i].value = nullptr;
+      slots[i].readers.store(0, std::memory_order_relaxed);
+      slots[i].used.store(i == 0, std::memory_order_relaxed);
+    }
+  }
+
+  SnapshotCell(const SnapshotCell&) = delete;
+  SnapshotCell& operator=(const SnapshotCell&) = delete;
+
+  // Readers must be gone by now
+  ~SnapshotCell() {
+    delete slots[current.load(std::memory_order_acquire) >> SNAPSHOT_READER_BITS].value;
+  }
+
+  // Hold the current version; never blocks
+  SnapshotRef<T> acquire() {
+    uint32_t word = current.fetch_add(1, std::memory_order_acquire);
+    uint32_t slot = word >> SNAPSHOT_READER_BITS;
+    return SnapshotRef<T>(this, slot, slots[slot].value);
+  }
+
+  // Make value, a heap-allocated version, current and take ownership of
+  // it. The replaced version is deleted once its last reader lets go
+  void publish(T* value) {
+    uint32_t slot = freeSlot();
+    slots[slot].value = value;
+    slots[slot].readers.store(0, std::memory_order_relaxed);
+    slots[slot].used.store(true, std::memory_order_relaxed);
+
+    uint32_t old = current.exchange(slot << SNAPSHOT_READER_BITS, std::memory_order_acq_rel);
+    uint32_t oldSlot = old >> SNAPSHOT_READER_BITS;
+    int32_t holders = old & SNAPSHOT_READER_MASK;
+    if (slots[oldSlot].readers.fetch_add(holders, std::memory_order_acq_rel) + holders == 0) {
+      retire(oldSlot);
+    }
+  }
+
+  // Versions currently alive, including the current one
+  size_t liveVersions() const {
+    size_t count = 0;
+    for (size_t i = 0; i < SNAPSHOT_SLOTS; i++) {
+      if (slots[i].used.load(std::memory_order_acquire)) count++;
+    }
+    return count;
+  }
+
+  // Block until every replaced version has been released
+  void waitForReaders() const {
+    while (liveVersions() > 1) delay(1);
+  }
+
+private:
+  void release(uint32_t slot) {
+    // Still current: give the reference back through the shared word
+    uint32_t word = current.load(std::memory_order_relaxed);
+    while ((word >> SNAPSHOT_READER_BITS) == slot) {
+      if (current.compare_exchange_weak(word, word - 1, std::memory_order_release, std::memory_order_relaxed)) {
+        return;
+      }
+    }
+
+    // Replaced: the publisher moved this reference into the slot counter
+    if (slots[slot].readers.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      retire(slot);
+    }
+  }
+
+  void retire(uint32_t slot) {
+    delete slots[slot].value;
+    slots[slot].value = nullptr;
+    slots[slot].used.store(false, std::memory_order_release);
+  }
+
+  // Only the serialized publisher claims slots, so a free one stays free
+  uint32_t freeSlot() const {
+    for (;;) {
+      for (uint32_t i = 0; i < SNAPSHOT_SLOTS; i++) {
+        if (!slots[i].used.load(std::memory_order_acquire)) return i;
+      }
+      delay(1);
+    }
+  }
+};
+
+#endif
\ No newline at end of file
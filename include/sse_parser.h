@@ -0,0 +1,96 @@
+#ifndef SSE_PARSER_H
+#define SSE_PARSER_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+typedef String SseText;
+#else
+#include <string.h>
+#include <string>
+typedef std::string SseText;
+#endif
+
+// Longest line kept; longer lines are dropped along with their event
+#ifndef SSE_MAX_LINE
+#define SSE_MAX_LINE 4096
+#endif
+
+// Incremental parser for a text/event-stream body. Bytes are fed as they
+// arrive, split anywhere, and each complete event's data (its data: lines
+// joined with newlines) is passed to onEvent(const SseText&). Comments and
+// the event, id and retry fields are ignored
+class SseParser {
+private:
+  SseText line;
+  SseText data;
+  bool hasData = false;
+  bool overflow = false;     // the current line outgrew SSE_MAX_LINE
+  bool dropEvent = false;    // the current event lost a line to overflow
+  bool afterCR = false;      // a CR ended the last line; skip its LF
+
+public:
+  template <typename Handler>
+  void feed(const char* bytes, size_t length, Handler onEvent) {
+    for (size_t i = 0; i < length; i++) {
+      char c = bytes[i];
+      if (afterCR) {
+        afterCR = false;
+        if (c == '\n') continue;
+      }
+      if (c == '\r' || c == '\n') {
+        afterCR = c == '\r';
+        endLine(onEvent);
+        continue;
+      }
+
+      // Copy the run up to the next line end in one go
+      size_t end = i + 1;
+      while (end < length && bytes[end] != '\r' && bytes[end] != '\n') end++;
+      if (!overflow && line.length() + (end - i) <= SSE_MAX_LINE) {
+        append(line, bytes + i, end - i);
+      } else {
+        overflow = true;
+      }
+      i = end - 1;
+    }
+  }
+
+private:
+  template <typename Handler>
+  void endLine(Handler& onEvent) {
+    if (overflow) {
+      // Drop the whole event rather than pass on part of it
+      line = "";
+      overflow = false;
+      dropEvent = true;
+      return;
+    }
+
+    if (line.length() == 0) {
+      // A blank line dispatches the event
+      if (hasData && !dropEvent) onEvent(data);
+      data = "";
+      hasData = false;
+      dropEvent = false;
+      return;
+    }
+
+    if (!dropEvent && strncmp(line.c_str(), "data:", 5) == 0) {
+      int start = line.length() > 5 && line[5] == ' ' ? 6 : 5;
+      if (hasData) data += '\n';
+      append(data, line.c_str() + start, line.length() - start);
+      hasData = true;
+    }
+    line = "";
+  }
+
+  static void append(SseText& text, const char* bytes, size_t length) {
+#ifdef ARDUINO
+    text.concat(bytes, length);
+#else
+    text.append(bytes, length);
+#endif
+  }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef STATIC_ASSETS_H
+#define STATIC_ASSETS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include "http_server.h"
+
+// A gzipped file kept in flash, as generated by tools/web_compile.py
+// into web_assets.h
+struct StaticAsset {
+  const char* path;
+  const char* contentType;
+  const char* etag;          // strong, quotes included
+  const char* cacheControl;
+  const uint8_t* data;
+  size_t length;
+
+  // Answer 304 if the browser's copy is current, otherwise send the
+  // compressed bytes straight from flash. Every browser accepts gzip, so
+  // no uncompressed copy is kept
+  void send(const HttpRequest& request, HttpResponse& response) const {
+    response.setHeader("ETag", etag);
+    response.setHeader("Cache-Control", cacheControl);
+    if (matches(request.header("if-none-match"))) {
+      response.send(304, contentType, std::string());
+      return;
+    }
+    response.setHeader("Content-Encoding", "gzip");
+    response.sendStatic(200, contentType, (const char*)data, length);
+  }
+
+  // Whether an If-None-Match list names this version. Weak tags compare
+  // equal to strong ones here, as revalidation allows
+  bool matches(const std::string& ifNoneMatch) const {
+    size_t tagLength = strlen(etag);
+    size_t start = 0;
+    while (start < ifNoneMatch.length()) {
+      size_t end = ifNoneMatch.find(',', start);
+      if (end == std::string::npos) end = ifNoneMatch.length();
+      while (start < end && ifNoneMatch[start] == ' ') start++;
+      size_t last = end;
+      while (last > start && ifNoneMatch[last - 1] == ' ') last--;
+      if (ifNoneMatch.compare(start, 2, "W/") == 0) start += 2;
+      if (last - start == 1 && ifNoneMatch[start] == '*') return true;
+      if (last - start == tagLength && ifNoneMatch.compare(start, tagLength, etag) == 0) return true;
+      start = end + 1;
+    }
+    return false;
+  }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,187 @@
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <ctype.h>
+#include <stdint.h>
+#include <string.h>
+#endif
+#include <vector>
+#include <algorithm>
+#include "knowledge_store.h"
+
+// Words are padded as "^word$", so a word of n characters has n trigrams
+#define KB_MAX_TRIGRAMS (KB_MAX_TOKEN_LENGTH + 2)
+#define KB_TRIGRAM_START 0x01
+#define KB_TRIGRAM_END 0x02
+
+// Minimum Jaccard similarity of trigram sets for a fuzzy token match
+#ifndef KB_FUZZY_MIN_SIMILARITY
+#define KB_FUZZY_MIN_SIMILARITY 0.4f
+#endif
+// Shorter query words are not matched fuzzily
+#ifndef KB_FUZZY_MIN_LENGTH
+#define KB_FUZZY_MIN_LENGTH 4
+#endif
+
+// Write the distinct trigrams of a lowercase word, packed three bytes to a
+// uint32_t, in ascending order. Returns how many were written
+inline size_t kbTrigrams(const char* word, size_t length, uint32_t* out) {
+  if (length == 0) return 0;
+  length = std::min(length, (size_t)KB_MAX_TOKEN_LENGTH);
+
+  size_t count = 0;
+  for (size_t i = 0; i < length; i++) {
+    uint32_t a = i == 0 ? KB_TRIGRAM_START : (uint8_t)word[i - 1];
+    uint32_t b = (uint8_t)word[i];
+    uint32_t c = i + 1 < length ? (uint8_t)word[i + 1] : KB_TRIGRAM_END;
+    out[count++] = (a << 16) | (b << 8) | c;
+  }
+
+  std::sort(out, out + count);
+  return std::unique(out, out + count) - out;
+}
+
+// Trigram -> token posting lists: sorted packed trigram keys, offsets into
+// the token id array (count + 1 entries) and the token ids themselves
+struct TrigramTables {
+  const uint32_t* keys;
+  const uint32_t* offsets;
+  const uint16_t* tokenIds;
+  uint32_t count;
+};
+
+// A token whose trigram set is similar to a query word
+struct TrigramMatch {
+  uint16_t token;
+  float similarity;
+};
+
+// Character trigram index over a keyword token dictionary, used to match
+// misspelled or split query words. Lookups only touch tokens sharing a
+// trigram with the word, so their cost does not grow with the corpus. The
+// index is either a view of compiled or image tables or built in RAM
+class TrigramIndex {
+private:
+  TrigramTables view = {};
+  std::vector<uint32_t> keys;
+  std::vector<uint32_t> offsets;
+  std::vector<uint16_t> tokenIds;
+
+public:
+  TrigramIndex() {}
+
+  // Copies own their tables, so the view is re-pointed at the copy
+  TrigramIndex(const TrigramIndex& other) { *this = other; }
+
+  TrigramIndex& operator=(const TrigramIndex& other) {
+    if (this != &other) {
+      view = other.view;
+      keys = other.keys;
+      offsets = other.offsets;
+      tokenIds = other.tokenIds;
+      if (!offsets.empty()) attachOwned();
+    }
+    return *this;
+  }
+
+  void open(const TrigramTables& tables) {
+    clear();
+    view = tables;
+  }
+
+  void clear() {
+    view = TrigramTables();
+    keys.clear();
+    offsets.clear();
+    tokenIds.clear();
+  }
+
+  // Build owned tables from a token source with tokenCount() and
+  // tokenText()/token().length accessors
+  template <typename Source>
+  void build(const Source& source) {
+    clear();
+
+    std::vector<std::pair<uint32_t, uint16_t> > entries;
+    uint32_t trigrams[KB_MAX_TRIGRAMS];
+    for (size_t id = 0; id < source.tokenCount(); id++) {
+      size_t count = kbTrigrams(source.tokenText(id), source.token(id).length, trigrams);
+      for (size_t i = 0; i < count; i++) {
+        entries.push_back(std::make_pair(trigrams[i], (uint16_t)id));
+      }
+    }
+    std::sort(entries.begin(), entries.end());
+
+    for (size_t i = 0; i < entries.size(); i++) {
+      if (keys.empty() || keys.back() != entries[i].first) {
+        keys.push_back(entries[i].first);
+        offsets.push_back(tokenIds.size());
+      }
+      tokenIds.push_back(entries[i].second);
+    }
+    offsets.push_back(tokenIds.size());
+    attachOwned();
+  }
+
+  const TrigramTables& tables() const { return view; }
+  size_t tokenIdCount() const { return view.count ? view.offsets[view.count] : 0; }
+
+  size_t memoryUsage() const {
+    return keys.capacity() * sizeof(uint32_t) +
+      offsets.capacity() * sizeof(uint32_t) +
+      tokenIds.capacity() * sizeof(uint16_t);
+  }
+
+  // Tokens of the source whose trigram sets have a Jaccard similarity of
+  // at least minSimilarity with the word
+  template <typename Source>
+  void findSimilar(const Source& source, const char* word, size_t length, float minSimilarity,
+                   std::vector<TrigramMatch>& out) const {
+    if (view.count == 0) return;
+
+    uint32_t wordTrigrams[KB_MAX_TRIGRAMS];
+    size_t wordCount = kbTrigrams(word, length, wordTrigrams);
+
+    std::vector<uint16_t> candidates;
+    for (size_t i = 0; i < wordCount; i++) {
+      const uint32_t* key = std::lower_bound(view.keys, view.keys + view.count, wordTrigrams[i]);
+      if (key == view.keys + view.count || *key != wordTrigrams[i]) continue;
+
+      size_t k = key - view.keys;
+      candidates.insert(candidates.end(), view.tokenIds + view.offsets[k], view.tokenIds + view.offsets[k + 1]);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    uint32_t tokenTrigrams[KB_MAX_TRIGRAMS];
+    for (size_t i = 0; i < candidates.size();) {
+      size_t run = i;
+      while (run < candidates.size() && candidates[run] == candidates[i]) run++;
+
+      // Shared trigrams bound the similarity before the token is expanded
+      float shared = run - i;
+      if (shared / wordCount >= minSimilarity) {
+        uint16_t id = candidates[i];
+        size_t tokenCount = kbTrigrams(source.tokenText(id), source.token(id).length, tokenTrigrams);
+        float similarity = shared / (wordCount + tokenCount - shared);
+        if (similarity >= minSimilarity) {
+          TrigramMatch match = {id, similarity};
+          out.push_back(match);
+        }
+      }
+      i = run;
+    }
+  }
+
+private:
+  void attachOwned() {
+    view.keys = keys.data();
+    view.offsets = offsets.data();
+    view.tokenIds = tokenIds.data();
+    view.count = keys.size();
+  }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,577 @@
+#ifndef UPSTREAM_CONNECTION_H
+#define UPSTREAM_CONNECTION_H
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <mbedtls/version.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/net_sockets.h>
+#include "profiler.h"
+
+// TCP connect timeout in ms
+#ifndef UPSTREAM_CONNECT_TIMEOUT
+#define UPSTREAM_CONNECT_TIMEOUT 10000
+#endif
+#ifndef UPSTREAM_HANDSHAKE_TIMEOUT
+#define UPSTREAM_HANDSHAKE_TIMEOUT 10000
+#endif
+// Kept-alive connections idle this long are closed, ahead of the server
+// dropping them, which also frees their TLS buffers
+#ifndef UPSTREAM_IDLE_TIMEOUT
+#define UPSTREAM_IDLE_TIMEOUT 30000
+#endif
+// Longest wait for the next bytes of a response
+#ifndef UPSTREAM_RESPONSE_TIMEOUT
+#define UPSTREAM_RESPONSE_TIMEOUT 15000
+#endif
+#ifndef UPSTREAM_MAX_LINE
+#define UPSTREAM_MAX_LINE 1024
+#endif
+
+#define UPSTREAM_BUFFER_SIZE 512
+
+#if MBEDTLS_VERSION_MAJOR >= 3
+#define UPSTREAM_SESSION_FIELD(session, field) ((session).MBEDTLS_PRIVATE(field))
+#else
+#define UPSTREAM_SESSION_FIELD(session, field) ((session).field)
+#endif
+
+// TLS client over a WiFiClient socket that keeps the session negotiated
+// by its last handshake. Reconnecting offers it back (session ticket or
+// ID), so a connection the server dropped resumes with an abbreviated
+// handshake instead of a full one with certificate and key exchange
+class TlsConnection {
+private:
+  WiFiClient tcp;
+  mbedtls_ssl_context ssl;
+  mbedtls_ssl_config config;
+  mbedtls_ctr_drbg_context random;
+  mbedtls_entropy_context entropy;
+  mbedtls_ssl_session session;  // from the last handshake
+  bool configured = false;
+  bool open = false;
+  bool hasSession = false;
+  bool wasResumed = false;
+
+public:
+  TlsConnection() { mbedtls_ssl_session_init(&session); }
+  TlsConnection(const TlsConnection&) = delete;
+  TlsConnection& operator=(const TlsConnection&) = delete;
+
+  ~TlsConnection() {
+    stop();
+    mbedtls_ssl_session_free(&session);
+    if (configured) {
+      mbedtls_ssl_config_free(&config);
+      mbedtls_ctr_drbg_free(&random);
+      mbedtls_entropy_free(&entropy);
+    }
+  }
+
+  // Connect and handshake, reporting how long each took
+  bool connect(const char* host, uint16_t port, uint32_t& connectMs, uint32_t& handshakeMs) {
+    stop();
+    if (!configure()) return false;
+
+    unsigned long start = millis();
+    if (!tcp.connect(host, port, UPSTREAM_CONNECT_TIMEOUT)) return false;
+    tcp.setNoDelay(true);
+    connectMs = millis() - start;
+
+    start = millis();
+    mbedtls_ssl_init(&ssl);
+    open = true;
+    if (mbedtls_ssl_setup(&ssl, &config) != 0 || mbedtls_ssl_set_hostname(&ssl, host) != 0) {
+      stop();
+      return false;
+    }
+    mbedtls_ssl_set_bio(&ssl, &tcp, sendCallback, receiveCallback, nullptr);
+    if (hasSession) mbedtls_ssl_set_session(&ssl, &session);
+
+    int result;
+    while ((result = mbedtls_ssl_handshake(&ssl)) != 0) {
+      if ((result != MBEDTLS_ERR_SSL_WANT_READ && result != MBEDTLS_ERR_SSL_WANT_WRITE) ||
+          millis() - start > UPSTREAM_HANDSHAKE_TIMEOUT) {
+        // Start the next attempt from a full handshake
+        forgetSession();
+        stop();
+        return false;
+      }
+      delay(1);
+    }
+    handshakeMs = millis() - start;
+    saveSession();
+    return true;
+  }
+
+  bool connected() { return open && tcp.connected(); }
+
+  // Whether the last handshake resumed the previous session
+  bool resumed() const { return wasResumed; }
+
+  bool write(const uint8_t* data, size_t length) {
+    unsigned long start = millis();
+    while (open && length > 0) {
+      int result = mbedtls_ssl_write(&ssl, data, length);
+      if (result > 0) {
+        data += result;
+        length -= result;
+        continue;
+      }
+      if ((result != MBEDTLS_ERR_SSL_WANT_WRITE && result != MBEDTLS_ERR_SSL_WANT_READ) ||
+          millis() - start > UPSTREAM_RESPONSE_TIMEOUT) {
+        stop();
+        return false;
+      }
+      delay(1);
+    }
+    return open;
+  }
+
+  bool write(const String& text) { return write((const uint8_t*)text.c_str(), text.length()); }
+
+  // Bytes read, 0 while none are pending, or -1 once the connection is closed
+  int read(uint8_t* data, size_t length) {
+    if (!open) return -1;
+    int result = mbedtls_ssl_read(&ssl, data, length);
+    if (result > 0) return result;
+    if (result == MBEDTLS_ERR_SSL_WANT_READ || result == MBEDTLS_ERR_SSL_WANT_WRITE) return 0;
+#ifdef MBEDTLS_ERR_SSL_RECEIVED_NEW_SESSION_TICKET
+    if (result == MBEDTLS_ERR_SSL_RECEIVED_NEW_SESSION_TICKET) return 0;
+#endif
+    stop();
+    return -1;
+  }
+
+  // Close the connection and free its TLS buffers; the session is kept
+  void stop() {
+    if (open) {
+      mbedtls_ssl_close_notify(&ssl);
+      mbedtls_ssl_free(&ssl);
+      open = false;
+    }
+    tcp.stop();
+  }
+
+private:
+  bool configure() {
+    if (configured) return true;
+    mbedtls_ssl_config_init(&config);
+    mbedtls_ctr_drbg_init(&random);
+    mbedtls_entropy_init(&entropy);
+    configured = true;
+
+    if (mbedtls_ctr_drbg_seed(&random, mbedtls_entropy_func, &entropy, nullptr, 0) != 0 ||
+        mbedtls_ssl_config_defaults(&config, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                    MBEDTLS_SSL_PRESET_DEFAULT) != 0) {
+      mbedtls_ssl_config_free(&config);
+      mbedtls_ctr_drbg_free(&random);
+      mbedtls_entropy_free(&entropy);
+      configured = false;
+      return false;
+    }
+    mbedtls_ssl_conf_authmode(&config, MBEDTLS_SSL_VERIFY_NONE);  // Note: In production, use proper certificate validation
+    mbedtls_ssl_conf_rng(&config, mbedtls_ctr_drbg_random, &random);
+#ifdef MBEDTLS_SSL_SESSION_TICKETS
+    mbedtls_ssl_conf_session_tickets(&config, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+    return true;
+  }
+
+  void saveSession() {
+    mbedtls_ssl_session fresh;
+    mbedtls_ssl_session_init(&fresh);
+    if (mbedtls_ssl_get_session(&ssl, &fresh) != 0) {
+      mbedtls_ssl_session_free(&fresh);
+      forgetSession();
+      wasResumed = false;
+      return;
+    }
+
+    // A resumed session carries over the master secret; a full handshake
+    // derives a new one
+    wasResumed = hasSession &&
+      memcmp(UPSTREAM_SESSION_FIELD(fresh, master), UPSTREAM_SESSION_FIELD(session, master),
+             sizeof(UPSTREAM_SESSION_FIELD(session, master))) == 0;
+    mbedtls_ssl_session_free(&session);
+    session = fresh;  // takes over the ticket and certificate buffers
+    hasSession = true;
+  }
+
+  void forgetSession() {
+    mbedtls_ssl_session_free(&session);
+    mbedtls_ssl_session_init(&session);
+    hasSession = false;
+  }
+
+  static int sendCallback(void* context, const unsigned char* data, size_t length) {
+    WiFiClient* tcp = (WiFiClient*)context;
+    size_t written = tcp->write(data, length);
+    return written > 0 ? (int)written : MBEDTLS_ERR_NET_SEND_FAILED;
+  }
+
+  static int receiveCallback(void* context, unsigned char* data, size_t length) {
+    WiFiClient* tcp = (WiFiClient*)context;
+    int available = tcp->available();
+    if (available <= 0) return tcp->connected() ? MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_NET_CONN_RESET;
+    int received = tcp->read(data, min(length, (size_t)available));
+    return received > 0 ? received : MBEDTLS_ERR_SSL_WANT_READ;
+  }
+};
+
+// Timings of the last request; connect and handshake are 0 when it went
+// out on a kept-alive connection
+struct UpstreamTimings {
+  uint32_t connectMs;
+  uint32_t handshakeMs;
+  uint32_t firstByteMs;  // request sent until the status line arrived
+  uint32_t requestMs;    // request sent until the body was read
+  uint32_t waitUs;       // of that, time spent waiting for response bytes
+  bool reused;
+  bool resumed;
+};
+
+struct UpstreamStats {
+  uint32_t requests;
+  uint32_t failures;
+  uint32_t reused;             // requests sent on a kept-alive connection
+  uint32_t fullHandshakes;
+  uint32_t resumedHandshakes;
+  uint32_t retries;            // resent after a kept-alive connection was found closed
+  uint32_t idleCloses;
+  uint32_t handshakeMs;        // totals over all handshakes and requests
+  uint32_t requestMs;
+};
+
+// Buffered writer for a request. It fills the connection's buffer, which
+// is idle until the response arrives, and sends it a TLS record at a
+// time, so the JSON body is serialized straight to the socket. Matches
+// the ArduinoJson writer interface
+class UpstreamWriter {
+private:
+  TlsConnection& tls;
+  uint8_t* buffer;
+  size_t capacity;
+  size_t used = 0;
+  bool ok = true;
+
+public:
+  UpstreamWriter(TlsConnection& connection, uint8_t* writeBuffer, size_t size)
+    : tls(connection), buffer(writeBuffer), capacity(size) {}
+
+  size_t write(uint8_t c) {
+    if (used == capacity) flush();
+    buffer[used++] = c;
+    return 1;
+  }
+
+  size_t write(const uint8_t* data, size_t length) {
+    for (size_t left = length; left > 0;) {
+      if (used == capacity) flush();
+      size_t take = min(left, capacity - used);
+      memcpy(buffer + used, data, take);
+      used += take;
+      data += take;
+      left -= take;
+    }
+    return length;
+  }
+
+  size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+  size_t write(const String& text) { return write((const uint8_t*)text.c_str(), text.length()); }
+
+  // Send what is buffered; false once any write has failed
+  bool flush() {
+    if (used > 0 && ok) ok = tls.write(buffer, used);
+    used = 0;
+    return ok;
+  }
+};
+
+// One long-lived HTTP/1.1 connection to an upstream API. Responses are
+// read by Content-Length or chunked framing, so the connection stays open
+// for the next request; it is reopened, resuming the TLS session, when the
+// server closes it and closed after UPSTREAM_IDLE_TIMEOUT without use
+class UpstreamConnection {
+public:
+  // Response body with its framing removed. Pieces point into the
+  // connection's buffer, so the body is never held whole. Also an
+  // ArduinoJson reader, for parsing a reply as it is received
+  class Body {
+  private:
+    UpstreamConnection& connection;
+    int httpStatus;
+    size_t remaining = 0;  // of the Content-Length body or current chunk
+    bool chunked;
+    bool untilClose;       // no framing: the body ends when the server closes
+    bool chunkRead = false;
+    bool ended = false;
+    bool failed = false;
+
+  public:
+    Body(UpstreamConnection& owner, int status, long contentLength, bool isChunked)
+      : connection(owner), httpStatus(status), chunked(isChunked), untilClose(!isChunked && contentLength < 0) {
+      if (!chunked && !untilClose) {
+        remaining = contentLength;
+        ended = remaining == 0;
+      }
+    }
+
+    // HTTP status of the response this body belongs to
+    int status() const { return httpStatus; }
+
+    // The next piece of at most limit bytes, or nullptr once the body
+    // has ended or failed
+    const char* next(size_t& length, size_t limit = SIZE_MAX) {
+      if (ended || failed) return nullptr;
+      if (chunked && remaining == 0 && !nextChunk()) return nullptr;
+      if (!connection.fill()) {
+        if (untilClose) ended = true;
+        else failed = true;
+        return nullptr;
+      }
+
+      length = min(limit, connection.bufferEnd - connection.bufferStart);
+      if (!untilClose) length = min(length, remaining);
+      const char* piece = (const char*)connection.buffer + connection.bufferStart;
+      connection.bufferStart += length;
+      if (!untilClose) {
+        remaining -= length;
+        if (remaining == 0 && !chunked) ended = true;
+      }
+      return piece;
+    }
+
+    int read() {
+      size_t length;
+      const char* piece = next(length, 1);
+      return piece != nullptr ? (uint8_t)*piece : -1;
+    }
+
+    size_t readBytes(char* out, size_t length) {
+      size_t total = 0;
+      while (total < length) {
+        size_t take;
+        const char* piece = next(take, length - total);
+        if (piece == nullptr) break;
+        memcpy(out + total, piece, take);
+        total += take;
+      }
+      return total;
+    }
+
+    // Whether the whole body was read, not cut off by a closed connection
+    bool complete() const { return ended && !failed; }
+
+  private:
+    // Start the next chunk: the CRLF after the last one, then the size
+    // line. The last, empty chunk is followed by trailer lines up to the
+    // blank line that ends the message
+    bool nextChunk() {
+      String line;
+      if ((chunkRead && !connection.readLine(line)) || !connection.readLine(line)) {
+        failed = true;
+        return false;
+      }
+      chunkRead = true;
+      remaining = strtoul(line.c_str(), nullptr, 16);
+      if (remaining > 0) return true;
+
+      do {
+        if (!connection.readLine(line)) {
+          failed = true;
+          return false;
+        }
+      } while (line.length() > 0);
+      ended = true;
+      return false;
+    }
+  };
+
+private:
+  TlsConnection tls;
+  const char* host;
+  uint16_t port;
+  unsigned long lastUsed = 0;
+  uint8_t buffer[UPSTREAM_BUFFER_SIZE];  // the request going out, then the response
+  size_t bufferStart = 0;
+  size_t bufferEnd = 0;
+  UpstreamTimings timings = {};
+  UpstreamStats counters = {};
+
+public:
+  UpstreamConnection(const char* upstreamHost, uint16_t upstreamPort)
+    : host(upstreamHost), port(upstreamPort) {}
+
+  // POST a contentLength-byte body to path. headers holds extra header
+  // lines, each ending in CRLF. writeBody(UpstreamWriter&) writes the body
+  // and readBody(Body&) reads the response body; whatever it leaves unread
+  // is skipped. Returns the HTTP status, or 0 when no complete response
+  // was read. A retried request is written again, but only ever read once
+  template <typename BodyWriter, typename BodyReader>
+  int post(const char* path, const String& headers, size_t contentLength,
+           BodyWriter writeBody, BodyReader readBody) {
+    counters.requests++;
+    for (int attempt = 0; attempt < 2; attempt++) {
+      closeIfIdle();
+      timings = {};
+      timings.reused = tls.connected();
+      if (timings.reused) {
+        counters.reused++;
+      } else if (!open()) {
+        break;
+      }
+
+      bool received = false;
+      int status = exchange(path, headers, contentLength, writeBody, readBody, received);
+      if (status > 0) {
+        lastUsed = millis();
+        counters.requestMs += timings.requestMs;
+        return status;
+      }
+      tls.stop();
+
+      // A kept-alive connection the server has closed fails before any
+      // response arrives; the request is then sent again on a new one
+      if (!timings.reused || received) break;
+      counters.retries++;
+    }
+    counters.failures++;
+    return 0;
+  }
+
+  // Close the connection once it has been idle for UPSTREAM_IDLE_TIMEOUT
+  void closeIfIdle() {
+    if (tls.connected() && millis() - lastUsed > UPSTREAM_IDLE_TIMEOUT) {
+      tls.stop();
+      counters.idleCloses++;
+    }
+  }
+
+  void close() { tls.stop(); }
+
+  const UpstreamTimings& lastTimings() const { return timings; }
+  const UpstreamStats& stats() const { return counters; }
+
+private:
+  bool open() {
+    PROFILE_ZONE("api.connect");
+    if (!tls.connect(host, port, timings.connectMs, timings.handshakeMs)) return false;
+    timings.resumed = tls.resumed();
+    if (timings.resumed) counters.resumedHandshakes++;
+    else counters.fullHandshakes++;
+    counters.handshakeMs += timings.handshakeMs;
+    return true;
+  }
+
+  template <typename BodyWriter, typename BodyReader>
+  int exchange(const char* path, const String& headers, size_t requestLength,
+               BodyWriter& writeBody, BodyReader& readBody, bool& received) {
+    unsigned long start = millis();
+    bufferStart = bufferEnd = 0;
+    String line;
+    {
+      PROFILE_ZONE("api.first_byte");
+      UpstreamWriter out(tls, buffer, sizeof(buffer));
+      out.write("POST ");
+      out.write(path);
+      out.write(" HTTP/1.1\r\nHost: ");
+      out.write(host);
+      out.write("\r\n");
+      out.write(headers);
+      out.write("Content-Length: ");
+      out.write(String((unsigned long)requestLength));
+      out.write("\r\nConnection: keep-alive\r\n\r\n");
+      writeBody(out);
+      if (!out.flush()) return 0;
+
+      // Status line, e.g. "HTTP/1.1 200 OK"
+      if (!readLine(line)) return 0;
+    }
+    received = true;
+    timings.firstByteMs = millis() - start;
+    int space = line.indexOf(' ');
+    int status = space > 0 ? line.substring(space + 1).toInt() : 0;
+    if (status <= 0) return 0;
+    bool keepAlive = line.startsWith("HTTP/1.1");
+
+    long contentLength = -1;
+    bool chunked = false;
+    for (;;) {
+      if (!readLine(line)) return 0;
+      if (line.length() == 0) break;
+
+      int colon = line.indexOf(':');
+      if (colon < 0) continue;
+      String name = line.substring(0, colon);
+      String value = line.substring(colon + 1);
+      name.toLowerCase();
+      value.toLowerCase();
+      value.trim();
+      if (name == "content-length") {
+        contentLength = value.toInt();
+      } else if (name == "transfer-encoding") {
+        chunked = value.indexOf("chunked") >= 0;
+      } else if (name == "connection") {
+        if (value.indexOf("close") >= 0) keepAlive = false;
+        else if (value.indexOf("keep-alive") >= 0) keepAlive = true;
+      }
+    }
+
+    // Without framing the body runs until the server closes
+    Body body(*this, status, contentLength, chunked);
+    if (!chunked && contentLength < 0) keepAlive = false;
+    {
+      PROFILE_ZONE("api.body_read");
+      readBody(body);
+      size_t skipped;
+      while (body.next(skipped) != nullptr) {}
+    }
+    timings.requestMs = millis() - start;
+    if (!body.complete()) return 0;
+
+    if (!keepAlive) tls.stop();
+    return status;
+  }
+
+  // Wait for more response bytes when the buffer is empty
+  bool fill() {
+    if (bufferStart < bufferEnd) return true;
+    unsigned long start = millis();
+    unsigned long waitStart = micros();
+    for (;;) {
+      int received = tls.read(buffer, sizeof(buffer));
+      if (received > 0) {
+        bufferStart = 0;
+        bufferEnd = received;
+        timings.waitUs += micros() - waitStart;
+        return true;
+      }
+      if (received < 0 || millis() - start > UPSTREAM_RESPONSE_TIMEOUT) return false;
+      delay(1);
+    }
+  }
+
+  // One line without its CRLF
+  bool readLine(String& line) {
+    line = "";
+    for (;;) {
+      if (!fill()) return false;
+      const uint8_t* start = buffer + bufferStart;
+      const uint8_t* newline = (const uint8_t*)memchr(start, '\n', bufferEnd - bufferStart);
+      size_t take = newline != nullptr ? newline - start : bufferEnd - bufferStart;
+      line.concat((const char*)start, take);
+      bufferStart += take;
+      if (newline != nullptr) {
+        bufferStart++;
+        if (line.endsWith("\r")) line.remove(line.length() - 1);
+        return true;
+      }
+      if (line.length() > UPSTREAM_MAX_LINE) return false;
+    }
+  }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,318 @@
+// Generated by tools/web_compile.py from web/index.html, web/style.css, web/app.js. Do not edit.
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include "static_assets.h"
+
+// index.html: 468 bytes gzipped
+constexpr uint8_t webAssetIndexHtml[] = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0x6d, 0x93, 0xc1, 0x6e, 0xdb, 0x30,
+  0x0c, 0x86, 0xef, 0x7d, 0x0a, 0x4d, 0x03, 0x86, 0x16, 0x98, 0xe3, 0x35, 0xd9, 0xd2, 0x06, 0x95,
+  0x33, 0x04, 0x5b, 0x0f, 0x39, 0x35, 0x40, 0x7b, 0xd9, 0x91, 0x96, 0xe8, 0x4a, 0x8d, 0x22, 0x79,
+  0x12, 0x93, 0xcc, 0x6f, 0x3f, 0x59, 0x71, 0x0a, 0xa3, 0xed, 0xc9, 0x32, 0xf9, 0xf3, 0x23, 0x25,
+  0xfd, 0x12, 0x9f, 0x7e, 0x3f, 0xfc, 0x7a, 0xfa, 0xb3, 0xb9, 0x67, 0x9a, 0x76, 0x76, 0x79, 0x21,
+  0xce, 0x1f, 0x04, 0xb5, 0xbc, 0x60, 0x4c, 0x90, 0x21, 0x8b, 0xcb, 0xfb, 0xc7, 0xcd, 0x6c, 0xca,
+  0x56, 0x6b, 0xb6, 0x8a, 0xd1, 0x44, 0x02, 0x47, 0xa2, 0x3c, 0x65, 0x7a, 0xcd, 0x0e, 0x09, 0x98,
+  0x83, 0x1d, 0x56, 0xfc, 0x60, 0xf0, 0xd8, 0xfa, 0x40, 0x9c, 0x49, 0xef, 0x08, 0x1d, 0x55, 0xfc,
+  0x68, 0x14, 0xe9, 0x4a, 0xe1, 0xc1, 0x48, 0x2c, 0xf2, 0xcf, 0x57, 0x66, 0x9c, 0x21, 0x03, 0xb6,
+  0x88, 0x12, 0x2c, 0x56, 0xd7, 0x3c, 0x63, 0xac, 0x71, 0x5b, 0x16, 0xd0, 0x56, 0x3c, 0x52, 0x67,
+  0x31, 0x6a, 0xc4, 0xc4, 0xd1, 0x01, 0x9b, 0x8a, 0x97, 0x39, 0x34, 0x91, 0x31, 0xfe, 0x3c, 0x54,
+  0x53, 0x59, 0x4f, 0x15, 0xcc, 0x16, 0xb5, 0xc4, 0xc5, 0xed, 0xcd, 0x6c, 0x9e, 0xca, 0x45, 0x79,
+  0x9a, 0x58, 0xd4, 0x5e, 0x75, 0x99, 0xa6, 0xcc, 0x81, 0x49, 0x0b, 0x31, 0x56, 0xbc, 0x1f, 0x05,
+  0x8c, 0xc3, 0x90, 0xfb, 0xa4, 0x9c, 0xbe, 0xfe, 0x70, 0x47, 0x29, 0x7c, 0xca, 0x8f, 0x6b, 0x35,
+  0x50, 0xf1, 0x16, 0x30, 0x48, 0x8c, 0x1a, 0xf2, 0x3a, 0x11, 0x7c, 0xe8, 0xf8, 0x52, 0x94, 0x29,
+  0xfe, 0x4e, 0x63, 0x3d, 0x28, 0xe3, 0x9e, 0xf9, 0x99, 0xa9, 0x8d, 0x52, 0xe8, 0x5e, 0x59, 0x8c,
+  0x3d, 0xe9, 0xb4, 0xf5, 0xa4, 0x10, 0xb1, 0x05, 0x77, 0x56, 0x0d, 0x55, 0x85, 0xf2, 0x14, 0x7b,
+  0x72, 0x9f, 0x7b, 0x45, 0xbf, 0xeb, 0x33, 0x14, 0x19, 0xd7, 0xee, 0xa9, 0x80, 0x80, 0x30, 0xc2,
+  0x8b, 0x1c, 0xcd, 0xa3, 0xfc, 0xdd, 0x63, 0x24, 0xe3, 0x1d, 0x67, 0xd4, 0xb5, 0xe9, 0xbe, 0x08,
+  0xff, 0xa5, 0x33, 0x6e, 0x2d, 0x48, 0xd4, 0xde, 0x2a, 0x0c, 0x15, 0x5f, 0xc5, 0x2d, 0xdb, 0x21,
+  0x03, 0xd7, 0x51, 0x1a, 0xeb, 0x79, 0x32, 0x99, 0x70, 0x56, 0x8e, 0x60, 0xf5, 0x9e, 0xc8, 0xbb,
+  0x4c, 0x8b, 0xe8, 0x54, 0x51, 0x53, 0xa2, 0x79, 0x27, 0xad, 0x91, 0xdb, 0x8a, 0x43, 0xdc, 0x5e,
+  0x5e, 0xf1, 0xe5, 0x63, 0xca, 0x88, 0xf2, 0x24, 0xfd, 0x60, 0xe8, 0xf1, 0x72, 0x34, 0x7d, 0xe3,
+  0x3d, 0x8d, 0x0e, 0x79, 0xe3, 0x8f, 0x18, 0x50, 0xb1, 0xba, 0x63, 0x02, 0x06, 0x23, 0x7c, 0x1e,
+  0xf5, 0x8a, 0xda, 0x1f, 0xd7, 0xae, 0xf1, 0x97, 0x57, 0x77, 0xc9, 0x37, 0xb4, 0x0f, 0x8e, 0x35,
+  0x60, 0x23, 0xde, 0xf1, 0xe1, 0x7a, 0xbf, 0xb0, 0x87, 0x16, 0xdd, 0x6a, 0x2d, 0x4a, 0x78, 0xd3,
+  0x77, 0x58, 0xf4, 0xab, 0x28, 0x83, 0x69, 0x89, 0xc5, 0x20, 0x93, 0xcd, 0xa0, 0x6d, 0x27, 0x2f,
+  0xbd, 0xc7, 0xbe, 0xe1, 0x62, 0x8e, 0x4a, 0x49, 0x35, 0xbf, 0xfd, 0x21, 0xbf, 0x43, 0x93, 0x6f,
+  0x20, 0x2b, 0x7b, 0xb3, 0x9d, 0x5c, 0x96, 0x1c, 0x93, 0x5f, 0xcb, 0x7f, 0xbd, 0x18, 0xcd, 0x54,
+  0x45, 0x03, 0x00, 0x00,
+};
+
+// style.css: 1686 bytes gzipped
+constexpr uint8_t webAssetStyleCss[] = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xad, 0x58, 0x59, 0x6f, 0xe3, 0x36,
+  0x10, 0x7e, 0xcf, 0xaf, 0x20, 0x10, 0x2c, 0x12, 0x2f, 0x2c, 0xaf, 0x24, 0x5f, 0xb2, 0xf7, 0xa5,
+  0xdb, 0x05, 0xb6, 0x0d, 0xd0, 0x7d, 0xda, 0xb6, 0x40, 0x1f, 0x29, 0x89, 0xb2, 0xb4, 0x91, 0x48,
+  0x97, 0xa4, 0x72, 0x34, 0xd8, 0xff, 0xde, 0xe1, 0x65, 0x51, 0x87, 0x13, 0x17, 0x68, 0xec, 0xc0,
+  0x36, 0x67, 0x86, 0x9c, 0xe3, 0xe3, 0xc7, 0xa1, 0x3e, 0xbc, 0x47, 0x5f, 0x59, 0x4e, 0x38, 0x45,
+  0x9f, 0x59, 0xcd, 0x38, 0xfa, 0x96, 0x95, 0xa4, 0x21, 0xe8, 0xfd, 0x87, 0xab, 0x3d, 0x67, 0x4c,
+  0xa2, 0x97, 0x2b, 0x84, 0x82, 0xe0, 0xc8, 0xab, 0x06, 0xf3, 0xe7, 0x20, 0x53, 0x3a, 0x7b, 0x74,
+  0xbd, 0x89, 0xc3, 0x90, 0x90, 0x8f, 0x3d, 0x59, 0x8e, 0xf9, 0x3d, 0x88, 0x96, 0xdb, 0x30, 0x4c,
+  0x97, 0x7d, 0x51, 0x5d, 0x1d, 0x4a, 0x09, 0xb2, 0x34, 0x4d, 0x36, 0x45, 0x66, 0x64, 0x82, 0x64,
+  0x8c, 0xe6, 0xfe, 0xa4, 0xe1, 0x32, 0xc7, 0xd9, 0x66, 0x28, 0xb5, 0xd3, 0x86, 0x51, 0xb2, 0x4d,
+  0xac, 0x30, 0xc5, 0xd9, 0xfd, 0x81, 0xb3, 0x96, 0xe6, 0x20, 0x88, 0x62, 0xf5, 0xb2, 0x56, 0x2d,
+  0x2f, 0x70, 0x46, 0xd4, 0x28, 0x51, 0x2f, 0x33, 0x4a, 0x38, 0xd7, 0xf3, 0x67, 0xc5, 0x66, 0xb3,
+  0xdd, 0x99, 0x31, 0x46, 0x9d, 0x73, 0x20, 0x28, 0xf4, 0xdf, 0x49, 0x70, 0x5a, 0x5b, 0x2d, 0xab,
+  0xff, 0x4e, 0xa2, 0xde, 0xca, 0x43, 0xb3, 0xd3, 0xe2, 0x03, 0x81, 0x5b, 0xdf, 0x9f, 0x2b, 0x83,
+  0x9c, 0xf7, 0x67, 0x8b, 0x73, 0xf5, 0xf2, 0xa4, 0x05, 0xe3, 0xa4, 0x5b, 0x2b, 0x81, 0x57, 0xec,
+  0x49, 0x33, 0xd6, 0x34, 0x84, 0x4a, 0x5d, 0x8b, 0x6d, 0x8c, 0x57, 0x9e, 0xe8, 0x9e, 0x3c, 0x3f,
+  0x32, 0x6e, 0x3c, 0xdc, 0xee, 0x5c, 0x46, 0xcd, 0x9c, 0x2d, 0xcd, 0x64, 0xc5, 0x28, 0xc8, 0xd6,
+  0x61, 0x81, 0xb7, 0xa9, 0x27, 0x13, 0x92, 0x57, 0xf4, 0xa0, 0xac, 0xa2, 0x02, 0x27, 0x99, 0x27,
+  0xa1, 0x6d, 0x93, 0x12, 0x15, 0x41, 0x9a, 0xef, 0x96, 0xc5, 0xce, 0x93, 0xb0, 0x23, 0xe1, 0x58,
+  0xea, 0xe8, 0x46, 0x6b, 0x65, 0x35, 0x16, 0x02, 0x04, 0x49, 0x4a, 0x76, 0x85, 0x1f, 0xd8, 0x03,
+  0xe6, 0x15, 0x4e, 0x6b, 0xe2, 0x85, 0xf5, 0xe3, 0xea, 0xea, 0xc3, 0x7b, 0xf4, 0x33, 0x16, 0x04,
+  0x7d, 0x93, 0xcf, 0x35, 0x11, 0x0a, 0x80, 0x29, 0xcb, 0x9f, 0x35, 0xfe, 0x0a, 0x46, 0x65, 0x50,
+  0xe0, 0xa6, 0xaa, 0xa1, 0x24, 0x37, 0xdf, 0xc8, 0x81, 0x11, 0xf4, 0xc7, 0xdd, 0xcd, 0x1c, 0xfd,
+  0x8e, 0x4b, 0xd6, 0xe0, 0x39, 0xfa, 0x85, 0x50, 0xf2, 0x00, 0x9f, 0x7f, 0x12, 0x9e, 0x63, 0x0a,
+  0x5f, 0x04, 0xa6, 0x02, 0xea, 0xc8, 0x2b, 0x5d, 0x85, 0x2e, 0xcf, 0x0e, 0x6b, 0xe0, 0xc2, 0xad,
+  0x8f, 0xa3, 0x99, 0x52, 0x03, 0x34, 0x1c, 0x2a, 0x48, 0x8d, 0x2e, 0xd1, 0x11, 0xe7, 0xb9, 0x4e,
+  0x47, 0x1c, 0x1e, 0x9f, 0xd4, 0x40, 0xcf, 0xb2, 0x07, 0x05, 0x6d, 0x5c, 0x57, 0x94, 0x04, 0x25,
+  0x31, 0x40, 0x8f, 0x16, 0x1b, 0x1d, 0xd3, 0x02, 0x80, 0x24, 0x31, 0x48, 0xb8, 0x8e, 0xa3, 0xc1,
+  0x4f, 0xc1, 0x63, 0x95, 0xcb, 0x72, 0x8f, 0x76, 0xa1, 0x9d, 0xf6, 0xb4, 0x28, 0xc2, 0xad, 0x64,
+  0x7d, 0x6f, 0xdd, 0x6a, 0x16, 0x59, 0x7a, 0x9d, 0x14, 0x2a, 0x4b, 0x78, 0xc0, 0x71, 0x5e, 0xb5,
+  0x90, 0xdd, 0x28, 0x36, 0xd3, 0xa4, 0xec, 0x29, 0x10, 0x25, 0xce, 0xd9, 0xa3, 0x9a, 0x6a, 0x75,
+  0x7c, 0xd2, 0x7e, 0x23, 0x7e, 0x48, 0xf1, 0x6d, 0x38, 0xd7, 0xaf, 0xc5, 0x72, 0xd6, 0x0f, 0x6c,
+  0x65, 0x4c, 0xd9, 0x03, 0xe1, 0x45, 0xad, 0x0c, 0xcb, 0x2a, 0xcf, 0x09, 0xd5, 0x9e, 0x97, 0x91,
+  0xf6, 0xb8, 0x17, 0x74, 0x6f, 0x37, 0xeb, 0xb9, 0x24, 0x79, 0x92, 0x01, 0x86, 0xdf, 0x10, 0x40,
+  0x06, 0x68, 0x24, 0xbc, 0x0b, 0x29, 0x48, 0x99, 0x94, 0xac, 0xe9, 0xd6, 0xd1, 0x55, 0x7c, 0xb4,
+  0x19, 0xda, 0x98, 0x8d, 0x50, 0x13, 0x09, 0x46, 0x81, 0x38, 0xe2, 0x4c, 0xfb, 0x14, 0x2e, 0xd6,
+  0x4a, 0xd9, 0xc0, 0xe1, 0x73, 0x89, 0x25, 0xb0, 0x92, 0xcb, 0x20, 0x20, 0x62, 0x91, 0xc1, 0x50,
+  0xd0, 0x4f, 0xaa, 0x49, 0x08, 0x64, 0x02, 0xc2, 0x15, 0xac, 0xae, 0x72, 0x13, 0x74, 0xbc, 0x5e,
+  0xcf, 0xdd, 0x7f, 0xb8, 0x88, 0x5e, 0xcb, 0xdd, 0x38, 0x01, 0x08, 0xe5, 0x95, 0x38, 0xd6, 0x18,
+  0xe0, 0x56, 0xd4, 0xc4, 0x78, 0x0f, 0x9f, 0x41, 0x5e, 0x71, 0x62, 0xf7, 0x0f, 0x64, 0xa6, 0x6d,
+  0xb4, 0xaa, 0x2b, 0xfa, 0x36, 0x7c, 0x28, 0xa7, 0xd1, 0xa6, 0x1d, 0x5a, 0x86, 0x73, 0xf3, 0x0e,
+  0x17, 0xdb, 0x99, 0x0e, 0xf1, 0x5a, 0x47, 0x53, 0x56, 0x02, 0x36, 0x90, 0x05, 0xba, 0x5a, 0x04,
+  0x6c, 0xc1, 0x95, 0xc8, 0xf7, 0x2c, 0x00, 0x47, 0x1c, 0x3c, 0x46, 0xc0, 0x3c, 0x87, 0x6e, 0x1f,
+  0x35, 0x22, 0xe3, 0xac, 0xae, 0x53, 0xcc, 0x1d, 0xfe, 0x64, 0x59, 0xd1, 0xbe, 0x60, 0xb2, 0xd4,
+  0x7a, 0x70, 0x36, 0x9a, 0x70, 0xe8, 0xfc, 0x7e, 0x0f, 0x85, 0x4d, 0xef, 0x2b, 0x19, 0x9c, 0xe6,
+  0xd3, 0xf1, 0xd8, 0xc5, 0x12, 0x5b, 0xd3, 0xb7, 0x6c, 0x02, 0xc9, 0x21, 0x16, 0x53, 0xd5, 0x57,
+  0x36, 0xc1, 0x45, 0x33, 0x95, 0xc0, 0x59, 0x83, 0x99, 0x5e, 0x0b, 0x71, 0x02, 0x1e, 0xab, 0x0e,
+  0x89, 0x77, 0xf4, 0xd8, 0x4a, 0xf4, 0x89, 0x13, 0xac, 0x51, 0x58, 0xa9, 0x9f, 0x01, 0x56, 0x3f,
+  0x5f, 0xa6, 0xb0, 0x72, 0x2a, 0x51, 0xb4, 0x39, 0x57, 0x22, 0x0d, 0x89, 0x55, 0x38, 0x37, 0xef,
+  0x70, 0xb1, 0xf3, 0x3d, 0x90, 0xec, 0x78, 0x01, 0x9e, 0x55, 0x1a, 0xfe, 0x6e, 0x89, 0x50, 0x78,
+  0x9c, 0x44, 0x4f, 0xe7, 0x06, 0x00, 0xbd, 0xf3, 0xe5, 0x92, 0xfd, 0x12, 0x4f, 0x25, 0x24, 0xf1,
+  0xf6, 0xb1, 0xa8, 0xfe, 0x21, 0x6f, 0xc6, 0xe7, 0x41, 0x3e, 0x99, 0x5d, 0xc0, 0xa1, 0x50, 0x7e,
+  0x2a, 0x2a, 0xb3, 0xbf, 0x70, 0x5d, 0x03, 0x1b, 0x2c, 0x05, 0x22, 0x70, 0x28, 0xf4, 0x83, 0xdd,
+  0x17, 0x2c, 0x6b, 0x85, 0x0e, 0x99, 0xb5, 0x52, 0x11, 0xef, 0x1e, 0x51, 0x46, 0x89, 0xe7, 0xf2,
+  0x1b, 0xbc, 0xd5, 0x67, 0x4b, 0xf5, 0x8a, 0x1d, 0x59, 0x42, 0x9b, 0x31, 0x8f, 0x96, 0x2b, 0xc8,
+  0x43, 0x6c, 0x29, 0x53, 0x2d, 0x2d, 0x08, 0x84, 0x96, 0x4a, 0xfa, 0x1f, 0x11, 0x35, 0x8c, 0xd7,
+  0x6a, 0xcc, 0xfc, 0x3a, 0x0c, 0x3c, 0x1f, 0x24, 0xbb, 0x5f, 0x43, 0x47, 0xa5, 0x96, 0x61, 0x6b,
+  0x52, 0xc8, 0x8e, 0xc6, 0xb2, 0x96, 0x0b, 0xb5, 0xda, 0x91, 0x55, 0x8e, 0x89, 0x27, 0x4a, 0xd5,
+  0x63, 0xe1, 0xb5, 0x61, 0xe1, 0x71, 0xde, 0x63, 0x3f, 0xef, 0x2e, 0xf8, 0x7d, 0xa9, 0xf8, 0xe8,
+  0xa2, 0x14, 0xa8, 0xa6, 0xad, 0x2b, 0x29, 0x74, 0x32, 0x70, 0x0e, 0xe8, 0xaf, 0x35, 0x96, 0xe4,
+  0xaf, 0xdb, 0x00, 0x5c, 0x9e, 0x4d, 0x1f, 0x5b, 0xc9, 0xf0, 0xd4, 0x8a, 0x07, 0x25, 0xd8, 0xc3,
+  0x76, 0x53, 0xdd, 0x43, 0x7e, 0xc6, 0x11, 0x6d, 0xbc, 0x4b, 0xe6, 0x28, 0x9c, 0xa3, 0x78, 0xa9,
+  0x3e, 0xed, 0xc1, 0xe7, 0xf2, 0x43, 0x99, 0x3a, 0xb3, 0x80, 0x55, 0x49, 0x3e, 0xf0, 0xb0, 0x2b,
+  0x45, 0xe7, 0x95, 0x19, 0xf3, 0x0e, 0xa4, 0xaf, 0x44, 0x08, 0x7c, 0x30, 0x1d, 0x8a, 0x39, 0x8f,
+  0xe0, 0xe0, 0xb3, 0xfc, 0x3d, 0x3c, 0xf9, 0x2c, 0x43, 0x8f, 0x08, 0x02, 0x53, 0x48, 0x93, 0xc9,
+  0x77, 0x81, 0x73, 0x72, 0x47, 0x07, 0x50, 0xff, 0x09, 0x5a, 0xb8, 0x82, 0xe3, 0x06, 0x56, 0xb1,
+  0x72, 0xbd, 0xbf, 0x39, 0x6b, 0xd0, 0x0b, 0x62, 0xea, 0xb0, 0x94, 0xcf, 0xaa, 0x4f, 0x39, 0x93,
+  0xde, 0x28, 0x54, 0xe9, 0x45, 0x3f, 0x54, 0x74, 0xcc, 0xb7, 0x88, 0xce, 0x59, 0x84, 0x5a, 0x5d,
+  0x77, 0x2c, 0xa7, 0x88, 0x16, 0xad, 0xb0, 0xd5, 0xfe, 0xde, 0xc2, 0xbe, 0x2b, 0x9e, 0xf5, 0xc1,
+  0xab, 0x7b, 0x4e, 0xcd, 0x34, 0x50, 0x8f, 0x8f, 0x43, 0x13, 0xe8, 0xf8, 0x80, 0x93, 0x31, 0x95,
+  0xaf, 0xd8, 0x81, 0x9c, 0xcb, 0x91, 0xa5, 0x78, 0x16, 0x92, 0x34, 0xd3, 0x66, 0xae, 0xb5, 0x38,
+  0x99, 0xa4, 0x6d, 0x0a, 0x08, 0x18, 0xf6, 0x54, 0xc9, 0xfa, 0xdd, 0x04, 0xed, 0x25, 0x3e, 0xed,
+  0x75, 0x67, 0x7f, 0x32, 0xd5, 0x37, 0x69, 0x83, 0x51, 0xdf, 0x14, 0xad, 0x35, 0x7e, 0x54, 0x4f,
+  0x1d, 0x3c, 0x72, 0x0c, 0xdc, 0x9c, 0x02, 0xf5, 0xdf, 0x07, 0x6a, 0x60, 0xa2, 0xf5, 0x5b, 0x1b,
+  0x47, 0x75, 0xf6, 0x46, 0xee, 0xfe, 0x9f, 0xdc, 0x61, 0x71, 0x16, 0x70, 0xb5, 0xf2, 0xe8, 0xd8,
+  0xf2, 0x6a, 0x71, 0x81, 0x17, 0x3a, 0xe0, 0x4d, 0x38, 0x37, 0x6f, 0x77, 0x1e, 0x0d, 0x7d, 0x98,
+  0x68, 0x44, 0xad, 0x0f, 0x8a, 0x8a, 0xc6, 0x2e, 0xd8, 0xa2, 0x5e, 0x9c, 0x05, 0x7d, 0x53, 0x9a,
+  0x5c, 0xb9, 0x93, 0xf8, 0x9c, 0xb6, 0x1a, 0x90, 0xa4, 0x22, 0x8f, 0xae, 0x23, 0x1e, 0xf3, 0xa9,
+  0xdd, 0xc6, 0x70, 0x09, 0x41, 0xbf, 0x42, 0xd2, 0xf4, 0x81, 0x00, 0x86, 0x6a, 0x2b, 0x1f, 0xf9,
+  0xeb, 0xae, 0x0d, 0x2e, 0x6c, 0xb3, 0x0b, 0x29, 0xbb, 0xd7, 0xc5, 0x3d, 0x75, 0x5d, 0x9c, 0x6b,
+  0xfb, 0x35, 0xda, 0x42, 0xed, 0x99, 0x5a, 0x61, 0xe2, 0xba, 0xf3, 0xa5, 0xe2, 0x58, 0xbb, 0x0c,
+  0xf7, 0x1d, 0x68, 0x86, 0xe1, 0xc8, 0xc6, 0x62, 0x0e, 0x77, 0x76, 0x8a, 0x33, 0x36, 0x47, 0x37,
+  0x9f, 0xe0, 0xa6, 0x0a, 0x59, 0x85, 0xdf, 0x0c, 0x14, 0x1a, 0xf8, 0x50, 0xcd, 0x34, 0x19, 0xe5,
+  0x70, 0x70, 0xa5, 0x3c, 0x97, 0xca, 0x31, 0x96, 0x81, 0x43, 0x70, 0x6a, 0xb5, 0x62, 0x77, 0xab,
+  0xc9, 0x95, 0x12, 0x30, 0x13, 0x7f, 0x0d, 0x4e, 0x67, 0xee, 0x1d, 0x9b, 0x71, 0x91, 0xa0, 0xe1,
+  0xe9, 0x23, 0x28, 0x19, 0x89, 0xfb, 0x20, 0x9f, 0x68, 0x45, 0xe2, 0xde, 0x35, 0xed, 0x3a, 0xcb,
+  0xb2, 0x49, 0xea, 0x1d, 0x91, 0x8b, 0x4e, 0x57, 0x90, 0x12, 0xf9, 0x48, 0x4c, 0xeb, 0xaf, 0xef,
+  0x33, 0x41, 0x05, 0xc0, 0x15, 0x13, 0xb7, 0x1a, 0xd3, 0x9b, 0xf5, 0x2e, 0x6f, 0x27, 0xbe, 0x0f,
+  0xcc, 0xb8, 0x4a, 0x51, 0x8d, 0xe9, 0xa1, 0x85, 0x63, 0x22, 0xf8, 0x8e, 0x1f, 0x30, 0xb4, 0xa5,
+  0xd5, 0x11, 0x28, 0xf1, 0x8d, 0x8a, 0x00, 0x03, 0x2f, 0x24, 0xbb, 0x27, 0x74, 0x61, 0x2f, 0xf7,
+  0x93, 0x16, 0x56, 0xe6, 0xab, 0xdb, 0x0b, 0xff, 0xa4, 0xba, 0x95, 0xf9, 0xea, 0xee, 0x21, 0xc0,
+  0xb4, 0x43, 0x56, 0xe8, 0x1b, 0x98, 0x27, 0x03, 0x93, 0xea, 0x46, 0xe4, 0x2b, 0x9b, 0x87, 0x05,
+  0x93, 0xca, 0x46, 0xe4, 0x2b, 0xbb, 0xe7, 0x07, 0x93, 0xea, 0x4e, 0xd8, 0xcb, 0x8c, 0x7a, 0xa8,
+  0x10, 0x50, 0x38, 0x1a, 0xa7, 0x93, 0xa3, 0xc4, 0xbe, 0xbe, 0x7b, 0xd6, 0x30, 0xa9, 0xed, 0x84,
+  0xda, 0x40, 0x31, 0xc3, 0x6f, 0x0c, 0x2b, 0x8c, 0x42, 0xbf, 0x9f, 0x57, 0x99, 0xf6, 0x0b, 0x98,
+  0xe1, 0xba, 0xb6, 0xa3, 0x2f, 0x67, 0x6f, 0xbc, 0xa3, 0x86, 0xff, 0x8d, 0xfe, 0x73, 0xdc, 0x84,
+  0x69, 0xcc, 0x98, 0x75, 0x82, 0x9c, 0x49, 0xb1, 0xc7, 0x85, 0xb4, 0xbb, 0xeb, 0x84, 0xd4, 0x9b,
+  0xc5, 0xcd, 0xa0, 0x79, 0x50, 0x9a, 0x6a, 0x97, 0x0a, 0x04, 0x3c, 0x7b, 0x14, 0xb7, 0xeb, 0x39,
+  0x82, 0x53, 0x79, 0x86, 0x2a, 0x5a, 0x54, 0x14, 0x10, 0x3c, 0x6c, 0x26, 0xb4, 0xbe, 0x9a, 0x33,
+  0x7c, 0x07, 0xcd, 0x51, 0xf8, 0x4e, 0x67, 0xc5, 0x9b, 0x5d, 0xb7, 0x0c, 0xab, 0xe1, 0xb8, 0x13,
+  0x6c, 0x46, 0x02, 0x27, 0x49, 0xd4, 0x7c, 0x51, 0x38, 0x90, 0xdf, 0xb8, 0x9e, 0xc2, 0x5c, 0xab,
+  0xfb, 0x77, 0x25, 0xbf, 0xaf, 0xfa, 0xc2, 0x98, 0xb4, 0x17, 0xfc, 0xc2, 0x7c, 0x7d, 0x79, 0xeb,
+  0xe1, 0x82, 0xde, 0x86, 0xbd, 0x27, 0x0b, 0x7d, 0x1e, 0xf3, 0x79, 0xa8, 0x7f, 0xb5, 0x59, 0x9b,
+  0x7e, 0xd2, 0xad, 0x84, 0x2f, 0x7e, 0xce, 0x91, 0x93, 0x8c, 0x71, 0x9b, 0xf8, 0x93, 0xf7, 0xa7,
+  0x69, 0xbc, 0xe6, 0x78, 0xa4, 0x0d, 0xbb, 0x9b, 0x70, 0xc5, 0xac, 0xca, 0xe4, 0x5f, 0xd4, 0x45,
+  0xfe, 0x6c, 0x71, 0x15, 0x00, 0x00,
+};
+
+// app.js: 2472 bytes gzipped
+constexpr uint8_t webAssetAppJs[] = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xad, 0x19, 0x6b, 0x53, 0xdb, 0xca,
+  0xf5, 0xbb, 0x7f, 0xc5, 0xe2, 0x32, 0x91, 0x04, 0xb6, 0x4c, 0x92, 0xf6, 0x43, 0x70, 0x80, 0x71,
+  0x80, 0x3b, 0x30, 0xe1, 0x26, 0x99, 0xc0, 0x6d, 0x3b, 0x8d, 0x53, 0xbc, 0x96, 0xd6, 0xb6, 0x82,
+  0x5e, 0xd9, 0x5d, 0x01, 0xbe, 0xc8, 0xff, 0xbd, 0xe7, 0xec, 0x43, 0x0f, 0xf3, 0x0a, 0x6d, 0x33,
+  0xc4, 0x96, 0x76, 0xcf, 0x9e, 0xf7, 0x73, 0x3d, 0x18, 0x90, 0x8f, 0x8c, 0xe5, 0x24, 0x58, 0x50,
+  0x49, 0x16, 0x91, 0x90, 0x19, 0x5f, 0x76, 0x62, 0x26, 0xd5, 0xc2, 0x89, 0x7e, 0x27, 0x7b, 0xe4,
+  0xdb, 0xf7, 0x61, 0x27, 0xc8, 0x52, 0x21, 0xc9, 0x97, 0xcf, 0x67, 0x67, 0x97, 0xa7, 0x9f, 0x2e,
+  0x8e, 0xbf, 0xfe, 0x7d, 0x74, 0x76, 0xf9, 0xfb, 0x39, 0x6c, 0xbe, 0xde, 0xd9, 0x19, 0x12, 0x32,
+  0x18, 0x90, 0x9b, 0x45, 0x14, 0x33, 0x42, 0x53, 0xf8, 0x13, 0x37, 0x8c, 0x93, 0x48, 0x90, 0x29,
+  0x8b, 0xd2, 0x39, 0x99, 0xb3, 0x94, 0x71, 0x2a, 0x59, 0xd8, 0xe9, 0x00, 0xd8, 0x19, 0x4d, 0xe7,
+  0x05, 0x9d, 0x33, 0x12, 0x32, 0xc9, 0x02, 0x19, 0x65, 0x29, 0xc9, 0xa9, 0x94, 0x8c, 0xa7, 0xc2,
+  0x10, 0x09, 0xb2, 0x90, 0x7d, 0x31, 0x4b, 0x40, 0xe0, 0xae, 0x43, 0xc8, 0x0f, 0x7a, 0x4d, 0x45,
+  0xc0, 0xa3, 0x5c, 0xee, 0x92, 0xc1, 0x64, 0x32, 0x71, 0xeb, 0x85, 0xf2, 0x87, 0xf0, 0xc6, 0xa9,
+  0xfb, 0x6d, 0x2c, 0xc6, 0xe7, 0xdf, 0xb7, 0x0e, 0x3c, 0xd8, 0x1d, 0xcc, 0x7b, 0x70, 0x26, 0x5f,
+  0xca, 0x45, 0x96, 0x1a, 0x78, 0xfd, 0x52, 0xe6, 0xcb, 0x87, 0x61, 0x83, 0x3c, 0x37, 0x80, 0xf0,
+  0x54, 0x06, 0xe3, 0xed, 0xf1, 0x76, 0x19, 0x3c, 0x0c, 0xba, 0x90, 0x49, 0x6c, 0x60, 0xf1, 0xb1,
+  0xbc, 0x4d, 0xe2, 0x47, 0x70, 0x0a, 0x61, 0x71, 0x8a, 0x47, 0x58, 0xfc, 0x21, 0x2a, 0x06, 0xf1,
+  0xf1, 0x61, 0xa0, 0x29, 0x15, 0x0b, 0x03, 0x84, 0x8f, 0xa5, 0xfa, 0x63, 0xf1, 0x23, 0x54, 0xf3,
+  0x98, 0x46, 0xa9, 0x64, 0xb7, 0x56, 0x51, 0xd5, 0x7b, 0x89, 0x1f, 0xde, 0xc1, 0xbd, 0x43, 0x9d,
+  0xd5, 0x50, 0xd9, 0x65, 0x14, 0x86, 0x44, 0x2c, 0x85, 0x64, 0x09, 0x49, 0x98, 0x10, 0x68, 0x21,
+  0x30, 0x4d, 0x9c, 0xd1, 0xb0, 0x73, 0x13, 0xa5, 0x61, 0x76, 0xe3, 0x67, 0x29, 0xbe, 0x81, 0x45,
+  0x66, 0x45, 0xaa, 0x0c, 0xe7, 0x7a, 0xca, 0x38, 0x34, 0x0c, 0x2f, 0x32, 0xe3, 0x2d, 0xae, 0xa3,
+  0x71, 0x38, 0x3d, 0xe2, 0xfc, 0x83, 0xc5, 0x41, 0x96, 0xb0, 0x0d, 0x32, 0x12, 0x57, 0x80, 0x13,
+  0xfc, 0x02, 0x8c, 0x80, 0x0e, 0x41, 0xa7, 0x59, 0x21, 0x49, 0xce, 0xb3, 0x39, 0xa7, 0x49, 0x02,
+  0x2b, 0x3d, 0x72, 0x7c, 0xfe, 0xe5, 0xed, 0x9b, 0x1e, 0xc9, 0x38, 0x19, 0x9d, 0xfa, 0xe4, 0x94,
+  0x04, 0xe0, 0x47, 0x62, 0x91, 0xdd, 0x28, 0x67, 0x20, 0xec, 0x96, 0x26, 0x79, 0xcc, 0x04, 0xb9,
+  0x89, 0xe4, 0x02, 0xb8, 0x4c, 0x25, 0xbd, 0x05, 0x7f, 0x9d, 0x2f, 0x62, 0xf8, 0x2f, 0x01, 0x81,
+  0xef, 0x78, 0x43, 0x25, 0x08, 0x85, 0xcd, 0xa0, 0x62, 0x90, 0x50, 0x71, 0x65, 0x98, 0xd4, 0xae,
+  0xf5, 0xb3, 0x60, 0x02, 0x37, 0x4e, 0xd3, 0x1c, 0x38, 0xd8, 0x23, 0x61, 0x16, 0x14, 0x09, 0x4b,
+  0xa5, 0x3f, 0x67, 0xf2, 0x38, 0x66, 0xf8, 0xf8, 0x61, 0x79, 0x1a, 0xba, 0x8e, 0x05, 0x44, 0xbc,
+  0xeb, 0x87, 0xe1, 0x5c, 0x0b, 0x8f, 0x7f, 0x4d, 0xe3, 0x82, 0xf9, 0x92, 0x47, 0x89, 0xab, 0xc0,
+  0xa3, 0x19, 0x71, 0x37, 0x2c, 0x88, 0x47, 0x38, 0x93, 0x05, 0x4f, 0x71, 0xa3, 0xa3, 0x02, 0xe5,
+  0x1c, 0xe5, 0x42, 0x55, 0xa2, 0x2e, 0x40, 0xb5, 0x51, 0x40, 0x41, 0x75, 0xb0, 0xf7, 0x28, 0x37,
+  0x06, 0xd8, 0xf1, 0xfc, 0x20, 0xa6, 0x42, 0x9c, 0x81, 0xae, 0x7d, 0xce, 0x92, 0xec, 0x9a, 0xb9,
+  0xce, 0x22, 0x0a, 0x43, 0x66, 0xf8, 0x7c, 0x14, 0x81, 0x60, 0x69, 0xd8, 0x9f, 0x4a, 0x00, 0xf3,
+  0xc3, 0x48, 0xd0, 0x69, 0xcc, 0xd0, 0x8e, 0x92, 0x17, 0xac, 0x66, 0x0b, 0x1d, 0xa0, 0x12, 0x51,
+  0x66, 0x55, 0x3e, 0x58, 0x37, 0x70, 0x21, 0x18, 0x07, 0xf3, 0x56, 0xf2, 0x19, 0x0c, 0x12, 0x52,
+  0x05, 0x2a, 0xda, 0x6a, 0x8b, 0x33, 0x0c, 0x5e, 0x7a, 0x43, 0x23, 0x49, 0x66, 0x4c, 0x06, 0x0b,
+  0xb7, 0x3b, 0x00, 0x73, 0x1c, 0xfc, 0xdc, 0xeb, 0x92, 0x6d, 0xc2, 0x52, 0x34, 0xec, 0x1f, 0x5f,
+  0x4f, 0x0f, 0xb3, 0x24, 0xcf, 0x52, 0x60, 0xd4, 0xad, 0x10, 0x2a, 0x8c, 0x5a, 0x8b, 0x80, 0xc4,
+  0x17, 0x92, 0xca, 0x02, 0x70, 0xed, 0xed, 0x91, 0xbf, 0xbe, 0x79, 0x47, 0xca, 0x92, 0xac, 0xad,
+  0xfe, 0x6d, 0xe7, 0xad, 0x67, 0x48, 0x2b, 0x41, 0x2e, 0x16, 0x98, 0x5c, 0xae, 0xa3, 0x80, 0xa9,
+  0x1c, 0x54, 0x88, 0xe5, 0x90, 0x00, 0x13, 0x82, 0x2e, 0xc1, 0x81, 0x16, 0x4c, 0x09, 0x87, 0x8e,
+  0x09, 0x91, 0x15, 0x5c, 0x99, 0x63, 0x9a, 0x67, 0xc5, 0xec, 0x9e, 0xc2, 0xbf, 0x60, 0x34, 0x64,
+  0x5c, 0xa0, 0x26, 0x5d, 0xe7, 0x2b, 0x03, 0xe9, 0xfa, 0xa3, 0x19, 0xa4, 0x24, 0xc7, 0x43, 0x0e,
+  0x9c, 0xd7, 0xce, 0xd0, 0x9c, 0x94, 0x0b, 0x0e, 0xe6, 0x4c, 0xd9, 0x0d, 0x39, 0xe6, 0x3c, 0xe3,
+  0xee, 0x64, 0xf3, 0x4e, 0x0b, 0x8d, 0x58, 0x30, 0xe6, 0x5c, 0x6f, 0xd5, 0x53, 0xda, 0xa1, 0x73,
+  0x08, 0x45, 0x30, 0x38, 0xd9, 0xbc, 0x43, 0x80, 0x15, 0x11, 0x13, 0x23, 0xea, 0xaa, 0x12, 0x78,
+  0x03, 0x4f, 0x65, 0x57, 0xb5, 0x3c, 0xf7, 0xd0, 0x9f, 0x5c, 0x5c, 0x7c, 0x21, 0x0c, 0x9f, 0x37,
+  0x88, 0x56, 0xc2, 0x2e, 0x20, 0xac, 0x55, 0xb2, 0x6a, 0x23, 0xd5, 0x82, 0xdd, 0x91, 0x28, 0x24,
+  0xab, 0xca, 0x1e, 0x08, 0x8d, 0x09, 0xc7, 0x35, 0xa0, 0x9d, 0xfb, 0x9a, 0xd3, 0x49, 0x5c, 0x20,
+  0xbb, 0x72, 0xa1, 0x55, 0x35, 0xe7, 0x59, 0x91, 0x86, 0x43, 0x40, 0x19, 0xc7, 0x90, 0xb9, 0xd5,
+  0xba, 0xc9, 0xf5, 0x14, 0x00, 0xa5, 0xc5, 0x22, 0x24, 0x67, 0x34, 0xc1, 0xa3, 0x3d, 0xa0, 0x94,
+  0x82, 0x1a, 0x95, 0xa3, 0x4b, 0x0d, 0x45, 0x00, 0xcd, 0x8d, 0x68, 0xf0, 0x16, 0x32, 0x74, 0x05,
+  0x0e, 0xcc, 0xa1, 0x94, 0x17, 0xa0, 0xb1, 0x23, 0xbd, 0x62, 0xb9, 0xc3, 0x82, 0x64, 0x53, 0x12,
+  0x00, 0x15, 0x71, 0x5c, 0xaf, 0xa3, 0x82, 0x61, 0xd1, 0x71, 0xea, 0x25, 0xce, 0x02, 0x16, 0x5d,
+  0x2b, 0x07, 0xdf, 0xd1, 0xab, 0x33, 0x48, 0x2b, 0xee, 0x70, 0x58, 0x2b, 0x55, 0x13, 0xce, 0x29,
+  0x97, 0x6b, 0x2e, 0x3a, 0x41, 0x17, 0x1d, 0x80, 0x7a, 0x8a, 0x58, 0x1e, 0x44, 0xe1, 0xde, 0xe6,
+  0x5d, 0x14, 0xae, 0x5e, 0xcd, 0x78, 0x96, 0xec, 0xa1, 0x8e, 0x35, 0xe2, 0x4a, 0xc3, 0xc6, 0x64,
+  0x88, 0xa7, 0x65, 0xb3, 0x5f, 0xb6, 0x9a, 0x3a, 0xb9, 0x66, 0x36, 0x6b, 0x38, 0xcb, 0xe5, 0x74,
+  0x29, 0x1b, 0x91, 0xa4, 0x4e, 0x50, 0xce, 0xe9, 0xf2, 0x43, 0x31, 0x9b, 0xd5, 0x3a, 0xaa, 0x94,
+  0x09, 0xb1, 0x04, 0xc0, 0x0a, 0xac, 0xe5, 0xc2, 0xff, 0xec, 0x8f, 0x94, 0xa9, 0xfa, 0x47, 0x00,
+  0x01, 0x4e, 0x8c, 0x81, 0xd3, 0xf0, 0xe2, 0x4a, 0x69, 0xdb, 0x7b, 0x9a, 0xa2, 0x8f, 0x9f, 0x67,
+  0x2c, 0x9d, 0xcb, 0x45, 0xe5, 0xe9, 0xa8, 0x6b, 0xd8, 0x37, 0x06, 0xf3, 0xf5, 0xb7, 0xab, 0xc0,
+  0x7b, 0xe0, 0x62, 0xda, 0xee, 0xbb, 0x64, 0x43, 0x31, 0xb1, 0x6a, 0x2b, 0xc9, 0x1a, 0xf0, 0xd5,
+  0x2b, 0x85, 0xa7, 0xa9, 0xac, 0x17, 0xa5, 0x3d, 0xc8, 0x45, 0xed, 0x9c, 0xa7, 0xff, 0xd5, 0xfe,
+  0xd1, 0x4e, 0x56, 0x70, 0x0c, 0x1e, 0x69, 0x2a, 0x21, 0x63, 0x29, 0xba, 0x95, 0x92, 0x09, 0x8b,
+  0x05, 0x53, 0xbc, 0x35, 0x58, 0x5b, 0x17, 0xbd, 0xc9, 0x66, 0x91, 0x87, 0xd0, 0xc4, 0x58, 0xcc,
+  0xe6, 0xd0, 0x3a, 0xd6, 0x86, 0xc8, 0xa8, 0x05, 0x8f, 0x4c, 0x41, 0x27, 0x57, 0x2d, 0x4d, 0x3c,
+  0x45, 0x43, 0x1b, 0x19, 0xfd, 0xe6, 0x0b, 0xf8, 0x5c, 0x24, 0x18, 0x66, 0xc0, 0x2c, 0xbe, 0x06,
+  0xc1, 0xf6, 0x89, 0x60, 0xf2, 0x22, 0x4a, 0x18, 0xd4, 0x4e, 0xbb, 0xda, 0xbb, 0xd7, 0x90, 0x79,
+  0x6b, 0xac, 0x34, 0x32, 0x8b, 0xe1, 0xd8, 0xfb, 0x15, 0x0d, 0xad, 0xa0, 0x00, 0x43, 0x3c, 0x10,
+  0x17, 0x5c, 0xd6, 0xf2, 0xf7, 0x48, 0x99, 0xef, 0x2a, 0x0f, 0xdf, 0x25, 0x2a, 0xab, 0x73, 0xee,
+  0x5b, 0x32, 0x1a, 0xcd, 0x2c, 0x4a, 0x69, 0x1c, 0xdb, 0xca, 0xf0, 0xbf, 0x5a, 0xfa, 0x85, 0xf5,
+  0x6d, 0x46, 0xc1, 0xc4, 0xfa, 0xe4, 0x03, 0x05, 0xbb, 0x91, 0x36, 0xda, 0xbb, 0x33, 0xa0, 0x22,
+  0x74, 0x60, 0xad, 0x3a, 0xab, 0x4e, 0xa7, 0xea, 0x26, 0x20, 0x8f, 0x24, 0x54, 0x1e, 0x82, 0xd3,
+  0x7f, 0x88, 0xb3, 0xe0, 0x4a, 0xb8, 0xb5, 0x27, 0x43, 0xda, 0x03, 0x8b, 0x05, 0x20, 0x3b, 0x61,
+  0x14, 0x14, 0x17, 0xdb, 0x2e, 0xd7, 0xf4, 0xb6, 0x1d, 0x9d, 0x9b, 0x34, 0x06, 0x68, 0x85, 0x2f,
+  0x74, 0xde, 0x42, 0x04, 0x75, 0x05, 0xfe, 0x2d, 0xe2, 0xaa, 0x70, 0x42, 0xcf, 0x86, 0x19, 0x38,
+  0x8e, 0x75, 0xf7, 0x33, 0x55, 0xc4, 0x74, 0xef, 0xa3, 0xb6, 0x16, 0x59, 0x8c, 0x81, 0x6d, 0x70,
+  0x06, 0x15, 0x3f, 0xa6, 0x55, 0x5f, 0x5b, 0x3e, 0x85, 0x0c, 0x7c, 0x6b, 0x93, 0xe1, 0x13, 0xac,
+  0x76, 0x4c, 0xa2, 0xd4, 0x89, 0xe4, 0x9b, 0x5d, 0xee, 0x59, 0x11, 0xbe, 0x93, 0x6c, 0x46, 0x3e,
+  0x4f, 0x7f, 0x40, 0xea, 0xf7, 0x41, 0xf1, 0x3c, 0x62, 0xc2, 0x6d, 0xb6, 0xea, 0x9e, 0x75, 0x94,
+  0x75, 0x21, 0x5b, 0xef, 0xbe, 0x11, 0xcf, 0x35, 0x58, 0x7b, 0x10, 0x7f, 0xe8, 0x6a, 0x3d, 0xc5,
+  0x47, 0x4f, 0xb1, 0xed, 0xa1, 0xb7, 0xaf, 0xe5, 0xea, 0x5a, 0x6e, 0xc0, 0x38, 0xb9, 0xbc, 0x3c,
+  0xfc, 0x7c, 0x74, 0x7c, 0xf9, 0xe1, 0xec, 0xf3, 0xe1, 0xc7, 0xcb, 0xcd, 0xbb, 0xb6, 0xac, 0xab,
+  0xcb, 0xcb, 0x49, 0x9d, 0x15, 0xad, 0x72, 0xfc, 0xbc, 0x10, 0x0b, 0xb7, 0x0e, 0xb5, 0x06, 0xc6,
+  0x5e, 0xb5, 0x68, 0x85, 0xde, 0x55, 0x4f, 0xa6, 0xa5, 0xab, 0xb7, 0x11, 0xdb, 0xae, 0xfa, 0x34,
+  0x5b, 0x36, 0xd6, 0xbc, 0x7b, 0xf4, 0x14, 0x27, 0xdb, 0xdb, 0x75, 0x7e, 0xc5, 0x1e, 0xb0, 0x49,
+  0xd4, 0x14, 0x69, 0xe3, 0x66, 0xd6, 0x32, 0x5f, 0x8d, 0xf1, 0x9b, 0x76, 0xd6, 0x96, 0xaf, 0xb4,
+  0xa8, 0x68, 0xb4, 0x8d, 0xa5, 0x3c, 0x04, 0xcd, 0x53, 0x8b, 0xeb, 0xb5, 0x9a, 0x31, 0x2b, 0xd7,
+  0x51, 0x24, 0x00, 0x33, 0xce, 0x74, 0xea, 0x88, 0x5f, 0xb9, 0xa9, 0x2a, 0x07, 0xd5, 0xac, 0xe0,
+  0x90, 0x03, 0x88, 0x0d, 0xb2, 0xbb, 0x06, 0x35, 0x6c, 0x60, 0xac, 0xd8, 0xc1, 0x70, 0x40, 0x93,
+  0x18, 0x41, 0xdf, 0x87, 0xd1, 0x35, 0x51, 0x41, 0xbc, 0xd7, 0x45, 0x6e, 0xfa, 0x0a, 0x45, 0x77,
+  0xbf, 0xd2, 0xe1, 0x3d, 0x00, 0x5d, 0xa6, 0x1a, 0x10, 0x00, 0x23, 0x72, 0x9a, 0xee, 0x6f, 0xde,
+  0xad, 0xb1, 0xbd, 0x7a, 0x3f, 0x50, 0x1b, 0x35, 0xae, 0x01, 0x20, 0x6b, 0xbc, 0xe6, 0x9c, 0xed,
+  0xbf, 0x57, 0x31, 0x63, 0x08, 0x58, 0x04, 0xfd, 0xcd, 0xbb, 0xb6, 0x28, 0xab, 0x2e, 0xa0, 0x67,
+  0x22, 0xa0, 0x39, 0x3b, 0x81, 0x29, 0xce, 0xd5, 0xbb, 0xca, 0xf9, 0x80, 0x0a, 0x7e, 0xef, 0xbf,
+  0x1f, 0x20, 0xba, 0xce, 0x3d, 0x4a, 0x93, 0xe1, 0x0b, 0xbc, 0x5c, 0xe3, 0x6d, 0xfa, 0x5a, 0x5b,
+  0x73, 0x6b, 0xe6, 0x1f, 0xe5, 0x39, 0x24, 0xcb, 0x07, 0x06, 0x1c, 0xec, 0x59, 0xa3, 0x34, 0x8e,
+  0xa0, 0xb0, 0xd6, 0xe6, 0xff, 0x05, 0xfa, 0x83, 0x89, 0xfb, 0xed, 0xdf, 0x93, 0xef, 0xdb, 0x1e,
+  0x8e, 0x87, 0xc4, 0x69, 0x29, 0x47, 0xe3, 0xeb, 0xe3, 0x12, 0x68, 0xe3, 0xb5, 0x11, 0xdb, 0xb1,
+  0x0d, 0xbd, 0x71, 0xd9, 0x16, 0xde, 0x61, 0x2b, 0x1f, 0x36, 0xf4, 0x57, 0x67, 0x42, 0x73, 0x0c,
+  0x17, 0x94, 0x9e, 0x6a, 0x56, 0x5e, 0x21, 0x0b, 0xdd, 0x57, 0x30, 0xca, 0x0d, 0xbb, 0xde, 0xda,
+  0xde, 0x7b, 0xbd, 0x17, 0xcb, 0xfb, 0x5b, 0xfb, 0x7a, 0x6b, 0xfe, 0xc0, 0x56, 0x57, 0x6f, 0xfd,
+  0x2c, 0xb2, 0x07, 0x36, 0x1d, 0xbd, 0xf9, 0x97, 0x9d, 0xb7, 0xef, 0x60, 0xb3, 0xcd, 0x79, 0xa5,
+  0xda, 0x73, 0xa5, 0x6a, 0x97, 0xe9, 0x62, 0x52, 0xe5, 0xf2, 0x27, 0xed, 0xa0, 0x47, 0x52, 0x7d,
+  0x42, 0x54, 0xd3, 0x21, 0xae, 0x9a, 0x9a, 0x84, 0x89, 0xd8, 0xec, 0xfb, 0x50, 0x5a, 0xf8, 0xf2,
+  0x9c, 0x61, 0xc3, 0x9c, 0xf1, 0x51, 0x1c, 0xbb, 0x0e, 0x02, 0x56, 0x4a, 0x6e, 0x9e, 0x82, 0xc2,
+  0xc3, 0x8f, 0x21, 0x23, 0xbb, 0x7a, 0xb1, 0x4e, 0x82, 0xed, 0x18, 0x06, 0xe4, 0x1a, 0x40, 0xd7,
+  0xca, 0x4f, 0x34, 0x61, 0x95, 0xd0, 0x4e, 0xe5, 0xf0, 0x38, 0x80, 0xdb, 0xb2, 0x59, 0x33, 0x58,
+  0x9f, 0x45, 0xfb, 0x1c, 0x66, 0x10, 0xed, 0xa9, 0x6c, 0xcf, 0x00, 0xe7, 0x11, 0x8e, 0xda, 0x0f,
+  0xca, 0x8e, 0x19, 0x07, 0x06, 0xa7, 0x04, 0x4d, 0x5f, 0x8b, 0xaf, 0xcb, 0x4d, 0x05, 0xa8, 0x2a,
+  0x2f, 0x12, 0x69, 0xa3, 0xfd, 0xc8, 0x96, 0x37, 0x19, 0x0f, 0xf5, 0x81, 0x36, 0x70, 0xe3, 0xad,
+  0x12, 0xc4, 0x4e, 0x73, 0xe3, 0xa9, 0x6b, 0x8d, 0x56, 0x6a, 0xcf, 0x2a, 0xa3, 0x59, 0x89, 0xad,
+  0x5b, 0x09, 0xdc, 0x94, 0xea, 0xce, 0xa9, 0xbc, 0xa6, 0xbc, 0x04, 0x1e, 0x4a, 0x25, 0x67, 0xa9,
+  0xb4, 0x52, 0x82, 0x14, 0x19, 0x97, 0x25, 0xbb, 0x55, 0x5f, 0xd8, 0xc1, 0x97, 0xea, 0x6e, 0xa0,
+  0x54, 0x2d, 0x56, 0x09, 0xf3, 0x58, 0xa9, 0x5a, 0x9c, 0x52, 0xb5, 0xea, 0x25, 0xb4, 0x5c, 0xf0,
+  0x14, 0x09, 0x6f, 0x3c, 0xd5, 0xf7, 0x28, 0xf8, 0xcf, 0x51, 0x79, 0xc8, 0x86, 0x8b, 0xcc, 0xae,
+  0x60, 0x76, 0xbc, 0xd2, 0x72, 0xe8, 0x80, 0x51, 0xd9, 0xc8, 0x51, 0xd0, 0x6b, 0x93, 0xd4, 0xb9,
+  0xc4, 0xa1, 0xe7, 0xa5, 0xd2, 0xba, 0x5d, 0x7f, 0xeb, 0xa0, 0x5b, 0x3a, 0xf0, 0xe9, 0x94, 0x13,
+  0xf8, 0x9c, 0x78, 0x4f, 0x73, 0x23, 0x14, 0x99, 0xe7, 0x98, 0xf9, 0x54, 0x24, 0x53, 0xdd, 0x2f,
+  0xbc, 0x50, 0xf5, 0xe3, 0x70, 0xdb, 0x1d, 0xfb, 0xf0, 0xe9, 0x1d, 0x3c, 0xab, 0x98, 0x54, 0x11,
+  0x79, 0x8e, 0x15, 0x18, 0xf7, 0x6b, 0xbf, 0x79, 0x81, 0x62, 0xc6, 0x83, 0xf1, 0xc0, 0xdf, 0x2a,
+  0xe1, 0x6b, 0xcb, 0x5e, 0x5f, 0x8d, 0xb7, 0xc6, 0x83, 0x67, 0xd4, 0x13, 0x68, 0x6a, 0xcf, 0x31,
+  0xf5, 0x9b, 0xf1, 0xb0, 0xff, 0x42, 0x43, 0xdf, 0x68, 0xff, 0xcf, 0x51, 0xff, 0x5f, 0x97, 0x9b,
+  0xdf, 0xcd, 0xd3, 0x4e, 0xff, 0x1d, 0xbc, 0x6c, 0x79, 0x63, 0xb1, 0x35, 0x76, 0x9f, 0xe6, 0xce,
+  0x3a, 0x76, 0x83, 0x3d, 0xf7, 0x3e, 0x7f, 0x26, 0x5e, 0xa3, 0x34, 0x65, 0xfc, 0xe4, 0xe2, 0xf7,
+  0xb3, 0x36, 0x4f, 0xaa, 0x7c, 0xac, 0x25, 0xb7, 0x56, 0xa3, 0xce, 0xb3, 0xd8, 0x0e, 0x29, 0x8d,
+  0x7b, 0x30, 0x73, 0xb7, 0x73, 0x04, 0xa5, 0xf8, 0x89, 0x4b, 0x30, 0xbc, 0x05, 0xee, 0x1b, 0xd0,
+  0xe6, 0x45, 0x18, 0x76, 0x7f, 0xcb, 0xe6, 0xc1, 0x00, 0x86, 0x1c, 0x69, 0xf3, 0x98, 0xeb, 0x40,
+  0xa9, 0xd4, 0xe0, 0x0a, 0xb0, 0x4e, 0x53, 0xd8, 0x26, 0x28, 0x9c, 0x1a, 0x01, 0x4c, 0xd4, 0xc0,
+  0xdc, 0x4a, 0xd5, 0xd3, 0x9a, 0x21, 0x9f, 0xe6, 0x39, 0x74, 0xf3, 0x87, 0x10, 0xd9, 0xa1, 0xab,
+  0x00, 0xbd, 0xc6, 0xd5, 0x19, 0x00, 0x31, 0xbc, 0x93, 0x30, 0xf0, 0x44, 0x8d, 0xc2, 0x15, 0x63,
+  0xf5, 0x14, 0x78, 0x57, 0xcb, 0xdd, 0xd3, 0x6c, 0xac, 0x14, 0xff, 0xf5, 0xbd, 0xb6, 0xee, 0x07,
+  0x9b, 0xd3, 0xca, 0x73, 0x03, 0x9e, 0xa9, 0x6c, 0x66, 0x43, 0xe9, 0x5c, 0x75, 0x6c, 0x7d, 0x7d,
+  0xc9, 0x41, 0x28, 0xa9, 0xce, 0x50, 0x41, 0x12, 0xe4, 0x14, 0x5a, 0x32, 0x6a, 0xe6, 0x62, 0xf0,
+  0x26, 0x7b, 0x59, 0xc2, 0x39, 0x8c, 0xda, 0xa2, 0x36, 0xd8, 0x53, 0x84, 0xff, 0x0f, 0x46, 0x33,
+  0x08, 0x7d, 0xf9, 0xe0, 0xcc, 0xa1, 0xca, 0x7b, 0x6b, 0xd0, 0x80, 0x69, 0x11, 0x53, 0x21, 0x5e,
+  0x9e, 0xe1, 0x6d, 0xbe, 0x9d, 0x0f, 0x2d, 0x1e, 0x33, 0x5f, 0xe4, 0x7a, 0x86, 0xb8, 0x37, 0xca,
+  0x34, 0x26, 0x6a, 0x1f, 0x8d, 0xa0, 0x5b, 0xcb, 0x7a, 0xca, 0xb4, 0x8d, 0xe9, 0xfa, 0xf9, 0x87,
+  0x87, 0xab, 0x46, 0x7b, 0x64, 0x91, 0x6a, 0xa7, 0x6a, 0xc6, 0xc3, 0xa4, 0xd5, 0x53, 0xa2, 0xfc,
+  0xd3, 0x62, 0x0a, 0x33, 0x20, 0xf6, 0x78, 0x2d, 0x32, 0x2b, 0xdd, 0xc6, 0x4d, 0x86, 0xcf, 0x37,
+  0x5c, 0x2f, 0x90, 0x64, 0xbd, 0x99, 0x68, 0x31, 0xba, 0xd6, 0xe0, 0x9d, 0x07, 0x80, 0x29, 0xc6,
+  0x2e, 0x62, 0x9a, 0x49, 0x99, 0x25, 0x6d, 0xd7, 0x17, 0x6a, 0xf7, 0x22, 0xcb, 0x55, 0x90, 0xaf,
+  0x2d, 0x9f, 0x30, 0xa4, 0x61, 0xdd, 0xee, 0x84, 0xa6, 0x21, 0xb0, 0x74, 0x0c, 0x15, 0x9c, 0x63,
+  0x51, 0x02, 0x7d, 0x02, 0xd9, 0xce, 0x2f, 0x5c, 0x68, 0xe3, 0x60, 0x7d, 0x7c, 0x0d, 0x1b, 0x38,
+  0x65, 0xe3, 0x4f, 0x33, 0xae, 0x03, 0xe7, 0xd5, 0x71, 0x68, 0x1a, 0xaa, 0xbb, 0x7d, 0xa6, 0xc5,
+  0x43, 0x25, 0x30, 0x1f, 0x09, 0x28, 0xe9, 0x15, 0xbd, 0x4a, 0x72, 0x75, 0xbd, 0x6e, 0xe6, 0x64,
+  0xf8, 0xae, 0x3d, 0x1a, 0xaf, 0xee, 0x4f, 0xd3, 0x59, 0xf6, 0xcc, 0x2f, 0x04, 0xea, 0xd6, 0x9f,
+  0x8c, 0x4e, 0xc9, 0xa8, 0x72, 0xb2, 0xeb, 0x37, 0xfe, 0x0e, 0xe9, 0x83, 0x5c, 0x0b, 0x9a, 0x06,
+  0x10, 0x33, 0x6a, 0xf6, 0x51, 0xde, 0xd9, 0x6a, 0x45, 0x40, 0x7a, 0x8c, 0x37, 0xbc, 0x87, 0x4a,
+  0xc9, 0x1f, 0xa7, 0x7e, 0xf5, 0x1b, 0xc3, 0x23, 0x3f, 0x2d, 0x90, 0x19, 0x64, 0xa8, 0x82, 0xe3,
+  0x45, 0x95, 0xfa, 0x8d, 0x01, 0x2c, 0x90, 0x47, 0x81, 0xd8, 0x50, 0xbf, 0x1b, 0x74, 0xfe, 0x03,
+  0x52, 0x49, 0xf6, 0x1e, 0x08, 0x1b, 0x00, 0x00,
+};
+
+constexpr StaticAsset webAssets[] = {
+  {"/", "text/html", "\"ee0c290d72ad3129\"", "no-cache", webAssetIndexHtml, 468},
+  {"/style.css", "text/css", "\"2cb2da39bce98736\"", "public, max-age=31536000, immutable", webAssetStyleCss, 1686},
+  {"/app.js", "application/javascript", "\"0e96eddcd685c4af\"", "public, max-age=31536000, immutable", webAssetAppJs, 2472},
+};
+
+#define WEB_ASSET_COUNT 3
+
+#endif
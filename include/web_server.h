@@ -2,561 +2,470 @@
 #define WEB_SERVER_H
 
 #include <Arduino.h>
-#include <WebServer.h>
+#include <atomic>
+#include "async_log.h"
+#include "http_server.h"
+#include "metrics.h"
 #include "knowledge_base.h"
+#include "kb_ingest.h"
 #include "openai_client.h"
+#include "profiler.h"
+#include "ask_worker.h"
+#include "rate_limiter.h"
+#include "web_assets.h"
+
+// Questions each client may ask per minute, and in a burst
+#ifndef ASK_RATE_PER_MINUTE
+#define ASK_RATE_PER_MINUTE 20
+#endif
+#ifndef ASK_RATE_BURST
+#define ASK_RATE_BURST 5
+#endif
+// Seconds a client is told to wait while the heap is short
+#ifndef ASK_RETRY_AFTER_HEAP
+#define ASK_RETRY_AFTER_HEAP 5
+#endif
+// Task that writes the knowledge base image for POST /kb/persist
+#ifndef KB_PERSIST_CORE
+#define KB_PERSIST_CORE 0
+#endif
+#ifndef KB_PERSIST_STACK
+#define KB_PERSIST_STACK 8192
+#endif
+
+enum KnowledgePersistState : uint8_t {
+  KB_PERSIST_IDLE,
+  KB_PERSIST_RUNNING,
+  KB_PERSIST_DONE,
+  KB_PERSIST_FAILED
+};
 
 class AIWebServer {
 private:
-  WebServer server;
+  HttpServer server;
+  uint16_t port;
   KnowledgeBase& kb;
-  OpenAIClient& ai;
+  OpenAIClient& ai;  // only read for /metrics; questions go through asker
+  AskWorker asker;   // answers questions off the loop task
+  RateLimiter askLimiter;
+  KnowledgeIngest* ingest = nullptr;  // upload in progress on POST /kb
+  uint32_t ingestRequest = 0;         // the request it belongs to
+  KnowledgeImageStorage* imageStorage = nullptr;  // where POST /kb/persist writes
+  std::atomic<uint8_t> persistState{KB_PERSIST_IDLE};  // set to running only by the loop task
+  uint32_t persistMs = 0;  // written by the persist task before it leaves running
+
+public:
+  AIWebServer(int port, KnowledgeBase& knowledgeBase, OpenAIClient& aiClient) 
+    : server(port), port(port), kb(knowledgeBase), ai(aiClient), asker(knowledgeBase, aiClient),
+      askLimiter(ASK_RATE_PER_MINUTE, ASK_RATE_BURST) {}
   
-  // HTML templates
-  const char* mainPageTemplate = R"rawliteral(
-<!DOCTYPE html>
-<html>
-<head>
-  <title>ESP32 AI Assistant</title>
-  <meta name="viewport" content="width=device-width, initial-scale=1">
-  <!-- Prism CSS for code highlighting -->
-  <style>
-    /* Modern Color Scheme */
-    :root {
-      --primary-color: #6200ee;
-      --primary-dark: #3700b3;
-      --primary-light: #bb86fc;
-      --secondary-color: #03dac6;
-      --secondary-dark: #018786;
-      --background: #121212;
-      --surface: #1e1e1e;
-      --error: #cf6679;
-      --on-primary: #ffffff;
-      --on-secondary: #000000;
-      --on-background: #ffffff;
-      --on-surface: #ffffff;
-      --on-error: #000000;
-      --code-background: #2d2d2d;
-      --code-foreground: #f8f8f2;
-      --code-comment: #6272a4;
-      --code-keyword: #ff79c6;
-      --code-function: #50fa7b;
-      --code-string: #f1fa8c;
-      --code-number: #bd93f9;
-      --code-operator: #ff79c6;
-      --code-class: #8be9fd;
-      --code-variable: #f8f8f2;
-    }
-    
-    /* Base Styles */
-    body {
-      font-family: 'Segoe UI', Tahoma, Geneva, Verdana, sans-serif;
-      background-color: var(--background);
-      margin: 0;
-      padding: 20px;
-      color: var(--on-background);
-      line-height: 1.6;
-    }
-    
-    .container {
-      max-width: 900px;
-      margin: 0 auto;
-      background: var(--surface);
-      border-radius: 12px;
-      box-shadow: 0 4px 20px rgba(0,0,0,0.3);
-      padding: 24px;
-      overflow: hidden;
-    }
-    
-    h1 {
-      color: var(--primary-light);
-      text-align: center;
-      margin-bottom: 24px;
-      font-weight: 600;
-      letter-spacing: 0.5px;
-    }
-    
-    /* Chat Container */
-    .chat-container {
-      border: 1px solid rgba(255,255,255,0.1);
-      border-radius: 12px;
-      overflow: hidden;
-      display: flex;
-      flex-direction: column;
-      height: 70vh;
-      background-color: rgba(30,30,30,0.7);
-    }
-    
-    #chat-history {
-      flex-grow: 1;
-      overflow-y: auto;
-      padding: 20px;
-      background-color: var(--surface);
-      scrollbar-width: thin;
-      scrollbar-color: var(--primary-color) var(--surface);
-    }
-    
-    #chat-history::-webkit-scrollbar {
-      width: 8px;
-    }
-    
-    #chat-history::-webkit-scrollbar-track {
-      background: var(--surface);
-    }
-    
-    #chat-history::-webkit-scrollbar-thumb {
-      background-color: var(--primary-color);
-      border-radius: 4px;
-    }
-    
-    /* Input Area */
-    .input-area {
-      display: flex;
-      padding: 16px;
-      background-color: rgba(40,40,40,0.9);
-      border-top: 1px solid rgba(255,255,255,0.1);
-    }
-    
-    #question {
-      flex-grow: 1;
-      padding: 12px 16px;
-      border: 1px solid rgba(255,255,255,0.2);
-      border-radius: 8px;
-      font-size: 16px;
-      background-color: rgba(30,30,30,0.8);
-      color: var(--on-background);
-      transition: all 0.3s ease;
+  void begin() {
+    // Set up routes. The page, stylesheet and script are served gzipped
+    // from flash and cached by the browser
+    for (const StaticAsset& asset : webAssets) {
+      server.on("GET", asset.path, [&asset](HttpRequest& request, HttpResponse& response) {
+        PROFILE_ZONE("http.asset");
+        asset.send(request, response);
+      });
     }
     
-    #question:focus {
-      outline: none;
-      border-color: var(--primary-light);
-      box-shadow: 0 0 0 2px rgba(187,134,252,0.3);
-    }
+    server.on("GET", "/ask", [this](HttpRequest& request, HttpResponse& response) {
+      handleAsk(request, response);
+    });
     
-    #send-btn {
-      background-color: var(--primary-color);
-      color: var(--on-primary);
-      border: none;
-      border-radius: 8px;
-      padding: 12px 24px;
-      margin-left: 12px;
-      cursor: pointer;
-      font-size: 16px;
-      font-weight: 500;
-      transition: all 0.2s ease;
-    }
+    server.on("GET", "/ask/result", [this](HttpRequest& request, HttpResponse& response) {
+      handleAskResult(request, response);
+    });
     
-    #send-btn:hover {
-      background-color: var(--primary-dark);
-      transform: translateY(-2px);
-      box-shadow: 0 4px 8px rgba(0,0,0,0.2);
-    }
+    // Bulk knowledge upload; the body is parsed as it is received
+    server.on("POST", "/kb", [this](HttpRequest& request, HttpResponse& response) {
+      handleIngestDone(request, response);
+    }, [this](HttpRequest& request, HttpBodyEvent event, const uint8_t* data, size_t length) {
+      handleIngestBody(request, event, data, length);
+    });
     
-    #send-btn:disabled {
-      background-color: rgba(98, 0, 238, 0.3);
-      cursor: not-allowed;
-      transform: none;
-      box-shadow: none;
-    }
+    server.on("DELETE", "/kb/{}", [this](HttpRequest& request, HttpResponse& response) {
+      handleDeleteEntry(request, response);
+    });
     
-    /* Chat Messages */
-    .chat-entry {
-      margin-bottom: 20px;
-      display: flex;
-      animation: fadeIn 0.3s ease;
-    }
+    // Uploads and removals live in RAM until written to flash here
+    server.on("POST", "/kb/persist", [this](HttpRequest& request, HttpResponse& response) {
+      handlePersist(request, response);
+    });
     
-    @keyframes fadeIn {
-      from { opacity: 0; transform: translateY(10px); }
-      to { opacity: 1; transform: translateY(0); }
-    }
+    server.on("GET", "/kb/persist", [this](HttpRequest& request, HttpResponse& response) {
+      handlePersistStatus(request, response);
+    });
     
-    .chat-entry.user {
-      justify-content: flex-end;
-    }
+    server.on("GET", "/metrics", [this](HttpRequest& request, HttpResponse& response) {
+      handleMetrics(request, response);
+    });
     
-    .chat-entry.assistant {
-      justify-content: flex-start;
-    }
+    server.on("GET", "/logs", [this](HttpRequest& request, HttpResponse& response) {
+      handleLogs(request, response);
+    });
     
-    .chat-entry.system {
-      justify-content: center;
-    }
+#if PROFILE_ENABLED
+    server.on("GET", "/trace", [this](HttpRequest& request, HttpResponse& response) {
+      handleTrace(request, response);
+    });
+#endif
     
-    .chat-bubble {
-      max-width: 85%;
-      padding: 12px 18px;
-      border-radius: 18px;
-      box-shadow: 0 2px 10px rgba(0,0,0,0.15);
-      word-wrap: break-word;
-      line-height: 1.5;
+    if (!asker.begin()) {
+      Serial.println("Failed to start the question worker");
     }
     
-    .user .chat-bubble {
-      background-color: var(--primary-color);
-      color: var(--on-primary);
-      border-bottom-right-radius: 4px;
+    // Start server
+    if (!server.begin()) {
+      Serial.println("Failed to start the web server");
+      return;
     }
-    
-    .assistant .chat-bubble {
-      background-color: rgba(60,60,60,0.9);
-      color: var(--on-surface);
-      border-bottom-left-radius: 4px;
+    Serial.printf("Web server started on port %u\n", (unsigned)port);
+  }
+  
+  // Serve whichever connections are ready; never blocks
+  void handleClient() {
+    server.poll(0);
+  }
+
+  // Flash partition for POST /kb/persist; without one it answers 503
+  void setImageStorage(KnowledgeImageStorage* storage) {
+    imageStorage = storage;
+  }
+
+  const HttpServerStats& stats() const { return server.stats(); }
+  const AskWorkerStats& askStats() const { return asker.stats(); }
+  uint32_t askRateLimited() const { return askLimiter.refusedCount(); }
+
+private:
+  // Queue the question for the worker and hand back its job ID at once;
+  // the answer is collected from /ask/result. Clients over their rate get
+  // 429, and questions the device can't take on now 503, both at once
+  // and with Retry-After
+  void handleAsk(HttpRequest& request, HttpResponse& response) {
+    PROFILE_ZONE("http.ask");
+    if (!request.hasArg("q")) {
+      response.send(400, "text/plain", "Missing question parameter");
+      return;
     }
     
-    .system .chat-bubble {
-      background-color: var(--error);
-      color: var(--on-error);
-      font-size: 14px;
-      padding: 8px 12px;
-      border-radius: 8px;
+    uint32_t wait = askLimiter.take(request.remoteAddress);
+    if (wait > 0) {
+      response.setHeader("Retry-After", std::to_string((wait + 999) / 1000));
+      response.send(429, "text/plain", "Too many questions");
+      return;
     }
     
-    /* Code Highlighting */
-    pre {
-      background-color: var(--code-background);
-      border-radius: 8px;
-      padding: 12px;
-      overflow-x: auto;
-      margin: 10px 0;
+    AskRefusal refusal;
+    uint32_t id = asker.submit(String(request.arg("q").c_str()), &refusal);
+    if (id == 0 && refusal == ASK_REFUSED_HEAP) {
+      response.setHeader("Retry-After", std::to_string(ASK_RETRY_AFTER_HEAP));
+      response.send(503, "text/plain", "The device is low on memory");
+      return;
     }
-    
-    code {
-      font-family: 'Fira Code', Consolas, Monaco, 'Andale Mono', monospace;
-      color: var(--code-foreground);
-      font-size: 14px;
-      line-height: 1.5;
-      tab-size: 2;
+    if (id == 0) {
+      response.setHeader("Retry-After", "1");
+      response.send(503, "text/plain", "Too many questions in progress");
+      return;
     }
     
-    .code-header {
-      background-color: rgba(0,0,0,0.3);
-      padding: 6px 12px;
-      border-top-left-radius: 8px;
-      border-top-right-radius: 8px;
-      font-size: 12px;
-      color: #ccc;
-      display: flex;
-      justify-content: space-between;
-      align-items: center;
-      margin-top: 10px;
-      margin-bottom: -10px;
+    response.setHeader("Location", "/ask/result?id=" + std::to_string(id));
+    response.send(202, "application/json", "{\"id\":" + std::to_string(id) + "}");
+  }
+  
+  // The answer to a queued question from byte offset "from" on: what has
+  // streamed in so far, or the rest once it is complete. X-Answer-Done
+  // tells the client whether to come back for more
+  void handleAskResult(HttpRequest& request, HttpResponse& response) {
+    PROFILE_ZONE("http.ask_result");
+    uint32_t id = strtoul(request.arg("id").c_str(), nullptr, 10);
+    size_t from = strtoul(request.arg("from").c_str(), nullptr, 10);
+    
+    String text;
+    std::vector<uint8_t> cached;
+    AskPollResult result = asker.poll(id, from, text, cached);
+    if (result == ASK_POLL_UNKNOWN) {
+      response.send(404, "text/plain", "Unknown or expired question");
+      return;
     }
     
-    .language-javascript { color: var(--code-foreground); }
-    .token.comment { color: var(--code-comment); }
-    .token.keyword { color: var(--code-keyword); }
-    .token.function { color: var(--code-function); }
-    .token.string { color: var(--code-string); }
-    .token.number { color: var(--code-number); }
-    .token.operator { color: var(--code-operator); }
-    .token.class-name { color: var(--code-class); }
-    .token.variable { color: var(--code-variable); }
-    
-    /* Loading Indicator */
-    #loading {
-      text-align: center;
-      padding: 16px;
-      color: var(--primary-light);
-      font-weight: 500;
+    response.setHeader("Cache-Control", "no-store");
+    response.setHeader("X-Answer-Done", result == ASK_POLL_DONE ? "1" : "0");
+    if (!cached.empty()) {
+      sendCachedAnswer(request, response, cached);
+      return;
     }
-    
-    .loading-dots:after {
-      content: '.';
-      animation: dots 1.5s steps(5, end) infinite;
+    response.send(200, "text/plain", std::string(text.c_str(), text.length()));
+  }
+
+  // Send a compressed cached answer as gzip when the browser accepts it,
+  // otherwise inflated
+  void sendCachedAnswer(HttpRequest& request, HttpResponse& response, const std::vector<uint8_t>& blob) {
+    response.setHeader("Vary", "Accept-Encoding");
+    
+    std::string body;
+    if (request.header("accept-encoding").find("gzip") != std::string::npos) {
+      uint8_t header[RESPONSE_GZIP_HEADER];
+      ResponseCodec::gzipHeader(header);
+      size_t streamSize = ResponseCodec::streamSize(blob.size());
+      
+      body.reserve(sizeof(header) + streamSize + RESPONSE_CODEC_HEADER);
+      body.append((const char*)header, sizeof(header));
+      body.append((const char*)ResponseCodec::stream(blob.data()), streamSize);
+      body.append((const char*)blob.data(), RESPONSE_CODEC_HEADER);
+      response.setHeader("Content-Encoding", "gzip");
+      response.send(200, "text/plain", std::move(body));
+      LOG_DEBUG("Answer: cached, %u bytes gzip", (unsigned)blob.size());
+      return;
     }
     
-    @keyframes dots {
-      0%, 20% { content: '.'; }
-      40% { content: '..'; }
-      60% { content: '...'; }
-      80%, 100% { content: ''; }
+    body.reserve(ResponseCodec::rawLength(blob.data()));
+    bool ok = ResponseCodec::decode(blob.data(), blob.size(), [&body](const uint8_t* data, size_t length) {
+      body.append((const char*)data, length);
+    });
+    response.send(200, "text/plain", std::move(body));
+    if (ok) LOG_DEBUG("Answer: cached, %u bytes inflated", (unsigned)ResponseCodec::rawLength(blob.data()));
+    else LOG_ERROR("Answer: cached, %u bytes inflated (corrupt)", (unsigned)ResponseCodec::rawLength(blob.data()));
+  }
+
+  // Feed POST /kb body chunks to the parser without buffering the body.
+  // The upload holds the knowledge base writer lock until it is committed,
+  // and the loop task can't wait for itself, so a second upload arriving
+  // meanwhile on another connection is turned away, as is one arriving
+  // while the persist task holds the lock
+  void handleIngestBody(HttpRequest& request, HttpBodyEvent event, const uint8_t* data, size_t length) {
+    PROFILE_ZONE("http.kb_upload_body");
+    if (event == HTTP_BODY_START) {
+      if (ingest != nullptr || persisting()) return;
+      KnowledgeIngestFormat format = request.header("content-type").rfind("text/csv", 0) == 0 ? KB_INGEST_CSV : KB_INGEST_NDJSON;
+      ingest = new KnowledgeIngest(kb.beginUpdate(), format);
+      ingestRequest = request.id;
+    } else if (ingest == nullptr || ingestRequest != request.id) {
+      return;
+    } else if (event == HTTP_BODY_DATA) {
+      ingest->write(data, length);
+    } else if (event == HTTP_BODY_END) {
+      ingest->finish();
+    } else if (event == HTTP_BODY_ABORTED) {
+      LOG_WARN("Knowledge upload aborted");
+      endIngest();
     }
-    
-    .hidden {
-      display: none;
+  }
+
+  // Publish the uploaded entries and report throughput and heap use
+  void handleIngestDone(HttpRequest& request, HttpResponse& response) {
+    PROFILE_ZONE("http.kb_upload");
+    // Whatever this request sent, an upload on another connection is
+    // left alone
+    if (ingest != nullptr && ingestRequest != request.id) {
+      response.send(409, "text/plain", "Another knowledge upload was in progress");
+      return;
     }
-    
-    /* Footer */
-    .footer {
-      text-align: center;
-      margin-top: 24px;
-      font-size: 14px;
-      color: rgba(255,255,255,0.5);
+    if (ingest == nullptr && persisting()) {
+      response.send(409, "text/plain", "The knowledge base is being persisted");
+      return;
     }
-    
-    .footer a {
-      color: var(--primary-light);
-      text-decoration: none;
+    if (request.contentLength == 0 || ingest == nullptr) {
+      response.send(400, "text/plain", "Missing knowledge base body");
+      return;
     }
-    
-    .footer a:hover {
-      text-decoration: underline;
+
+    if (!kb.commit(ingest->pending())) {
+      endIngest();
+      response.send(409, "text/plain", "Knowledge upload was already published");
+      return;
     }
-  </style>
-</head>
-<body>
-  <div class="container">
-    <h1>ESP32 AI Assistant</h1>
-    <div class="chat-container">
-      <div id="chat-history"></div>
-      <div id="loading" class="hidden">
-        Thinking<span class="loading-dots"></span>
-      </div>
-      <div class="input-area">
-        <input id="question" type="text" placeholder="Ask me anything..." />
-        <button id="send-btn" onclick="ask()">Send</button>
-      </div>
-    </div>
-    <div class="footer">
-      Powered by <a href="#" onclick="showInfo(); return false;">ESP32 & OpenAI</a>
-    </div>
-  </div>
+    ingest->sampleHeap();
+    KnowledgeIngestStats stats = ingest->stats();
+    endIngest();
 
-  <script>
-    // Keep chat history
-    let chatHistory = [];
-    
-    // Language detection patterns
-    const codePatterns = {
-      javascript: /```(javascript|js)\n([\s\S]*?)```/g,
-      python: /```(python|py)\n([\s\S]*?)```/g,
-      cpp: /```(cpp|c\+\+|c)\n([\s\S]*?)```/g,
-      html: /```(html|xml)\n([\s\S]*?)```/g,
-      css: /```(css)\n([\s\S]*?)```/g,
-      json: /```(json)\n([\s\S]*?)```/g,
-      bash: /```(bash|sh|shell)\n([\s\S]*?)```/g,
-      plaintext: /```(plaintext|text)?\n([\s\S]*?)```/g
-    };
-    
-    // Add system message on load
-    window.onload = function() {
-      addToHistory('system', 'Welcome! Ask me anything about programming, ESP32, or AI. I can show code examples with syntax highlighting.');
-    };
-    
-    async function ask() {
-      const questionInput = document.getElementById('question');
-      const question = questionInput.value.trim();
-      if (!question) return;
-      
-      // Show loading indicator
-      document.getElementById('loading').classList.remove('hidden');
-      document.getElementById('send-btn').disabled = true;
-      
-      // Add question to history
-      addToHistory('user', question);
-      
-      try {
-        const res = await fetch("/ask?q=" + encodeURIComponent(question));
-        if (!res.ok) {
-          throw new Error(`HTTP error! status: ${res.status}`);
-        }
-        const text = await res.text();
-        addToHistory('assistant', text);
-      } catch (err) {
-        addToHistory('system', "Error: " + err.message);
-      } finally {
-        document.getElementById('loading').classList.add('hidden');
-        document.getElementById('send-btn').disabled = false;
-        questionInput.value = '';
-        questionInput.focus();
-      }
+    float seconds = max(stats.elapsedMs, (uint32_t)1) / 1000.0f;
+    String json = "{\"added\":" + String(stats.added) +
+                  ",\"rejected\":" + String(stats.rejected) +
+                  ",\"firstId\":" + String(stats.firstId) +
+                  ",\"size\":" + String(kb.getSize()) +
+                  ",\"bytes\":" + String(stats.bytes) +
+                  ",\"ms\":" + String(stats.elapsedMs) +
+                  ",\"entriesPerSec\":" + String(stats.added / seconds, 1) +
+                  ",\"kbPerSec\":" + String(stats.bytes / 1024.0f / seconds, 1) +
+                  ",\"peakHeap\":" + String(stats.peakHeap) + "}";
+    LOG_INFO("Knowledge upload: %s", json.c_str());
+    response.send(200, "application/json", json.c_str());
+  }
+
+  void endIngest() {
+    delete ingest;
+    ingest = nullptr;
+    ingestRequest = 0;
+  }
+
+  // Stage latencies, counters, queue depth and heap in the Prometheus
+  // text format. The histograms are read while they are recorded to,
+  // without stopping anything
+  void handleMetrics(HttpRequest& request, HttpResponse& response) {
+    PROFILE_ZONE("http.metrics");
+    std::string text;
+    text.reserve(12288);
+    MetricsWriter out(text);
+    
+    const AskStageTimes& askTimes = asker.stageTimes();
+    const OpenAIStageTimes& apiTimes = ai.stageTimes();
+    out.describe("esp32_ai_stage_seconds", "histogram", "Time spent in each stage of answering a question.");
+    out.histogram("esp32_ai_stage_seconds", "stage=\"kb_lookup\"", askTimes.kbLookup);
+    out.histogram("esp32_ai_stage_seconds", "stage=\"cache_lookup\"", askTimes.cacheLookup);
+    out.histogram("esp32_ai_stage_seconds", "stage=\"connect\"", apiTimes.connect);
+    out.histogram("esp32_ai_stage_seconds", "stage=\"first_byte\"", apiTimes.firstByte);
+    out.histogram("esp32_ai_stage_seconds", "stage=\"body_read\"", apiTimes.bodyRead);
+    out.histogram("esp32_ai_stage_seconds", "stage=\"json_parse\"", apiTimes.jsonParse);
+    out.histogram("esp32_ai_stage_seconds", "stage=\"response_send\"", server.sendTime());
+    
+    const AskWorkerStats& asks = asker.stats();
+    out.describe("esp32_ai_questions_total", "counter", "Questions by how they were answered or turned away.");
+    out.sample("esp32_ai_questions_total", "result=\"cache\"", asks.cached);
+    out.sample("esp32_ai_questions_total", "result=\"api\"", asks.requested);
+    out.sample("esp32_ai_questions_total", "result=\"coalesced\"", asks.coalesced);
+    out.sample("esp32_ai_questions_total", "result=\"refused_slots\"", asks.rejected);
+    out.sample("esp32_ai_questions_total", "result=\"refused_heap\"", asks.shed);
+    out.sample("esp32_ai_questions_total", "result=\"rate_limited\"", askLimiter.refusedCount());
+    out.sample("esp32_ai_questions_total", "result=\"expired\"", asks.expired);
+    uint32_t answered = asks.cached + asks.requested;
+    out.gauge("esp32_ai_answer_cache_hit_ratio", "Share of answered questions served from the cache.",
+              answered > 0 ? (double)asks.cached / answered : 0.0);
+    
+    const ResponseCacheStats& ram = ai.cacheStats();
+    const SemanticCacheStats& similar = ai.semanticCacheStats();
+    out.describe("esp32_ai_cache_lookups_total", "counter", "Response cache lookups by tier and result.");
+    out.sample("esp32_ai_cache_lookups_total", "cache=\"ram\",result=\"hit\"", ram.hits);
+    out.sample("esp32_ai_cache_lookups_total", "cache=\"ram\",result=\"miss\"", ram.misses);
+    out.sample("esp32_ai_cache_lookups_total", "cache=\"similar\",result=\"hit\"", similar.hits);
+    out.sample("esp32_ai_cache_lookups_total", "cache=\"similar\",result=\"miss\"", similar.lookups - similar.hits);
+    out.gauge("esp32_ai_cache_entries", "Answers in the RAM response cache.", ram.entries);
+    
+    out.gauge("esp32_ai_ask_queue_depth", "Questions waiting for the worker.", asker.queued());
+    
+    const UpstreamStats& api = ai.upstreamStats();
+    out.counter("esp32_ai_api_requests_total", "Requests to the OpenAI API.", api.requests);
+    out.counter("esp32_ai_api_failures_total", "API requests that got no complete response.", api.failures);
+    out.counter("esp32_ai_api_reused_total", "API requests sent on a kept-alive connection.", api.reused);
+    out.describe("esp32_ai_api_handshakes_total", "counter", "TLS handshakes with the API by kind.");
+    out.sample("esp32_ai_api_handshakes_total", "kind=\"full\"", api.fullHandshakes);
+    out.sample("esp32_ai_api_handshakes_total", "kind=\"resumed\"", api.resumedHandshakes);
+    
+    const HttpServerStats& http = server.stats();
+    out.counter("esp32_ai_http_requests_total", "HTTP requests served.", http.requests);
+    out.counter("esp32_ai_http_connections_total", "HTTP connections accepted.", http.accepted);
+    out.counter("esp32_ai_http_evicted_total", "Idle HTTP connections closed to make room.", http.evicted);
+    out.gauge("esp32_ai_http_connections_open", "Open HTTP connections.", http.open);
+    
+    out.gauge("esp32_ai_heap_free_bytes", "Free heap.", ESP.getFreeHeap());
+    out.gauge("esp32_ai_heap_largest_free_block_bytes", "Largest block that can be allocated.", ESP.getMaxAllocHeap());
+    out.gauge("esp32_ai_heap_min_free_bytes", "Lowest free heap since boot.", ESP.getMinFreeHeap());
+    out.gauge("esp32_ai_uptime_seconds", "Time since boot.", millis() / 1000.0);
+    out.counter("esp32_ai_log_dropped_total", "Log records dropped because the log buffer was full.",
+                asyncLog.droppedCount());
+    
+    response.setHeader("Cache-Control", "no-store");
+    response.send(200, "text/plain; version=0.0.4", std::move(text));
+  }
+
+  // The latest log lines. X-Log-Next is the since= that returns only the
+  // lines logged after these
+  void handleLogs(HttpRequest& request, HttpResponse& response) {
+    PROFILE_ZONE("http.logs");
+    uint32_t since = request.hasArg("since") ? strtoul(request.arg("since").c_str(), nullptr, 10) : 0;
+    String lines;
+    uint32_t next = asyncLog.recent(lines, since);
+    response.setHeader("Cache-Control", "no-store");
+    response.setHeader("X-Log-Next", std::to_string(next));
+    response.send(200, "text/plain", lines.c_str());
+  }
+
+#if PROFILE_ENABLED
+  // Recent profiling zones from both cores as Chrome trace-event JSON
+  void handleTrace(HttpRequest& request, HttpResponse& response) {
+    PROFILE_ZONE("http.trace");
+    std::string json;
+    json.reserve(Profiler::traceSize());
+    profiler.writeTrace(json);
+    response.setHeader("Cache-Control", "no-store");
+    response.send(200, "application/json", std::move(json));
+  }
+#endif
+
+  void handleDeleteEntry(HttpRequest& request, HttpResponse& response) {
+    PROFILE_ZONE("http.kb_delete");
+    // Removing takes the writer lock an upload or persist holds
+    if (ingest != nullptr) {
+      response.send(409, "text/plain", "A knowledge upload is in progress");
+      return;
     }
-    
-    function formatCodeBlocks(text) {
-      // Process each language pattern
-      let formattedText = text;
-      
-      // First replace all code blocks with placeholders
-      let codeBlocks = [];
-      let codeBlockIndex = 0;
-      
-      // Process each language
-      for (const [language, pattern] of Object.entries(codePatterns)) {
-        formattedText = formattedText.replace(pattern, (match, lang, code) => {
-          const placeholder = `__CODE_BLOCK_${codeBlockIndex}__`;
-          codeBlocks.push({
-            placeholder,
-            language: lang.trim(),
-            code: code.trim()
-          });
-          codeBlockIndex++;
-          return placeholder;
-        });
-      }
-      
-      // Replace placeholders with formatted code
-      for (const block of codeBlocks) {
-        const languageDisplay = block.language === 'plaintext' ? '' : block.language;
-        const formattedCode = `
-          <div class="code-block">
-            <div class="code-header">
-              <span>${languageDisplay}</span>
-            </div>
-            <pre><code class="language-${block.language}">${escapeHtml(block.code)}</code></pre>
-          </div>
-        `;
-        formattedText = formattedText.replace(block.placeholder, formattedCode);
-      }
-      
-      // Apply syntax highlighting to inline code
-      formattedText = formattedText.replace(/`([^`]+)`/g, '<code class="inline-code">$1</code>');
-      
-      return formattedText;
+    if (persisting()) {
+      response.send(409, "text/plain", "The knowledge base is being persisted");
+      return;
     }
-    
-    function escapeHtml(text) {
-      return text
-        .replace(/&/g, "&amp;")
-        .replace(/</g, "&lt;")
-        .replace(/>/g, "&gt;")
-        .replace(/"/g, "&quot;")
-        .replace(/'/g, "&#039;");
+    String id = request.pathArg.c_str();
+    int index = id.toInt();
+    if (id.length() == 0 || String(index) != id || !kb.removeEntry(index)) {
+      response.send(404, "text/plain", "No such entry");
+      return;
     }
-    
-    function highlightSyntax(element) {
-      // Apply syntax highlighting to code elements
-      const codeElements = element.querySelectorAll('code');
-      
-      codeElements.forEach(codeEl => {
-        const language = codeEl.className.replace('language-', '');
-        const code = codeEl.textContent;
-        
-        // Simple syntax highlighting for common elements
-        let highlighted = code;
-        
-        // Keywords
-        highlighted = highlighted.replace(
-          /\b(function|return|if|else|for|while|var|let|const|class|import|export|from|async|await|try|catch|throw|new|this)\b/g,
-          '<span class="token keyword">$1</span>'
-        );
-        
-        // Strings
-        highlighted = highlighted.replace(
-          /(".*?"|'.*?'|`.*?`)/g,
-          '<span class="token string">$1</span>'
-        );
-        
-        // Numbers
-        highlighted = highlighted.replace(
-          /\b(\d+(\.\d+)?)\b/g,
-          '<span class="token number">$1</span>'
-        );
-        
-        // Comments
-        highlighted = highlighted.replace(
-          /(\/\/.*|\/\*[\s\S]*?\*\/)/g,
-          '<span class="token comment">$1</span>'
-        );
-        
-        // Functions
-        highlighted = highlighted.replace(
-          /\b([a-zA-Z_$][a-zA-Z0-9_$]*)\s*\(/g,
-          '<span class="token function">$1</span>('
-        );
-        
-        codeEl.innerHTML = highlighted;
-      });
+    response.send(200, "application/json", ("{\"deleted\":" + id + "}").c_str());
+  }
+
+  bool persisting() const { return persistState.load(std::memory_order_acquire) == KB_PERSIST_RUNNING; }
+
+  // Write every entry to the image partition as one compacted image and
+  // serve from it. The flash is erased and written on a task of its own,
+  // so connections keep being served; GET /kb/persist reports the outcome
+  void handlePersist(HttpRequest& request, HttpResponse& response) {
+    PROFILE_ZONE("http.kb_persist");
+    if (imageStorage == nullptr) {
+      response.send(503, "text/plain", "No knowledge base partition");
+      return;
     }
-    
-    function addToHistory(role, text) {
-      const historyDiv = document.getElementById('chat-history');
-      const entry = document.createElement('div');
-      entry.className = `chat-entry ${role}`;
-      
-      // Format code blocks if this is an assistant message
-      let processedText = text;
-      if (role === 'assistant') {
-        processedText = formatCodeBlocks(text);
-      }
-      
-      entry.innerHTML = `<div class="chat-bubble">${processedText}</div>`;
-      historyDiv.appendChild(entry);
-      
-      // Apply syntax highlighting
-      if (role === 'assistant') {
-        highlightSyntax(entry);
-      }
-      
-      // Scroll to bottom
-      historyDiv.scrollTop = historyDiv.scrollHeight;
-      
-      // Store in history array
-      chatHistory.push({role, text});
+    // Persisting takes the writer lock an upload holds
+    if (ingest != nullptr) {
+      response.send(409, "text/plain", "A knowledge upload is in progress");
+      return;
     }
-    
-    // Handle Enter key press
-    document.getElementById('question').addEventListener('keypress', function(e) {
-      if (e.key === 'Enter') {
-        ask();
-      }
-    });
-    
-    function showInfo() {
-      addToHistory('system', 'ESP32 AI Assistant v2.0 - Enhanced with code highlighting and a modern UI. Ask me about programming, ESP32 features, or AI topics!');
+    if (persisting()) {
+      response.send(409, "text/plain", "The knowledge base is already being persisted");
+      return;
     }
-  </script>
-</body>
-</html>
-)rawliteral";
 
-public:
-  AIWebServer(int port, KnowledgeBase& knowledgeBase, OpenAIClient& aiClient) 
-    : server(port), kb(knowledgeBase), ai(aiClient) {}
-  
-  void begin() {
-    // Set up routes
-    server.on("/", HTTP_GET, [this]() {
-      handleRoot();
-    });
-    
-    server.on("/ask", HTTP_GET, [this]() {
-      handleAsk();
-    });
-    
-    // Start server
-    server.begin();
-    Serial.println("Web server started on port 80");
-  }
-  
-  void handleClient() {
-    server.handleClient();
+    persistState.store(KB_PERSIST_RUNNING, std::memory_order_release);
+    if (xTaskCreatePinnedToCore(runPersist, "kb_persist", KB_PERSIST_STACK, this, 1, nullptr,
+                                KB_PERSIST_CORE) != pdPASS) {
+      persistState.store(KB_PERSIST_FAILED, std::memory_order_release);
+      response.send(500, "text/plain", "Could not start writing the knowledge base image");
+      return;
+    }
+    response.setHeader("Location", "/kb/persist");
+    response.send(202, "application/json", "{\"state\":\"running\"}");
   }
 
-private:
-  void handleRoot() {
-    server.send(200, "text/html", mainPageTemplate);
+  void handlePersistStatus(HttpRequest& request, HttpResponse& response) {
+    static const char* const names[] = {"idle", "running", "done", "failed"};
+    uint8_t state = persistState.load(std::memory_order_acquire);
+    std::string json = std::string("{\"state\":\"") + names[state] + "\",\"size\":" + std::to_string(kb.getSize());
+    if (state == KB_PERSIST_DONE || state == KB_PERSIST_FAILED) json += ",\"ms\":" + std::to_string(persistMs);
+    json += "}";
+    response.setHeader("Cache-Control", "no-store");
+    response.send(200, "application/json", std::move(json));
   }
-  
-  void handleAsk() {
-    if (!server.hasArg("q")) {
-      server.send(400, "text/plain", "Missing question parameter");
-      return;
-    }
-    
-    String question = server.arg("q");
-    Serial.println("Question: " + question);
-    
-    // Get context from knowledge base
-    String context = kb.getBestMatch(question);
-    Serial.println("Context: " + context);
-    
-    // Create prompt with context and instructions for code formatting
-    String prompt = "Context information: " + context + "\n\n"
-                   "Question: " + question + "\n\n"
-                   "When providing code examples, please format them using markdown code blocks with language specifiers, like:\n"
-                   "```javascript\n// Your JavaScript code here\n```\n"
-                   "```cpp\n// Your C++ code here\n```\n"
-                   "For inline code, use backticks like `this`.\n\n"
-                   "Answer:";
-    
-    // Get response from OpenAI
-    String answer = ai.getResponse(prompt);
-    Serial.println("Answer: " + answer);
-    
-    // Send response
-    server.send(200, "text/plain", answer);
+
+  static void runPersist(void* self) {
+    AIWebServer* server = (AIWebServer*)self;
+    unsigned long start = millis();
+    bool ok = server->kb.persist(*server->imageStorage);
+    server->persistMs = millis() - start;
+    if (ok) {
+      LOG_INFO("Knowledge base persisted: %d entries in %u ms", server->kb.getSize(), (unsigned)server->persistMs);
+    } else {
+      LOG_ERROR("Knowledge base persist failed, entries kept in RAM");
+    }
+    server->persistState.store(ok ? KB_PERSIST_DONE : KB_PERSIST_FAILED, std::memory_order_release);
+    vTaskDelete(nullptr);
   }
 };
 
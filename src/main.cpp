@@ -5,11 +5,30 @@
 #include "../include/knowledge_base.h"
 #include "../include/openai_client.h"
 #include "../include/web_server.h"
+#include "../include/kb_benchmark.h"
+#include "../include/codec_benchmark.h"
+#include "../include/latency_histogram.h"
+
+// Loop latency percentiles are printed this often
+#ifndef LOOP_LATENCY_REPORT_MS
+#define LOOP_LATENCY_REPORT_MS 60000
+#endif
 
 // Create instances of our classes
 KnowledgeBase knowledgeBase;
+KnowledgeImageStorage knowledgeImage;
+PersistentCache responseStore;
 OpenAIClient openAI;
+#if defined(KB_SEMANTIC_SEARCH) || defined(KB_RUN_BENCHMARK)
+#ifdef KB_EMBEDDING_HASHING  // also defined by knowledge_tables.h for stand-in embeddings
+HashingEmbeddingProvider embeddingProvider;
+#else
+OpenAIEmbeddingProvider embeddingProvider(openAI);
+#endif
+#endif
 AIWebServer webServer(80, knowledgeBase, openAI);
+LatencyHistogram loopLatency;  // time spent in each pass of loop(), in us
+unsigned long loopLatencyReported = 0;
 
 void setupWiFi() {
   Serial.println("Connecting to WiFi...");
@@ -95,6 +114,7 @@ void setup() {
   // Initialize serial communication
   Serial.begin(115200);
   Serial.println("\n\n--- ESP32 AI Assistant ---");
+  asyncLog.begin();
   
   // Connect to WiFi
   setupWiFi();
@@ -102,17 +122,42 @@ void setup() {
   // Setup OTA updates
   setupOTA();
   
-  // Add some additional knowledge entries
-  knowledgeBase.addEntry("ESP32 features capabilities specs", 
-    "The ESP32 is a powerful microcontroller with dual-core processor, WiFi, Bluetooth, and extensive GPIO capabilities.", 1.2);
-  
-  knowledgeBase.addEntry("PlatformIO IDE development environment", 
-    "PlatformIO is a cross-platform IDE and unified debugger that supports many development boards including ESP32.", 1.0);
+  // Serve the knowledge base image from flash, or fall back to the compiled corpus
+  bool imagePartition = knowledgeImage.begin();
+  if (imagePartition && knowledgeBase.attachImage(knowledgeImage.data(), knowledgeImage.size())) {
+    Serial.printf("Knowledge base image loaded: %d entries\n", knowledgeBase.getSize());
+  } else {
+    Serial.printf("No valid knowledge base image, using %d built-in entries\n", knowledgeBase.getSize());
+  }
   
-  knowledgeBase.addEntry("Arduino framework programming", 
-    "The Arduino framework provides a simple and accessible way to program microcontrollers with C/C++.", 1.0);
+  // Cached answers from before the last reboot or OTA update
+  if (responseStore.begin()) {
+    openAI.setPersistentCache(&responseStore);
+    Serial.printf("Response cache on flash: %u answers\n", responseStore.stats().records);
+  } else {
+    Serial.println("No cache partition, caching responses in RAM only");
+  }
   
-  // Start the web server
+#ifdef KB_SEMANTIC_SEARCH
+  // Semantic search needs entry embeddings from tools/kb_embed.py
+  knowledgeBase.setSearchMode(KB_SEARCH_SEMANTIC, &embeddingProvider);
+  if (!knowledgeBase.semanticAvailable()) {
+    Serial.println("No compiled embeddings, using keyword search");
+  }
+#elif defined(KB_RUN_BENCHMARK)
+  // The benchmark measures both modes; questions still use keywords
+  knowledgeBase.setSearchMode(KB_SEARCH_KEYWORD, &embeddingProvider);
+#endif
+  
+#ifdef KB_RUN_BENCHMARK
+  KnowledgeBenchmark::run(knowledgeBase, Serial);
+#endif
+#ifdef CODEC_RUN_BENCHMARK
+  ResponseCodecBenchmark::run(Serial);
+#endif
+  
+  // Start the web server; POST /kb/persist writes to the image partition
+  if (imagePartition) webServer.setImageStorage(&knowledgeImage);
   webServer.begin();
   
   Serial.println("System ready!");
@@ -127,10 +172,14 @@ void setup() {
 }
 
 void loop() {
+  unsigned long passStart = micros();
+  
   // Handle OTA updates
   ArduinoOTA.handle();
   
-  // Handle web server clients
+  // Handle web server clients. Questions are answered by the web
+  // server's worker task, which also compacts the flash cache and closes
+  // the idle API connection
   webServer.handleClient();
   
   // Monitor WiFi connection and reconnect if needed
@@ -154,6 +203,23 @@ void loop() {
     Serial.println("\nWiFi reconnected!");
   }
   
+  // Show that nothing holds up the loop
+  loopLatency.record(micros() - passStart);
+  if (millis() - loopLatencyReported > LOOP_LATENCY_REPORT_MS) {
+    LOG_INFO("Loop latency: %u samples, p50 %u us, p95 %u us, p99 %u us, max %u us",
+             (unsigned)loopLatency.count(), (unsigned)loopLatency.percentile(0.50f),
+             (unsigned)loopLatency.percentile(0.95f), (unsigned)loopLatency.percentile(0.99f),
+             (unsigned)loopLatency.maxValue());
+    loopLatency.reset();
+    const AskWorkerStats& asks = webServer.askStats();
+    LOG_INFO("Questions: %u asked, %u cached, %u from the API, %u coalesced (API calls saved)",
+             (unsigned)asks.submitted, (unsigned)asks.cached, (unsigned)asks.requested, (unsigned)asks.coalesced);
+    LOG_INFO("Questions turned away: %u (%u slots full, %u low heap, %u rate limited)",
+             (unsigned)(asks.rejected + asks.shed + webServer.askRateLimited()), (unsigned)asks.rejected,
+             (unsigned)asks.shed, (unsigned)webServer.askRateLimited());
+    loopLatencyReported = millis();
+  }
+  
   // Small delay to prevent watchdog timer issues
   delay(10);
 }
@@ -0,0 +1,70 @@
+// Host tests of semantic search over the compiled corpus embeddings:
+//   pio test -e native -f test_embedding_index
+
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unity.h>
+#include "knowledge_tables.h"
+
+struct Match {
+  int index;
+  float score;
+};
+
+static std::vector<float> embed(const std::string& text) {
+  HashingEmbeddingProvider provider;
+  std::vector<float> vector(kbCompiledEmbeddings.dim);
+  TEST_ASSERT_TRUE(provider.embed(text.data(), text.size(), vector.data(), vector.size()));
+  return vector;
+}
+
+static std::string entryText(size_t index) {
+  KnowledgeImage image;
+  image.open(kbCompiledTables);
+  const KnowledgeRecord& record = image.record(index);
+  return std::string(image.keywords(index), record.keywordsLength) + "\n" +
+         std::string(image.content(index), record.contentLength);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_corpus_is_embedded() {
+  TEST_ASSERT_EQUAL_UINT32(kbCompiledTables.entryCount, kbCompiledEmbeddings.count);
+  TEST_ASSERT_EQUAL_UINT32(0, kbCompiledEmbeddings.dim % KB_EMBEDDING_ALIGN);
+  TEST_ASSERT_TRUE(kbCompiledEmbeddings.dim > 0);
+}
+
+// tools/kb_embed.py and HashingEmbeddingProvider must agree: the query
+// embedding of an entry's own text finds that entry, nearly identical
+void test_offline_and_query_embeddings_agree() {
+  EmbeddingIndex index;
+  index.open(kbCompiledEmbeddings);
+  for (size_t i = 0; i < kbCompiledEmbeddings.count; i++) {
+    std::vector<float> vector = embed(entryText(i));
+    Match best[1];
+    TEST_ASSERT_EQUAL_UINT32(1, index.search(vector.data(), best, 1, 0.0f));
+    TEST_ASSERT_EQUAL_INT((int)i, best[0].index);
+    TEST_ASSERT_TRUE(best[0].score > 0.95f);
+  }
+}
+
+void test_results_are_ranked() {
+  EmbeddingIndex index;
+  index.open(kbCompiledEmbeddings);
+  std::vector<float> vector = embed("esp32 wifi bluetooth microcontroller");
+  Match matches[3];
+  size_t found = index.search(vector.data(), matches, 3, 0.0f);
+  TEST_ASSERT_TRUE(found >= 2);
+  for (size_t i = 1; i < found; i++) TEST_ASSERT_TRUE(matches[i - 1].score >= matches[i].score);
+  TEST_ASSERT_EQUAL_STRING("ESP32 microcontroller wifi bluetooth", entryText(matches[0].index).substr(0, 36).c_str());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_corpus_is_embedded);
+  RUN_TEST(test_offline_and_query_embeddings_agree);
+  RUN_TEST(test_results_are_ranked);
+  return UNITY_END();
+}
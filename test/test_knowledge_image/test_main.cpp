@@ -0,0 +1,128 @@
+// Host tests of the knowledge base image against a plain file:
+//   pio test -e native -f test_knowledge_image
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unity.h>
+#include "knowledge_image.h"
+
+static std::string imagePath;
+
+static void addEntry(KnowledgeStore& store, const char* keywords, const char* content, float importance) {
+  TEST_ASSERT_TRUE(store.addEntry(keywords, strlen(keywords), content, strlen(content), importance));
+}
+
+static void buildStore(KnowledgeStore& store) {
+  addEntry(store, "esp32 wifi bluetooth", "The ESP32 is a microcontroller with WiFi and Bluetooth.", 1.0f);
+  addEntry(store, "arduino ide", "Arduino is an open-source electronics platform.", 0.8f);
+  addEntry(store, "pwm ledc", "PWM on the ESP32 is provided by the LEDC peripheral.", 1.2f);
+  store.finalize();
+}
+
+static void assertContent(const KnowledgeImage& image, size_t index, const char* expected) {
+  const KnowledgeRecord& record = image.record(index);
+  TEST_ASSERT_EQUAL_UINT32(strlen(expected), record.contentLength);
+  TEST_ASSERT_EQUAL_INT(0, memcmp(image.content(index), expected, record.contentLength));
+}
+
+static bool hasToken(const KnowledgeImage& image, const char* word) {
+  size_t length = strlen(word);
+  size_t position = image.lowerBound(word, length);
+  return position < image.tokenCount() && image.token(position).length == length &&
+         image.tokenStartsWith(position, word, length);
+}
+
+// A copy of the image in 4-byte aligned memory, as open() requires
+static std::vector<uint32_t> copyImage(const KnowledgeImageStorage& storage) {
+  std::vector<uint32_t> copy((storage.size() + 3) / 4);
+  memcpy(copy.data(), storage.data(), storage.size());
+  return copy;
+}
+
+void setUp() {
+  imagePath = std::string(P_tmpdir) + "/kb_image_test.bin";
+  remove(imagePath.c_str());
+}
+
+void tearDown() {
+  remove(imagePath.c_str());
+}
+
+void test_write_and_open() {
+  KnowledgeImageStorage storage;
+  TEST_ASSERT_FALSE(storage.begin(imagePath.c_str()));  // no file yet
+
+  KnowledgeStore store;
+  buildStore(store);
+  TEST_ASSERT_TRUE(storage.write(store));
+  TEST_ASSERT_EQUAL_UINT32(KnowledgeImageWriter::imageSize(store), storage.size());
+
+  KnowledgeImage image;
+  TEST_ASSERT_TRUE(image.open(storage.data(), storage.size()));
+  TEST_ASSERT_EQUAL_UINT32(3, image.size());
+  assertContent(image, 0, "The ESP32 is a microcontroller with WiFi and Bluetooth.");
+  assertContent(image, 2, "PWM on the ESP32 is provided by the LEDC peripheral.");
+  TEST_ASSERT_EQUAL_FLOAT(0.8f, image.record(1).importance);
+  TEST_ASSERT_TRUE(hasToken(image, "ledc"));
+  TEST_ASSERT_TRUE(hasToken(image, "esp32"));
+  TEST_ASSERT_FALSE(hasToken(image, "zigbee"));
+}
+
+void test_reopen_from_file() {
+  {
+    KnowledgeImageStorage storage;
+    storage.begin(imagePath.c_str());
+    KnowledgeStore store;
+    buildStore(store);
+    TEST_ASSERT_TRUE(storage.write(store));
+  }
+
+  KnowledgeImageStorage storage;
+  TEST_ASSERT_TRUE(storage.begin(imagePath.c_str()));
+  KnowledgeImage image;
+  TEST_ASSERT_TRUE(image.open(storage.data(), storage.size()));
+  assertContent(image, 1, "Arduino is an open-source electronics platform.");
+}
+
+void test_rejects_corrupted_payload() {
+  KnowledgeImageStorage storage;
+  storage.begin(imagePath.c_str());
+  KnowledgeStore store;
+  buildStore(store);
+  TEST_ASSERT_TRUE(storage.write(store));
+
+  // The last byte is entry text, covered only by the payload CRC
+  std::vector<uint32_t> copy = copyImage(storage);
+  uint8_t* bytes = (uint8_t*)copy.data();
+  KnowledgeImage image;
+  TEST_ASSERT_TRUE(image.open(bytes, storage.size()));
+  bytes[storage.size() - 1] ^= 0x20;
+  TEST_ASSERT_FALSE(image.open(bytes, storage.size()));
+}
+
+void test_rejects_corrupted_header() {
+  KnowledgeImageStorage storage;
+  storage.begin(imagePath.c_str());
+  KnowledgeStore store;
+  buildStore(store);
+  TEST_ASSERT_TRUE(storage.write(store));
+
+  std::vector<uint32_t> copy = copyImage(storage);
+  uint8_t* bytes = (uint8_t*)copy.data();
+  bytes[offsetof(KnowledgeImageHeader, entryCount)] ^= 0x01;
+  KnowledgeImage image;
+  TEST_ASSERT_FALSE(image.open(bytes, storage.size()));
+  TEST_ASSERT_FALSE(image.open(bytes, sizeof(KnowledgeImageHeader) - 1));  // truncated
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_write_and_open);
+  RUN_TEST(test_reopen_from_file);
+  RUN_TEST(test_rejects_corrupted_payload);
+  RUN_TEST(test_rejects_corrupted_header);
+  return UNITY_END();
+}
\ No newline at end of file
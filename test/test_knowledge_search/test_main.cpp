@@ -0,0 +1,109 @@
+// Host tests of BM25 keyword ranking and the trigram typo fallback:
+//   pio test -e native -f test_knowledge_search
+
+#include <string.h>
+#include <vector>
+#include <unity.h>
+#include "knowledge_snapshot.h"
+
+static void add(KnowledgeSnapshot& snapshot, const char* keywords, float importance = 1.0f) {
+  TEST_ASSERT_TRUE(snapshot.addEntry(keywords, strlen(keywords), keywords, strlen(keywords), importance));
+}
+
+static std::vector<KnowledgeMatch> search(const KnowledgeSnapshot& snapshot, const char* query,
+                                          int maxResults = 3, float minScore = 0.0f) {
+  return snapshot.findKeywordMatches(query, strlen(query), maxResults, minScore);
+}
+
+// Entries sharing common words, and one rare word each
+static void addCorpus(KnowledgeSnapshot& snapshot) {
+  add(snapshot, "esp32 wifi station");                  // 0
+  add(snapshot, "esp32 bluetooth pairing");             // 1
+  add(snapshot, "esp32 deep sleep power");              // 2
+  add(snapshot, "arduino library manager");             // 3
+  add(snapshot, "esp32 wifi access point softap");      // 4
+  add(snapshot, "partition table flash");               // 5
+  snapshot.finalize();
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// A rare word outweighs a word every other entry has
+void test_bm25_ordering() {
+  KnowledgeSnapshot snapshot;
+  addCorpus(snapshot);
+
+  std::vector<KnowledgeMatch> matches = search(snapshot, "esp32 bluetooth");
+  TEST_ASSERT_EQUAL(3, (int)matches.size());
+  TEST_ASSERT_EQUAL(1, matches[0].index);
+  for (size_t i = 1; i < matches.size(); i++) {
+    TEST_ASSERT_TRUE(matches[i - 1].score >= matches[i].score);
+  }
+
+  // Both words hit entry 0, the shorter of the two wifi entries
+  matches = search(snapshot, "How do I set up the WiFi station?");
+  TEST_ASSERT_EQUAL(0, matches[0].index);
+  TEST_ASSERT_EQUAL(4, matches[1].index);
+}
+
+void test_top_k_and_min_score() {
+  KnowledgeSnapshot snapshot;
+  addCorpus(snapshot);
+
+  TEST_ASSERT_EQUAL(4, (int)search(snapshot, "esp32", 10).size());
+  TEST_ASSERT_EQUAL(2, (int)search(snapshot, "esp32", 2).size());
+  TEST_ASSERT_EQUAL(0, (int)search(snapshot, "esp32", 0).size());
+  TEST_ASSERT_EQUAL(0, (int)search(snapshot, "esp32", 10, 100.0f).size());
+  TEST_ASSERT_EQUAL(0, (int)search(snapshot, "what is the", 10).size());
+
+  // Equal scores keep the earlier entry first
+  std::vector<KnowledgeMatch> matches = search(snapshot, "esp32", 2);
+  TEST_ASSERT_EQUAL(0, matches[0].index);
+  TEST_ASSERT_EQUAL(1, matches[1].index);
+}
+
+void test_importance_and_prefix() {
+  KnowledgeSnapshot snapshot;
+  add(snapshot, "sensor calibration");
+  add(snapshot, "sensor wiring", 3.0f);
+  snapshot.finalize();
+
+  std::vector<KnowledgeMatch> matches = search(snapshot, "sensors");
+  TEST_ASSERT_EQUAL(2, (int)matches.size());
+  TEST_ASSERT_EQUAL(1, matches[0].index);
+
+  // "calib" is a prefix of one keyword only
+  matches = search(snapshot, "calib");
+  TEST_ASSERT_EQUAL(1, (int)matches.size());
+  TEST_ASSERT_EQUAL(0, matches[0].index);
+}
+
+// Words without a prefix hit fall back to keywords with similar trigrams
+void test_typo_fallback() {
+  KnowledgeSnapshot snapshot;
+  addCorpus(snapshot);
+
+  std::vector<KnowledgeMatch> matches = search(snapshot, "bluetoth");
+  TEST_ASSERT_EQUAL(1, (int)matches.size());
+  TEST_ASSERT_EQUAL(1, matches[0].index);
+
+  matches = search(snapshot, "partiton");
+  TEST_ASSERT_EQUAL(5, matches[0].index);
+
+  // Exact hits score above fuzzy ones
+  TEST_ASSERT_TRUE(search(snapshot, "bluetooth")[0].score > search(snapshot, "bluetoth")[0].score);
+
+  // Too short to be matched fuzzily
+  TEST_ASSERT_EQUAL(0, (int)search(snapshot, "wfi").size());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_bm25_ordering);
+  RUN_TEST(test_top_k_and_min_score);
+  RUN_TEST(test_importance_and_prefix);
+  RUN_TEST(test_typo_fallback);
+  return UNITY_END();
+}
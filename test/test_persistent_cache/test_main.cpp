@@ -0,0 +1,161 @@
+// Host tests of the flash response cache against a plain file:
+//   pio test -e native -f test_persistent_cache
+
+// Room for compaction to copy everything at once
+#define PCACHE_WRITE_BUDGET (16 * 1024 * 1024)
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unity.h>
+#include "persistent_cache.h"
+
+// Two 16 KB regions
+#define TEST_CACHE_SIZE (8 * PCACHE_SECTOR_SIZE)
+
+static std::string cachePath;
+
+static std::vector<uint8_t> value(uint8_t fill, size_t length) {
+  return std::vector<uint8_t>(length, fill);
+}
+
+static bool put(PersistentCache& cache, uint64_t key, const std::vector<uint8_t>& data,
+                uint32_t ttl = PCACHE_DEFAULT_TTL) {
+  return cache.put(key, data.data(), data.size(), ttl);
+}
+
+static void assertValue(PersistentCache& cache, uint64_t key, const std::vector<uint8_t>& expected) {
+  std::vector<uint8_t> out;
+  TEST_ASSERT_TRUE(cache.get(key, out));
+  TEST_ASSERT_EQUAL_UINT32(expected.size(), out.size());
+  TEST_ASSERT_TRUE(out == expected);
+}
+
+static void assertMissing(PersistentCache& cache, uint64_t key) {
+  std::vector<uint8_t> out;
+  TEST_ASSERT_FALSE(cache.get(key, out));
+}
+
+// Run background work until the next compaction has finished
+static void compact(PersistentCache& cache) {
+  uint32_t before = cache.stats().compactions;
+  for (int i = 0; i < 1000 && cache.stats().compactions == before; i++) cache.tick();
+  TEST_ASSERT_EQUAL_UINT32(before + 1, cache.stats().compactions);
+}
+
+void setUp() {
+  cachePath = std::string(P_tmpdir) + "/pcache_test.bin";
+  remove(cachePath.c_str());
+}
+
+void tearDown() {
+  remove(cachePath.c_str());
+}
+
+void test_append_and_get() {
+  PersistentCache cache;
+  TEST_ASSERT_TRUE(cache.begin(cachePath.c_str(), TEST_CACHE_SIZE));
+  TEST_ASSERT_TRUE(put(cache, 1, value('a', 10)));
+  TEST_ASSERT_TRUE(put(cache, 2, value('b', 301)));
+  TEST_ASSERT_TRUE(put(cache, 1, value('c', 7)));  // replaces the first
+  TEST_ASSERT_TRUE(put(cache, 3, value('d', 5), 0));  // expires at once
+
+  assertValue(cache, 1, value('c', 7));
+  assertValue(cache, 2, value('b', 301));
+  assertMissing(cache, 3);
+  assertMissing(cache, 4);
+  TEST_ASSERT_FALSE(put(cache, 5, value('e', PCACHE_MAX_VALUE + 1)));
+  TEST_ASSERT_EQUAL_UINT32(2, cache.stats().records);
+}
+
+void test_reopen() {
+  {
+    PersistentCache cache;
+    TEST_ASSERT_TRUE(cache.begin(cachePath.c_str(), TEST_CACHE_SIZE));
+    TEST_ASSERT_TRUE(put(cache, 1, value('a', 10)));
+    TEST_ASSERT_TRUE(put(cache, 2, value('b', 301)));
+    TEST_ASSERT_TRUE(put(cache, 1, value('c', 7)));
+  }
+
+  PersistentCache cache;
+  TEST_ASSERT_TRUE(cache.begin(cachePath.c_str(), TEST_CACHE_SIZE));
+  TEST_ASSERT_EQUAL_UINT32(2, cache.stats().records);
+  assertValue(cache, 1, value('c', 7));
+  assertValue(cache, 2, value('b', 301));
+}
+
+// Power lost after a value was written but before its header: the record
+// must not appear, and the log is compacted before it is appended to
+void test_torn_write() {
+  uint32_t tail;
+  {
+    PersistentCache cache;
+    TEST_ASSERT_TRUE(cache.begin(cachePath.c_str(), TEST_CACHE_SIZE));
+    TEST_ASSERT_TRUE(put(cache, 1, value('a', 10)));
+    TEST_ASSERT_TRUE(put(cache, 2, value('b', 20)));
+    tail = cache.used();  // the first region starts at offset 0
+  }
+  {
+    PersistentCacheStorage storage;
+    TEST_ASSERT_TRUE(storage.begin(cachePath.c_str(), TEST_CACHE_SIZE));
+    std::vector<uint8_t> torn = value('x', 64);
+    TEST_ASSERT_TRUE(storage.write(tail + sizeof(PersistentCacheRecord), torn.data(), torn.size()));
+  }
+
+  PersistentCache cache;
+  TEST_ASSERT_TRUE(cache.begin(cachePath.c_str(), TEST_CACHE_SIZE));
+  TEST_ASSERT_EQUAL_UINT32(2, cache.stats().records);
+  assertValue(cache, 1, value('a', 10));
+  assertValue(cache, 2, value('b', 20));
+  TEST_ASSERT_FALSE(put(cache, 3, value('c', 30)));
+
+  compact(cache);
+  TEST_ASSERT_TRUE(put(cache, 3, value('c', 30)));
+
+  PersistentCache reopened;
+  TEST_ASSERT_TRUE(reopened.begin(cachePath.c_str(), TEST_CACHE_SIZE));
+  TEST_ASSERT_EQUAL_UINT32(3, reopened.stats().records);
+  assertValue(reopened, 1, value('a', 10));
+  assertValue(reopened, 3, value('c', 30));
+}
+
+// Rewriting the same keys fills the log with dead records; compaction
+// keeps only the newest value of each and switches regions
+void test_compaction() {
+  PersistentCache cache;
+  TEST_ASSERT_TRUE(cache.begin(cachePath.c_str(), TEST_CACHE_SIZE));
+  uint32_t regionSize = TEST_CACHE_SIZE / 2;
+  uint8_t round = 0;
+  while (cache.used() * 100 < regionSize * PCACHE_COMPACT_PERCENT) {
+    round++;
+    for (uint64_t key = 1; key <= 4; key++) {
+      TEST_ASSERT_TRUE(put(cache, key, value(round + key, 200)));
+    }
+  }
+  TEST_ASSERT_TRUE(put(cache, 9, value('e', 50), 0));  // expired, not copied
+  uint32_t before = cache.used();
+
+  compact(cache);
+  TEST_ASSERT_LESS_THAN(before / 4, cache.used());
+  TEST_ASSERT_EQUAL_UINT32(4, cache.stats().records);
+  for (uint64_t key = 1; key <= 4; key++) assertValue(cache, key, value(round + key, 200));
+
+  // The new region is the one found at boot
+  TEST_ASSERT_TRUE(put(cache, 5, value('f', 40)));
+  PersistentCache reopened;
+  TEST_ASSERT_TRUE(reopened.begin(cachePath.c_str(), TEST_CACHE_SIZE));
+  TEST_ASSERT_EQUAL_UINT32(5, reopened.stats().records);
+  assertValue(reopened, 4, value(round + 4, 200));
+  assertValue(reopened, 5, value('f', 40));
+  assertMissing(reopened, 9);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_append_and_get);
+  RUN_TEST(test_reopen);
+  RUN_TEST(test_torn_write);
+  RUN_TEST(test_compaction);
+  return UNITY_END();
+}
\ No newline at end of file
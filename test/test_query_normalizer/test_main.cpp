@@ -0,0 +1,77 @@
+// Host tests of query normalization and keyword tokenization:
+//   pio test -e native -f test_query_normalizer
+
+#include <string.h>
+#include <string>
+#include <unity.h>
+#include "query_normalizer.h"
+
+static std::string normalize(const char* query) {
+  char out[KB_MAX_QUERY_LENGTH + 1];
+  size_t length = QueryNormalizer::normalize(query, strlen(query), out, sizeof(out));
+  return std::string(out, length);
+}
+
+static std::string normalizeQuestion(const char* query) {
+  char out[KB_MAX_QUERY_LENGTH + 1];
+  size_t length = QueryNormalizer::normalizeQuestion(query, strlen(query), out, sizeof(out));
+  return std::string(out, length);
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_stopwords_and_punctuation() {
+  TEST_ASSERT_EQUAL_STRING("wifi password", normalize("What is the Wi-Fi password?").c_str());
+  TEST_ASSERT_EQUAL_STRING("c++ c#", normalize("  C++, C#!  ").c_str());
+  TEST_ASSERT_EQUAL_STRING("", normalize("how do I ... ?").c_str());
+}
+
+void test_synonyms() {
+  TEST_ASSERT_EQUAL_STRING("bluetooth python", normalize("BT and py").c_str());
+  TEST_ASSERT_EQUAL_STRING("c++ javascript", normalize("cpp or js").c_str());
+}
+
+void test_stems() {
+  TEST_ASSERT_EQUAL_STRING("librar process box switch", normalize("libraries processes boxes switches").c_str());
+  TEST_ASSERT_EQUAL_STRING("board sensor creat connect", normalize("boards sensors created connecting").c_str());
+  // Short words and non-plural endings stay whole
+  TEST_ASSERT_EQUAL_STRING("gas bus status analysis us", normalize("gas bus status analysis us").c_str());
+}
+
+void test_question_signature() {
+  // Question words and negations survive, nothing is stemmed or rewritten
+  TEST_ASSERT_EQUAL_STRING("where not bt libraries live",
+                           normalizeQuestion("Where does not BT libraries live?").c_str());
+  TEST_ASSERT_EQUAL_STRING("how when", normalizeQuestion("Hi, how? when?").c_str());
+}
+
+// Keywords split like queries, so punctuated keywords meet normalized words
+void test_keyword_tokens() {
+  KnowledgeStore store;
+  const char* keywords = "WiFi, c++/arduino wi-fi";
+  TEST_ASSERT_TRUE(store.addEntry(keywords, strlen(keywords), "x", 1, 1.0f));
+  store.finalize();
+
+  TEST_ASSERT_EQUAL_UINT32(4, store.record(0).tokenCount);
+  TEST_ASSERT_EQUAL_UINT32(3, store.tokenCount());
+  TEST_ASSERT_EQUAL_STRING("wifi", store.tokenText(0));
+  TEST_ASSERT_EQUAL_STRING("c++", store.tokenText(1));
+  TEST_ASSERT_EQUAL_STRING("arduino", store.tokenText(2));
+
+  std::string word = normalize("wifi,");
+  size_t position = store.lowerBound(word.c_str(), word.size());
+  TEST_ASSERT_LESS_THAN(store.sortedTokenCount(), position);
+  TEST_ASSERT_TRUE(store.tokenStartsWith(store.sortedToken(position), word.c_str(), word.size()));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_stopwords_and_punctuation);
+  RUN_TEST(test_synonyms);
+  RUN_TEST(test_stems);
+  RUN_TEST(test_question_signature);
+  RUN_TEST(test_keyword_tokens);
+  return UNITY_END();
+}
@@ -0,0 +1,67 @@
+// Host tests of the per-client token bucket:
+//   pio test -e native -f test_rate_limiter
+
+// Few enough clients to fill the table
+#define RATE_LIMIT_CLIENTS 2
+
+#include <unity.h>
+#include "rate_limiter.h"
+
+void setUp() {}
+
+void tearDown() {}
+
+// A full bucket allows a burst, then one request per refill interval
+void test_burst_then_refill() {
+  RateLimiter limiter(60, 3);  // one token a second
+  for (int i = 0; i < 3; i++) TEST_ASSERT_EQUAL_UINT32(0, limiter.take(1, 1000));
+
+  uint32_t wait = limiter.take(1, 1000);
+  TEST_ASSERT_UINT32_WITHIN(2, 1000, wait);
+  TEST_ASSERT_EQUAL_UINT32(1, limiter.refusedCount());
+
+  TEST_ASSERT_TRUE(limiter.take(1, 1500) > 0);  // half a token
+  TEST_ASSERT_EQUAL_UINT32(0, limiter.take(1, 1000 + wait));
+  TEST_ASSERT_TRUE(limiter.take(1, 1000 + wait) > 0);
+}
+
+// Refill stops at the burst size however long the client was idle
+void test_refill_capped_at_burst() {
+  RateLimiter limiter(60, 2);
+  TEST_ASSERT_EQUAL_UINT32(0, limiter.take(1, 0));
+  TEST_ASSERT_EQUAL_UINT32(0, limiter.take(1, 0));
+  TEST_ASSERT_EQUAL_UINT32(0, limiter.take(1, 3600000));
+  TEST_ASSERT_EQUAL_UINT32(0, limiter.take(1, 3600000));
+  TEST_ASSERT_TRUE(limiter.take(1, 3600000) > 0);
+}
+
+void test_clients_are_separate() {
+  RateLimiter limiter(60, 1);
+  TEST_ASSERT_EQUAL_UINT32(0, limiter.take(1, 0));
+  TEST_ASSERT_TRUE(limiter.take(1, 0) > 0);
+  TEST_ASSERT_EQUAL_UINT32(0, limiter.take(2, 0));
+
+  // A third client replaces the one seen longest ago, 1, which then
+  // comes back with a full bucket
+  TEST_ASSERT_TRUE(limiter.take(2, 10) > 0);
+  TEST_ASSERT_EQUAL_UINT32(0, limiter.take(3, 20));
+  TEST_ASSERT_EQUAL_UINT32(0, limiter.take(1, 30));
+}
+
+// Uptime differences keep working when millis() wraps
+void test_clock_wrap() {
+  RateLimiter limiter(60, 1);
+  unsigned long start = (unsigned long)-500;
+  TEST_ASSERT_EQUAL_UINT32(0, limiter.take(1, start));
+  TEST_ASSERT_TRUE(limiter.take(1, start + 400) > 0);
+  TEST_ASSERT_EQUAL_UINT32(0, limiter.take(1, start + 1001));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_burst_then_refill);
+  RUN_TEST(test_refill_capped_at_burst);
+  RUN_TEST(test_clients_are_separate);
+  RUN_TEST(test_clock_wrap);
+  return UNITY_END();
+}
@@ -0,0 +1,107 @@
+// Host tests of the byte-bounded LRU response cache:
+//   pio test -e native -f test_response_cache
+
+#include <vector>
+#include <unity.h>
+#include "response_cache.h"
+
+static std::vector<uint8_t> value(uint8_t fill, size_t length) {
+  return std::vector<uint8_t>(length, fill);
+}
+
+static void put(ResponseCache& cache, uint64_t key, const std::vector<uint8_t>& data) {
+  cache.put(key, data.data(), data.size());
+}
+
+static bool has(ResponseCache& cache, uint64_t key) {
+  std::vector<uint8_t> out;
+  return cache.get(key, out);
+}
+
+// Budget for exactly n entries of the given value length
+static size_t budgetFor(size_t n, size_t length) {
+  return n * (length + ResponseCache::entryOverhead());
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_get_and_replace() {
+  ResponseCache cache(budgetFor(4, 100));
+  put(cache, 1, value('a', 100));
+  put(cache, 1, value('b', 60));
+
+  std::vector<uint8_t> out;
+  TEST_ASSERT_TRUE(cache.get(1, out));
+  TEST_ASSERT_TRUE(out == value('b', 60));
+  TEST_ASSERT_FALSE(cache.get(2, out));
+  TEST_ASSERT_EQUAL_UINT32(1, cache.stats().entries);
+  TEST_ASSERT_EQUAL_UINT32(60 + ResponseCache::entryOverhead(), cache.stats().bytes);
+  TEST_ASSERT_EQUAL_UINT32(1, cache.stats().hits);
+  TEST_ASSERT_EQUAL_UINT32(1, cache.stats().misses);
+}
+
+// The least recently used entry goes first once the byte budget is full
+void test_lru_eviction_under_byte_budget() {
+  ResponseCache cache(budgetFor(3, 100));
+  put(cache, 1, value('a', 100));
+  put(cache, 2, value('b', 100));
+  put(cache, 3, value('c', 100));
+  TEST_ASSERT_TRUE(has(cache, 1));  // 2 is now the oldest
+
+  put(cache, 4, value('d', 100));
+  TEST_ASSERT_FALSE(has(cache, 2));
+  TEST_ASSERT_TRUE(has(cache, 1));
+  TEST_ASSERT_TRUE(has(cache, 3));
+  TEST_ASSERT_TRUE(has(cache, 4));
+  TEST_ASSERT_EQUAL_UINT32(1, cache.stats().evictions);
+
+  // A large value evicts as many old entries as it needs
+  put(cache, 5, value('e', 200));
+  TEST_ASSERT_EQUAL_UINT32(2, cache.stats().entries);
+  TEST_ASSERT_TRUE(has(cache, 5));
+  TEST_ASSERT_TRUE(has(cache, 4));
+  TEST_ASSERT_TRUE(cache.stats().bytes <= budgetFor(3, 100));
+}
+
+void test_entry_limit_and_oversize() {
+  ResponseCache cache(budgetFor(10, 100), 2);
+  put(cache, 1, value('a', 10));
+  put(cache, 2, value('b', 10));
+  put(cache, 3, value('c', 10));
+  TEST_ASSERT_EQUAL_UINT32(2, cache.stats().entries);
+  TEST_ASSERT_FALSE(has(cache, 1));
+
+  // Larger than the whole budget: skipped, nothing evicted
+  put(cache, 4, value('d', budgetFor(10, 100)));
+  TEST_ASSERT_FALSE(has(cache, 4));
+  TEST_ASSERT_EQUAL_UINT32(2, cache.stats().entries);
+}
+
+// Freed nodes are reused and the accounting returns to zero
+void test_remove_and_clear() {
+  ResponseCache cache(budgetFor(3, 100));
+  for (uint64_t key = 1; key <= 50; key++) {
+    put(cache, key, value(key, 100));
+    if (key % 2 == 0) TEST_ASSERT_TRUE(cache.remove(key));
+  }
+  TEST_ASSERT_FALSE(cache.remove(50));
+  TEST_ASSERT_TRUE(cache.stats().entries <= 3);
+
+  cache.clear();
+  TEST_ASSERT_EQUAL_UINT32(0, cache.stats().entries);
+  TEST_ASSERT_EQUAL_UINT32(0, cache.stats().bytes);
+  TEST_ASSERT_FALSE(has(cache, 49));
+  put(cache, 7, value('g', 10));
+  TEST_ASSERT_TRUE(has(cache, 7));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_get_and_replace);
+  RUN_TEST(test_lru_eviction_under_byte_budget);
+  RUN_TEST(test_entry_limit_and_oversize);
+  RUN_TEST(test_remove_and_clear);
+  return UNITY_END();
+}
@@ -0,0 +1,104 @@
+// Host tests of the DEFLATE response codec:
+//   pio test -e native -f test_response_codec
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <unity.h>
+#include "response_codec.h"
+
+static bool decode(const std::vector<uint8_t>& blob, std::string& out, size_t* chunks = nullptr) {
+  out.clear();
+  return ResponseCodec::decode(blob.data(), blob.size(), [&](const uint8_t* data, size_t length) {
+    out.append((const char*)data, length);
+    if (chunks != nullptr) (*chunks)++;
+  });
+}
+
+static void assertRoundTrip(const std::string& text) {
+  std::vector<uint8_t> blob;
+  ResponseCodec::encode(text.data(), text.size(), blob);
+  TEST_ASSERT_TRUE(ResponseCodec::valid(blob.data(), blob.size()));
+  TEST_ASSERT_EQUAL_UINT32(text.size(), ResponseCodec::rawLength(blob.data()));
+
+  std::string out;
+  TEST_ASSERT_TRUE(decode(blob, out));
+  TEST_ASSERT_TRUE(out == text);
+}
+
+static std::string prose(size_t length) {
+  static const char* words[] = {"the ", "ESP32 ", "wifi ", "connects ", "to ", "an ", "access ", "point. "};
+  std::string text;
+  for (size_t i = 0; text.size() < length; i++) text += words[(i * 7 + i / 3) % 8];
+  text.resize(length);
+  return text;
+}
+
+static std::string noise(size_t length, unsigned seed) {
+  std::string text(length, '\0');
+  srand(seed);
+  for (size_t i = 0; i < length; i++) text[i] = (char)(rand() & 0xFF);
+  return text;
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_round_trip() {
+  assertRoundTrip("");
+  assertRoundTrip("a");
+  assertRoundTrip("Hello, world!");
+  assertRoundTrip(std::string(1000, 'x'));  // one long run of matches
+  assertRoundTrip(prose(5000));
+}
+
+// Incompressible text goes into stored blocks
+void test_round_trip_stored() {
+  assertRoundTrip(noise(3000, 1));
+}
+
+// More tokens than one block and matches across the decoder window
+void test_round_trip_large() {
+  std::string text = prose(RESPONSE_CODEC_MAX_LENGTH / 2) + noise(2000, 2) + prose(RESPONSE_CODEC_MAX_LENGTH / 4);
+  assertRoundTrip(text);
+
+  std::vector<uint8_t> blob;
+  ResponseCodec::encode(text.data(), text.size(), blob);
+  TEST_ASSERT_TRUE(blob.size() < text.size() / 2);
+
+  std::string out;
+  size_t chunks = 0;
+  TEST_ASSERT_TRUE(decode(blob, out, &chunks));
+  TEST_ASSERT_TRUE(chunks >= text.size() / RESPONSE_CODEC_WINDOW);
+}
+
+void test_corruption_detected() {
+  std::string text = prose(2000);
+  std::vector<uint8_t> blob;
+  ResponseCodec::encode(text.data(), text.size(), blob);
+  std::string out;
+
+  std::vector<uint8_t> bad = blob;
+  bad[0] ^= 1;  // CRC
+  TEST_ASSERT_FALSE(decode(bad, out));
+
+  bad = blob;
+  bad[bad.size() / 2] ^= 0x10;  // stream
+  TEST_ASSERT_FALSE(decode(bad, out));
+
+  bad.assign(blob.begin(), blob.begin() + blob.size() - 4);  // truncated
+  TEST_ASSERT_FALSE(decode(bad, out));
+
+  bad.assign(blob.begin(), blob.begin() + RESPONSE_CODEC_HEADER);
+  TEST_ASSERT_FALSE(ResponseCodec::valid(bad.data(), bad.size()));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_round_trip_stored);
+  RUN_TEST(test_round_trip_large);
+  RUN_TEST(test_corruption_detected);
+  return UNITY_END();
+}
@@ -0,0 +1,78 @@
+// Host tests of the MinHash near-duplicate question cache:
+//   pio test -e native -f test_semantic_cache
+
+// Small enough to wrap around
+#define SEMANTIC_CACHE_ENTRIES 4
+
+#include <string.h>
+#include <unity.h>
+#include "semantic_cache.h"
+
+static QuestionSignature sig(const char* question) {
+  return SemanticCache::signature(question, strlen(question));
+}
+
+static float similarity(const char* a, const char* b) {
+  return SemanticCache::similarity(sig(a), sig(b));
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_paraphrases_match() {
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, similarity("What is ESP32?", "what's the esp32"));
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, similarity("How do I use deep sleep?", "hi, how do you use DEEP sleep"));
+  TEST_ASSERT_TRUE(similarity("What is ESP32?", "How much flash has the Raspberry Pi?") < 0.5f);
+}
+
+// Different question words or a negation ask something else
+void test_intent_must_match() {
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, similarity("When was Arduino created?", "Where was Arduino created?"));
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, similarity("Does the ESP32 support 5 GHz?", "Does the ESP32 not support 5 GHz?"));
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, similarity("Why can't it connect?", "Why can it connect?"));
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, similarity("", ""));
+}
+
+void test_find_by_context() {
+  SemanticCache cache;
+  cache.remember(1, sig("What is ESP32?"), 100);
+
+  uint64_t key = 0;
+  TEST_ASSERT_TRUE(cache.find(1, sig("what's the esp32"), key));
+  TEST_ASSERT_EQUAL_UINT32(100, (uint32_t)key);
+  TEST_ASSERT_FALSE(cache.find(2, sig("what's the esp32"), key));
+  TEST_ASSERT_FALSE(cache.find(1, sig("Where is ESP32?"), key));
+  TEST_ASSERT_EQUAL_UINT32(3, cache.stats().lookups);
+  TEST_ASSERT_EQUAL_UINT32(1, cache.stats().hits);
+
+  // Turned off, nothing is found or remembered
+  cache.configure(false);
+  TEST_ASSERT_FALSE(cache.find(1, sig("What is ESP32?"), key));
+  cache.configure(true, 1.5f);
+  TEST_ASSERT_FALSE(cache.find(1, sig("What is ESP32?"), key));
+}
+
+// The oldest entry is replaced once the table is full
+void test_oldest_replaced() {
+  SemanticCache cache;
+  const char* questions[] = {"what is wifi", "what is bluetooth", "what is flash", "what is psram", "what is ota"};
+  for (uint64_t i = 0; i < 5; i++) cache.remember(7, sig(questions[i]), i);
+  TEST_ASSERT_EQUAL_UINT32(SEMANTIC_CACHE_ENTRIES, cache.stats().entries);
+
+  uint64_t key = 0;
+  TEST_ASSERT_FALSE(cache.find(7, sig(questions[0]), key));
+  TEST_ASSERT_TRUE(cache.find(7, sig(questions[4]), key));
+  TEST_ASSERT_EQUAL_UINT32(4, (uint32_t)key);
+  TEST_ASSERT_TRUE(cache.find(7, sig(questions[1]), key));
+  TEST_ASSERT_EQUAL_UINT32(1, (uint32_t)key);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_paraphrases_match);
+  RUN_TEST(test_intent_must_match);
+  RUN_TEST(test_find_by_context);
+  RUN_TEST(test_oldest_replaced);
+  return UNITY_END();
+}
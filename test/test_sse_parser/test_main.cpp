@@ -0,0 +1,72 @@
+// Host tests of the incremental server-sent events parser:
+//   pio test -e native -f test_sse_parser
+
+// Short enough to overflow in a test
+#define SSE_MAX_LINE 64
+
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <unity.h>
+#include "sse_parser.h"
+
+// Feed the stream in pieces of at most step bytes and collect the events
+static std::vector<std::string> parse(const std::string& stream, size_t step) {
+  SseParser parser;
+  std::vector<std::string> events;
+  for (size_t i = 0; i < stream.size(); i += step) {
+    parser.feed(stream.data() + i, std::min(step, stream.size() - i), [&](const SseText& event) {
+      events.push_back(event);
+    });
+  }
+  return events;
+}
+
+// The same events whatever the read boundaries, down to single bytes
+static void assertEvents(const std::string& stream, const std::vector<std::string>& expected) {
+  for (size_t step = 1; step <= stream.size(); step++) {
+    std::vector<std::string> events = parse(stream, step);
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), events.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+      TEST_ASSERT_EQUAL_STRING(expected[i].c_str(), events[i].c_str());
+    }
+  }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_events_split_across_reads() {
+  assertEvents("data: {\"a\":1}\n\ndata: {\"b\":2}\n\ndata: [DONE]\n\n",
+               {"{\"a\":1}", "{\"b\":2}", "[DONE]"});
+}
+
+// CRLF and CR line ends, a CRLF split between reads included
+void test_line_endings() {
+  assertEvents("data: one\r\n\r\ndata: two\r\rdata: three\n\n", {"one", "two", "three"});
+}
+
+void test_fields_and_comments() {
+  // Data lines join with newlines; "data:" without a space keeps the rest
+  assertEvents(": keep-alive\n\nevent: delta\nid: 7\ndata: first\ndata:second\nretry: 10\n\n",
+               {"first\nsecond"});
+  // No data, no event; an unterminated event is not dispatched
+  assertEvents("event: ping\n\ndata: partial", {});
+}
+
+// An event with a line longer than SSE_MAX_LINE is dropped whole
+void test_overlong_line() {
+  std::string longLine = "data: " + std::string(SSE_MAX_LINE, 'x') + "\n";
+  assertEvents("data: keep\n" + longLine + "data: tail\n\ndata: next\n\n", {"next"});
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_events_split_across_reads);
+  RUN_TEST(test_line_endings);
+  RUN_TEST(test_fields_and_comments);
+  RUN_TEST(test_overlong_line);
+  return UNITY_END();
+}
@@ -0,0 +1,99 @@
+// Host tests of trigram extraction and Jaccard typo matching:
+//   pio test -e native -f test_trigram_index
+
+#include <string.h>
+#include <vector>
+#include <unity.h>
+#include "trigram_index.h"
+
+static KnowledgeStore store;
+static TrigramIndex trigramIndex;
+
+static uint32_t trigram(char a, char b, char c) {
+  return ((uint32_t)(uint8_t)a << 16) | ((uint32_t)(uint8_t)b << 8) | (uint8_t)c;
+}
+
+static std::vector<TrigramMatch> similar(const TrigramIndex& trigrams, const char* word,
+                                         float minSimilarity = KB_FUZZY_MIN_SIMILARITY) {
+  std::vector<TrigramMatch> matches;
+  trigrams.findSimilar(store, word, strlen(word), minSimilarity, matches);
+  return matches;
+}
+
+static const char* bestToken(const std::vector<TrigramMatch>& matches) {
+  TEST_ASSERT_FALSE(matches.empty());
+  size_t best = 0;
+  for (size_t i = 1; i < matches.size(); i++) {
+    if (matches[i].similarity > matches[best].similarity) best = i;
+  }
+  return store.tokenText(matches[best].token);
+}
+
+void setUp() {
+  store = KnowledgeStore();
+  const char* keywords[] = {"bluetooth", "partition", "deepsleep", "wifi", "arduino"};
+  for (const char* k : keywords) TEST_ASSERT_TRUE(store.addEntry(k, strlen(k), "", 0, 1.0f));
+  store.finalize();
+  trigramIndex.build(store);
+}
+
+void tearDown() {}
+
+// "^word$" windows, deduplicated and sorted
+void test_trigrams_of_word() {
+  uint32_t out[KB_MAX_TRIGRAMS];
+  TEST_ASSERT_EQUAL_UINT32(3, kbTrigrams("abc", 3, out));
+  TEST_ASSERT_EQUAL_UINT32(trigram(KB_TRIGRAM_START, 'a', 'b'), out[0]);
+  TEST_ASSERT_EQUAL_UINT32(trigram('a', 'b', 'c'), out[1]);
+  TEST_ASSERT_EQUAL_UINT32(trigram('b', 'c', KB_TRIGRAM_END), out[2]);
+
+  TEST_ASSERT_EQUAL_UINT32(3, kbTrigrams("aaaa", 4, out));  // "aaa" once
+  TEST_ASSERT_EQUAL_UINT32(1, kbTrigrams("a", 1, out));
+  TEST_ASSERT_EQUAL_UINT32(0, kbTrigrams("", 0, out));
+}
+
+// Jaccard similarity of the trigram sets: "bluetoth" shares 7 of the 10
+// trigrams in the union with "bluetooth"
+void test_jaccard_similarity() {
+  std::vector<TrigramMatch> matches = similar(trigramIndex, "bluetoth");
+  TEST_ASSERT_EQUAL(1, (int)matches.size());
+  TEST_ASSERT_EQUAL_STRING("bluetooth", bestToken(matches));
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.7f, matches[0].similarity);
+
+  matches = similar(trigramIndex, "bluetooth");
+  TEST_ASSERT_EQUAL(1, (int)matches.size());
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, matches[0].similarity);
+}
+
+void test_typo_matches() {
+  TEST_ASSERT_EQUAL_STRING("partition", bestToken(similar(trigramIndex, "partiton")));   // deletion
+  TEST_ASSERT_EQUAL_STRING("partition", bestToken(similar(trigramIndex, "partitionn"))); // insertion
+  TEST_ASSERT_EQUAL_STRING("arduino", bestToken(similar(trigramIndex, "arduinoo")));
+  TEST_ASSERT_EQUAL_STRING("deepsleep", bestToken(similar(trigramIndex, "deepslep")));
+
+  // Unrelated words and a strict threshold find nothing
+  TEST_ASSERT_TRUE(similar(trigramIndex, "camera").empty());
+  TEST_ASSERT_TRUE(similar(trigramIndex, "bluetoth", 0.8f).empty());
+}
+
+// A copy owns its tables; a view of other tables does not
+void test_copy_and_view() {
+  TrigramIndex copy = trigramIndex;
+  trigramIndex.clear();
+  TEST_ASSERT_TRUE(similar(trigramIndex, "bluetoth").empty());
+  TEST_ASSERT_EQUAL_STRING("bluetooth", bestToken(similar(copy, "bluetoth")));
+
+  TrigramIndex view;
+  view.open(copy.tables());
+  TEST_ASSERT_EQUAL_UINT32(copy.tokenIdCount(), view.tokenIdCount());
+  TEST_ASSERT_EQUAL_STRING("wifi", bestToken(similar(view, "wiffi")));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_trigrams_of_word);
+  RUN_TEST(test_jaccard_similarity);
+  RUN_TEST(test_typo_matches);
+  RUN_TEST(test_copy_and_view);
+  return UNITY_END();
+}
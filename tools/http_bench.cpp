@@ -0,0 +1,203 @@
+// Load test for include/http_server.h, built for the host. Serves a page
+// the size of the uncompressed web interface and small /ask and
+// /ask/result replies
+// from one thread polling like loop() does, while many simulated clients
+// send keep-alive requests and a few slow ones read the page a little at
+// a time. Clients pause for a think time between requests, like a page
+// polling for an answer; 0 has them send back to back. Prints throughput,
+// latency percentiles and the server counters.
+//
+//   g++ -std=gnu++17 -O2 -Wall -Wextra -Iinclude tools/http_bench.cpp -o http_bench -lpthread
+//   ./http_bench [clients] [seconds] [slow clients] [think ms]
+//
+// Add -DHTTP_MAX_CONNECTIONS=N to try other connection limits.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "http_server.h"
+
+#define BENCH_PORT 18080
+#define BENCH_PAGE_BYTES 15000
+
+static std::atomic<bool> running(true);
+static std::atomic<bool> serving(true);
+static int thinkMs = 100;
+static std::mutex samplesLock;
+static std::vector<double> pageMs;
+static std::vector<double> askMs;
+static std::atomic<uint32_t> errors(0);
+static std::atomic<uint32_t> reconnects(0);
+
+static double since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static int connectServer(int receiveBuffer = 0) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  int enable = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+  if (receiveBuffer > 0) setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+  struct timeval timeout = {10, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(BENCH_PORT);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// Send a GET and read the whole response; false if the connection was
+// closed under it, as happens to idle keep-alive connections. Clears
+// keepAlive if the server is closing the connection after this response
+static bool get(int fd, const std::string& target, bool& keepAlive, size_t readChunk = 65536, int pauseMs = 0) {
+  std::string request = "GET " + target + " HTTP/1.1\r\nHost: bench\r\n\r\n";
+  if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != (ssize_t)request.size()) return false;
+
+  std::string head;
+  char buffer[65536];
+  size_t bodyStart = std::string::npos;
+  while (bodyStart == std::string::npos) {
+    ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+    if (received <= 0) return false;
+    head.append(buffer, received);
+    bodyStart = head.find("\r\n\r\n");
+  }
+  size_t lengthAt = head.find("Content-Length: ");
+  if (lengthAt == std::string::npos) return false;
+  size_t length = strtoul(head.c_str() + lengthAt + 16, nullptr, 10);
+  keepAlive = head.find("Connection: close") == std::string::npos;
+  size_t have = head.size() - bodyStart - 4;
+  while (have < length) {
+    if (pauseMs > 0) std::this_thread::sleep_for(std::chrono::milliseconds(pauseMs));
+    ssize_t received = recv(fd, buffer, std::min(readChunk, sizeof(buffer)), 0);
+    if (received <= 0) return false;
+    have += received;
+  }
+  return have == length;
+}
+
+static void client(int index) {
+  int fd = -1;
+  std::vector<double> pages;
+  std::vector<double> asks;
+  for (uint32_t n = 0; running; n++) {
+    bool page = n % 4 == 0;
+    std::string target = page ? "/" : n % 4 == 1 ? "/ask?q=what+is+pwm+" + std::to_string(index) : "/ask/result?id=1&from=0";
+    auto start = std::chrono::steady_clock::now();
+    bool ok = false;
+    for (int attempt = 0; attempt < 2 && !ok; attempt++) {
+      if (fd < 0) fd = connectServer();
+      if (fd < 0) break;
+      bool keepAlive = false;
+      ok = get(fd, target, keepAlive);
+      if (!ok || !keepAlive) {
+        close(fd);
+        fd = -1;
+        if (!ok && attempt == 0) reconnects++;
+      }
+    }
+    if (!ok) {
+      errors++;
+      continue;
+    }
+    (page ? pages : asks).push_back(since(start));
+    if (thinkMs > 0) std::this_thread::sleep_for(std::chrono::milliseconds(thinkMs / 2 + rand() % (thinkMs + 1)));
+  }
+  if (fd >= 0) close(fd);
+  std::lock_guard<std::mutex> guard(samplesLock);
+  pageMs.insert(pageMs.end(), pages.begin(), pages.end());
+  askMs.insert(askMs.end(), asks.begin(), asks.end());
+}
+
+// Reads the page 1 KB every 50 ms through a small receive buffer, so the
+// server finds its socket full most of the time
+static void slowClient() {
+  while (running) {
+    int fd = connectServer(2048);
+    if (fd < 0) return;
+    bool keepAlive;
+    get(fd, "/", keepAlive, 1024, 50);
+    close(fd);
+  }
+}
+
+static void report(const char* name, std::vector<double>& samples, double seconds) {
+  if (samples.empty()) {
+    printf("%-6s no samples\n", name);
+    return;
+  }
+  std::sort(samples.begin(), samples.end());
+  auto at = [&](double p) { return samples[std::min(samples.size() - 1, (size_t)(p * samples.size()))]; };
+  printf("%-6s %8zu requests %9.0f/s  p50 %6.2f ms  p95 %6.2f ms  p99 %6.2f ms  max %7.2f ms\n", name,
+         samples.size(), samples.size() / seconds, at(0.50), at(0.95), at(0.99), samples.back());
+}
+
+int main(int argc, char** argv) {
+  int clients = argc > 1 ? atoi(argv[1]) : 32;
+  int seconds = argc > 2 ? atoi(argv[2]) : 5;
+  int slowClients = argc > 3 ? atoi(argv[3]) : 2;
+  if (argc > 4) thinkMs = atoi(argv[4]);
+
+  std::string page(BENCH_PAGE_BYTES, 'x');
+  HttpServer server(BENCH_PORT);
+  server.on("GET", "/", [&](HttpRequest& /*request*/, HttpResponse& response) {
+    response.sendStatic(200, "text/html", page.data(), page.size());
+  });
+  server.on("GET", "/ask", [](HttpRequest& /*request*/, HttpResponse& response) {
+    response.setHeader("Location", "/ask/result?id=1");
+    response.send(202, "application/json", "{\"id\":1}");
+  });
+  server.on("GET", "/ask/result", [](HttpRequest& /*request*/, HttpResponse& response) {
+    response.setHeader("X-Answer-Done", "1");
+    response.send(200, "text/plain", "PWM on the ESP32 is provided by the LEDC peripheral.");
+  });
+  if (!server.begin()) {
+    perror("bind");
+    return 1;
+  }
+
+  // The server thread polls the way loop() does
+  std::thread serverThread([&]() {
+    while (serving) server.poll(5);
+  });
+
+  printf("http_bench: %d clients, %d slow, %d ms think time, %d s, %d connection slots\n", clients, slowClients,
+         thinkMs, seconds, HTTP_MAX_CONNECTIONS);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < clients; i++) threads.emplace_back(client, i);
+  for (int i = 0; i < slowClients; i++) threads.emplace_back(slowClient);
+  std::this_thread::sleep_for(std::chrono::seconds(seconds));
+  running = false;
+  // Keep serving until every client has finished its last request
+  for (std::thread& thread : threads) thread.join();
+  serving = false;
+  serverThread.join();
+
+  report("page", pageMs, seconds);
+  report("ask", askMs, seconds);
+  const HttpServerStats& stats = server.stats();
+  printf("errors %u, client reconnects %u\n", errors.load(), reconnects.load());
+  printf("server: %u connections, %u requests (%u kept alive), %u evicted, %u timeouts, %u rejected, %u open max\n",
+         stats.accepted, stats.requests, stats.keptAlive, stats.evicted, stats.timeouts, stats.rejected,
+         stats.maxOpen);
+  return 0;
+}
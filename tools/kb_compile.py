@@ -0,0 +1,433 @@
+"""Compile the knowledge base corpus into flash-resident C++ tables.
+
+Reads every *.csv and *.md file in kb/ (sorted by name) and writes
+include/knowledge_tables.h with the entry records, lexically sorted token
+dictionary, posting lists, a perfect hash and a character trigram index
+over the tokens, laid out exactly like an in-RAM KnowledgeStore after
+finalize().
+
+CSV files have a header row with keywords, content and an optional
+importance column. Markdown files hold one entry per "## keywords"
+heading; an "importance: 1.2" line sets the weight and the remaining
+paragraph text is the content.
+
+Optional extras, also in kb/:
+  embeddings.jsonl  {"keywords": ..., "embedding": [...], "provider": ...}
+                    per entry, made offline by tools/kb_embed.py; quantized
+                    to int8 with one scale per vector for semantic search.
+                    Embeddings from the hashing provider define
+                    KB_EMBEDDING_HASHING so queries use the same one
+  benchmark.csv     query,keywords pairs naming the entry a query should
+                    retrieve, for the on-device retrieval benchmark
+
+Runs as a PlatformIO pre-build script or standalone:
+    python tools/kb_compile.py
+"""
+
+import csv
+import io
+import json
+import math
+import os
+import re
+import sys
+
+MAX_ENTRIES = 65535
+MAX_TOKENS = 65535
+MAX_FIELD_LENGTH = 65535
+MAX_TOKEN_LENGTH = 32
+NO_TOKEN = 0xFFFF
+MAX_SEED = 0xFFFF
+EMBEDDING_ALIGN = 16
+MAX_EMBEDDING_DIM = 1024
+
+
+def fnv1a(data, seed=0):
+    h = 2166136261 ^ seed
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def read_csv(path):
+    entries = []
+    with io.open(path, encoding="utf-8", newline="") as f:
+        for row in csv.DictReader(f):
+            keywords = (row.get("keywords") or "").strip()
+            content = (row.get("content") or "").strip()
+            importance = float(row.get("importance") or 1.0)
+            if keywords and content:
+                entries.append((keywords, content, importance))
+    return entries
+
+
+def read_markdown(path):
+    entries = []
+    keywords, importance, lines = None, 1.0, []
+
+    def flush():
+        content = " ".join(l.strip() for l in lines if l.strip())
+        if keywords and content:
+            entries.append((keywords, content, importance))
+
+    with io.open(path, encoding="utf-8") as f:
+        for line in f:
+            heading = re.match(r"^##\s+(.*)$", line)
+            weight = re.match(r"^importance:\s*([0-9.]+)\s*$", line, re.I)
+            if heading:
+                flush()
+                keywords, importance, lines = heading.group(1).strip(), 1.0, []
+            elif weight and keywords is not None and not lines:
+                importance = float(weight.group(1))
+            elif keywords is not None:
+                lines.append(line)
+    flush()
+    return entries
+
+
+def load_corpus(corpus_dir):
+    entries = []
+    for name in sorted(os.listdir(corpus_dir)):
+        path = os.path.join(corpus_dir, name)
+        if name == "benchmark.csv":
+            continue
+        if name.endswith(".csv"):
+            entries += read_csv(path)
+        elif name.endswith(".md"):
+            entries += read_markdown(path)
+    return entries
+
+
+def tokenize(keywords):
+    # Same rules as kbForEachWord: ASCII letters, digits, "+" and "#" make
+    # up words, hyphens inside a word join, anything else splits. Words are
+    # lowercased and truncated
+    tokens = []
+    word = bytearray()
+    for c in keywords.lower() + b" ":
+        if (c < 0x80 and chr(c).isalnum()) or c in b"+#":
+            if len(word) < MAX_TOKEN_LENGTH:
+                word.append(c)
+        elif c == ord("-") and word:
+            continue
+        elif word:
+            tokens.append(bytes(word))
+            word = bytearray()
+    return tokens
+
+
+def trigrams(token):
+    # Same packing as kbTrigrams: "^token$" windows, distinct and sorted
+    token = token[:MAX_TOKEN_LENGTH]
+    padded = b"\x01" + token + b"\x02"
+    return sorted(set((padded[i] << 16) | (padded[i + 1] << 8) | padded[i + 2] for i in range(len(token))))
+
+
+def trigram_index(tokens):
+    postings = {}
+    for token_id, token in enumerate(tokens):
+        for trigram in trigrams(token):
+            postings.setdefault(trigram, []).append(token_id)
+    keys = sorted(postings)
+    offsets, ids = [], []
+    for key in keys:
+        offsets.append(len(ids))
+        ids += postings[key]
+    offsets.append(len(ids))
+    return keys, offsets, ids
+
+
+def perfect_hash(tokens):
+    """Hash-and-displace: each bucket gets the first seed that places all
+    of its tokens in free slots."""
+    count = len(tokens)
+    if count == 0:
+        return [0], [NO_TOKEN], 1, 1
+    buckets_count = max(1, (count + 3) // 4)
+    size = count + count // 4 + 1
+
+    buckets = [[] for _ in range(buckets_count)]
+    for token_id, token in enumerate(tokens):
+        buckets[fnv1a(token) % buckets_count].append(token_id)
+
+    seeds = [0] * buckets_count
+    slots = [NO_TOKEN] * size
+    for bucket in sorted(range(buckets_count), key=lambda b: -len(buckets[b])):
+        members = buckets[bucket]
+        if not members:
+            continue
+        for seed in range(1, MAX_SEED + 1):
+            placed = [fnv1a(tokens[t], seed) % size for t in members]
+            if len(set(placed)) == len(placed) and all(slots[p] == NO_TOKEN for p in placed):
+                for t, p in zip(members, placed):
+                    slots[p] = t
+                seeds[bucket] = seed
+                break
+        else:
+            raise RuntimeError("kb_compile: no perfect hash seed found")
+    return seeds, slots, buckets_count, size
+
+
+def load_embeddings(corpus_dir, entries):
+    """Quantize the offline embeddings to int8, one vector per entry in
+    corpus order. Entries without an embedding get a zero vector. Returns
+    the dimension, vectors, scales and provider name."""
+    path = os.path.join(corpus_dir, "embeddings.jsonl")
+    if not os.path.exists(path):
+        return 0, [], [], None
+
+    by_keywords = {}
+    providers = set()
+    with io.open(path, encoding="utf-8") as f:
+        for line in f:
+            if line.strip():
+                item = json.loads(line)
+                by_keywords[item["keywords"]] = [float(v) for v in item["embedding"]]
+                providers.add(item.get("provider", "openai"))
+    if not by_keywords:
+        return 0, [], [], None
+    if len(providers) > 1:
+        raise RuntimeError("kb_compile: embeddings from more than one provider")
+
+    # Queries are embedded at the compiled dimension, so it can't be padded
+    dim = len(next(iter(by_keywords.values())))
+    if dim % EMBEDDING_ALIGN != 0 or dim > MAX_EMBEDDING_DIM:
+        raise RuntimeError("kb_compile: embedding dimension must be a multiple of %d up to %d"
+                           % (EMBEDDING_ALIGN, MAX_EMBEDDING_DIM))
+
+    vectors, scales = [], []
+    for keywords, _, _ in entries:
+        vector = by_keywords.get(keywords)
+        if vector is None or len(vector) != dim:
+            print("kb_compile: no embedding for '%s'" % keywords)
+            vector = [0.0] * dim
+        norm = math.sqrt(sum(v * v for v in vector))
+        vector = [v / norm for v in vector] if norm > 0 else vector
+        max_abs = max(abs(v) for v in vector)
+        scale = max_abs / 127.0 if max_abs > 0 else 0.0
+        quantized = [int(round(v / scale)) if scale > 0 else 0 for v in vector]
+        vectors += quantized
+        scales.append(scale)
+    return dim, vectors, scales, providers.pop()
+
+
+def load_benchmark(corpus_dir, entries):
+    path = os.path.join(corpus_dir, "benchmark.csv")
+    if not os.path.exists(path):
+        return []
+
+    index_by_keywords = {keywords: i for i, (keywords, _, _) in enumerate(entries)}
+    queries = []
+    with io.open(path, encoding="utf-8", newline="") as f:
+        for row in csv.DictReader(f):
+            keywords = (row.get("keywords") or "").strip()
+            if keywords not in index_by_keywords:
+                raise RuntimeError("kb_compile: benchmark names unknown entry: " + keywords)
+            queries.append((row["query"].strip().encode("utf-8"), index_by_keywords[keywords]))
+    return queries
+
+
+def c_string(data):
+    out = []
+    for b in data:
+        c = chr(b)
+        if c == "\\" or c == '"':
+            out.append("\\" + c)
+        elif 32 <= b < 127 and c != "?":
+            out.append(c)
+        else:
+            out.append("\\%03o" % b)
+    return '"' + "".join(out) + '"'
+
+
+def compile_corpus(entries):
+    if len(entries) > MAX_ENTRIES:
+        raise RuntimeError("kb_compile: too many entries")
+
+    text = bytearray()
+    text_parts = []
+
+    def append_text(data):
+        offset = len(text)
+        text.extend(data + b"\0")
+        text_parts.append(data)
+        return offset
+
+    token_ids = {}
+    token_names = []
+    entry_tokens = []
+    records = []
+    for keywords, content, importance in entries:
+        kw = keywords.encode("utf-8")
+        body = content.encode("utf-8")
+        if len(kw) > MAX_FIELD_LENGTH or len(body) > MAX_FIELD_LENGTH:
+            raise RuntimeError("kb_compile: entry too long: " + keywords)
+        tokens = tokenize(kw)
+        for token in tokens:
+            if token not in token_ids:
+                if len(token_names) >= MAX_TOKENS:
+                    raise RuntimeError("kb_compile: too many tokens")
+                token_ids[token] = len(token_names)
+                token_names.append(token)
+        entry_tokens.append(tokens)
+        records.append([append_text(kw), append_text(body), len(kw), len(body), len(tokens), importance])
+
+    # Lexical token order; ids in the tables are positions in this order
+    sorted_names = sorted(token_names)
+    sorted_ids = {name: i for i, name in enumerate(sorted_names)}
+
+    postings_by_token = [[] for _ in sorted_names]
+    for entry_index, tokens in enumerate(entry_tokens):
+        for token in dict.fromkeys(tokens):
+            postings_by_token[sorted_ids[token]].append(entry_index)
+
+    token_records = []
+    postings = []
+    for i, name in enumerate(sorted_names):
+        token_records.append((append_text(name), len(postings), len(postings_by_token[i]), len(name)))
+        postings += postings_by_token[i]
+
+    seeds, slots, buckets, size = perfect_hash(sorted_names)
+    trigram_keys, trigram_offsets, trigram_ids = trigram_index(sorted_names)
+    total_tokens = sum(len(t) for t in entry_tokens)
+    return {
+        "records": records,
+        "tokens": token_records,
+        "postings": postings,
+        "text_parts": text_parts,
+        "seeds": seeds,
+        "slots": slots,
+        "buckets": buckets,
+        "size": size,
+        "total_tokens": total_tokens,
+        "trigram_keys": trigram_keys,
+        "trigram_offsets": trigram_offsets,
+        "trigram_ids": trigram_ids,
+    }
+
+
+def join_numbers(values, per_line=16):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("  " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def render(tables, sources, embeddings, benchmark):
+    records = tables["records"] or [[0, 0, 0, 0, 0, 0.0]]
+    tokens = tables["tokens"] or [(0, 0, 0, 0)]
+    postings = tables["postings"] or [0]
+    out = []
+    out.append("// Generated by tools/kb_compile.py from %s. Do not edit." % ", ".join(sources))
+    out.append("#ifndef KNOWLEDGE_TABLES_H")
+    out.append("#define KNOWLEDGE_TABLES_H")
+    out.append("")
+    out.append('#include "knowledge_image.h"')
+    out.append('#include "embedding_index.h"')
+    out.append("")
+    out.append("constexpr KnowledgeRecord kbTableRecords[] = {")
+    for r in records:
+        out.append("  {%d, %d, 0, %d, %d, %d, 0, %sf}," % (r[0], r[1], r[2], r[3], r[4], repr(float(r[5]))))
+    out.append("};")
+    out.append("")
+    out.append("constexpr KnowledgeToken kbTableTokens[] = {")
+    for t in tokens:
+        out.append("  {%d, %d, %d, %d, 0}," % t)
+    out.append("};")
+    out.append("")
+    out.append("constexpr uint16_t kbTablePostings[] = {")
+    out.append(join_numbers(postings))
+    out.append("};")
+    out.append("")
+    out.append("constexpr uint16_t kbTableHashSeeds[] = {")
+    out.append(join_numbers(tables["seeds"]))
+    out.append("};")
+    out.append("")
+    out.append("constexpr uint16_t kbTableHashSlots[] = {")
+    out.append(join_numbers(tables["slots"]))
+    out.append("};")
+    out.append("")
+    out.append("constexpr uint32_t kbTableTrigramKeys[] = {")
+    out.append(join_numbers(["0x%06x" % k for k in tables["trigram_keys"]] or [0], 8))
+    out.append("};")
+    out.append("")
+    out.append("constexpr uint32_t kbTableTrigramOffsets[] = {")
+    out.append(join_numbers(tables["trigram_offsets"]))
+    out.append("};")
+    out.append("")
+    out.append("constexpr uint16_t kbTableTrigramTokens[] = {")
+    out.append(join_numbers(tables["trigram_ids"] or [0]))
+    out.append("};")
+    out.append("")
+    out.append("constexpr char kbTableText[] =")
+    parts = tables["text_parts"] or [b""]
+    for i, part in enumerate(parts):
+        out.append("  " + c_string(part + b"\0") + (";" if i == len(parts) - 1 else ""))
+    out.append("")
+    out.append("constexpr KnowledgeTables kbCompiledTables = {")
+    out.append("  kbTableRecords, kbTableTokens, kbTablePostings, kbTableText,")
+    out.append("  kbTableHashSeeds, kbTableHashSlots,")
+    out.append("  %d, %d, %d, %d, %d," % (len(tables["records"]), len(tables["tokens"]),
+                                        tables["total_tokens"], tables["buckets"], tables["size"]))
+    out.append("  {kbTableTrigramKeys, kbTableTrigramOffsets, kbTableTrigramTokens, %d}"
+               % len(tables["trigram_keys"]))
+    out.append("};")
+    out.append("")
+    out.append("")
+
+    dim, vectors, scales, provider = embeddings
+    if provider == "hashing":
+        out.append("// Entries were embedded by the local stand-in, so queries must be too")
+        out.append("#ifndef KB_EMBEDDING_HASHING")
+        out.append("#define KB_EMBEDDING_HASHING")
+        out.append("#endif")
+        out.append("")
+    out.append("alignas(KB_EMBEDDING_ALIGN) constexpr int8_t kbTableEmbeddings[] = {")
+    out.append(join_numbers(vectors or [0] * EMBEDDING_ALIGN))
+    out.append("};")
+    out.append("")
+    out.append("constexpr float kbTableEmbeddingScales[] = {")
+    out.append(join_numbers([repr(float(v)) + "f" for v in scales] or ["0.0f"], 8))
+    out.append("};")
+    out.append("")
+    out.append("constexpr EmbeddingTables kbCompiledEmbeddings = {")
+    out.append("  kbTableEmbeddings, kbTableEmbeddingScales, %d, %d" % (len(scales), dim))
+    out.append("};")
+    out.append("")
+
+    out.append("#define KB_BENCHMARK_QUERY_COUNT %d" % len(benchmark))
+    out.append("")
+    out.append("constexpr KnowledgeQuerySample kbBenchmarkQueries[] = {")
+    for query, expected in benchmark or [(b"", 0)]:
+        out.append("  {%s, %d}," % (c_string(query), expected))
+    out.append("};")
+    out.append("")
+    out.append("#endif")
+    return "\n".join(out) + "\n"
+
+
+def generate(project_dir):
+    corpus_dir = os.path.join(project_dir, "kb")
+    output = os.path.join(project_dir, "include", "knowledge_tables.h")
+    sources = ["kb/" + n for n in sorted(os.listdir(corpus_dir)) if n.endswith((".csv", ".md", ".jsonl"))]
+
+    entries = load_corpus(corpus_dir)
+    header = render(compile_corpus(entries), sources,
+                    load_embeddings(corpus_dir, entries), load_benchmark(corpus_dir, entries))
+
+    # Only touch the header when it changes, so builds stay incremental
+    if os.path.exists(output):
+        with io.open(output, encoding="utf-8") as f:
+            if f.read() == header:
+                return
+    with io.open(output, "w", encoding="utf-8", newline="\n") as f:
+        f.write(header)
+    print("kb_compile: wrote " + output)
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+    generate(env.subst("$PROJECT_DIR"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        generate(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
@@ -0,0 +1,113 @@
+"""Precompute knowledge base entry embeddings for semantic search.
+
+Writes kb/embeddings.jsonl with one {"keywords", "embedding", "provider"}
+object per entry of the kb/ corpus; tools/kb_compile.py quantizes it into
+flash. The dimension must be a multiple of 16, the int8 lane count of the
+dot product kernel, so the vectors are never padded and queries are
+embedded at exactly the dimension the entries were.
+
+Providers must match the one the firmware uses for queries:
+  openai   OpenAI embeddings API (OPENAI_API_KEY in the environment),
+           paired with OpenAIEmbeddingProvider
+  hashing  Local feature hashing, paired with HashingEmbeddingProvider
+
+    python tools/kb_embed.py --provider openai --dim 256
+    python tools/kb_embed.py --provider hashing --dim 256
+"""
+
+import argparse
+import io
+import json
+import os
+import sys
+import urllib.request
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from kb_compile import EMBEDDING_ALIGN, MAX_EMBEDDING_DIM, MAX_TOKEN_LENGTH, fnv1a, load_corpus  # noqa: E402
+
+OPENAI_URL = "https://api.openai.com/v1/embeddings"
+OPENAI_BATCH = 64
+
+
+def entry_text(keywords, content):
+    return keywords + "\n" + content
+
+
+def hashing_embedding(text, dim):
+    # Mirrors HashingEmbeddingProvider::embed
+    vector = [0.0] * dim
+
+    def add(feature, weight):
+        h = fnv1a(feature)
+        vector[h % dim] += -weight if h & 0x80000000 else weight
+
+    for word in words(text):
+        add(word, 1.0)
+        bounded = b"^" + word + b"$"
+        for t in range(len(bounded) - 2):
+            add(bounded[t:t + 3], 0.5)
+
+    norm = sum(v * v for v in vector) ** 0.5
+    return [v / norm for v in vector] if norm > 0 else vector
+
+
+def words(text):
+    word = bytearray()
+    for b in text.encode("utf-8") + b" ":
+        c = chr(b).lower() if b < 128 else ""
+        if c and c.isalnum():
+            if len(word) < MAX_TOKEN_LENGTH:
+                word.append(ord(c))
+            continue
+        if word:
+            yield bytes(word)
+            word = bytearray()
+
+
+def openai_embeddings(texts, model, dim):
+    key = os.environ.get("OPENAI_API_KEY")
+    if not key:
+        raise SystemExit("kb_embed: set OPENAI_API_KEY")
+
+    vectors = []
+    for i in range(0, len(texts), OPENAI_BATCH):
+        body = json.dumps({"model": model, "input": texts[i:i + OPENAI_BATCH], "dimensions": dim})
+        request = urllib.request.Request(OPENAI_URL, body.encode("utf-8"), {
+            "Authorization": "Bearer " + key,
+            "Content-Type": "application/json",
+        })
+        with urllib.request.urlopen(request) as response:
+            data = json.load(response)["data"]
+        vectors += [item["embedding"] for item in sorted(data, key=lambda d: d["index"])]
+    return vectors
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--provider", choices=["openai", "hashing"], default="openai")
+    parser.add_argument("--model", default="text-embedding-3-small")
+    parser.add_argument("--dim", type=int, default=256)
+    args = parser.parse_args()
+    if args.dim <= 0 or args.dim % EMBEDDING_ALIGN != 0 or args.dim > MAX_EMBEDDING_DIM:
+        parser.error("--dim must be a multiple of %d up to %d" % (EMBEDDING_ALIGN, MAX_EMBEDDING_DIM))
+
+    project_dir = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    corpus_dir = os.path.join(project_dir, "kb")
+    entries = load_corpus(corpus_dir)
+    texts = [entry_text(k, c) for k, c, _ in entries]
+
+    if args.provider == "openai":
+        vectors = openai_embeddings(texts, args.model, args.dim)
+    else:
+        vectors = [hashing_embedding(t, args.dim) for t in texts]
+
+    output = os.path.join(corpus_dir, "embeddings.jsonl")
+    with io.open(output, "w", encoding="utf-8", newline="\n") as f:
+        for (keywords, _, _), vector in zip(entries, vectors):
+            f.write(json.dumps({"keywords": keywords, "embedding": [round(v, 6) for v in vector],
+                                "provider": args.provider}) + "\n")
+    print("kb_embed: wrote %d embeddings to %s" % (len(vectors), output))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,199 @@
+"""Local TLS stand-in for the OpenAI API, for measuring OpenAIClient.
+
+Serves /v1/chat/completions and /v1/embeddings over HTTPS with HTTP/1.1
+keep-alive and TLS session resumption, and logs for every request whether
+it arrived on a kept-alive connection, a resumed session or a full
+handshake. Build the firmware against it with
+
+    -DOPENAI_API_HOST='"192.168.0.10"' -DOPENAI_API_PORT=8443
+
+    python tools/tls_standin.py --port 8443 --delay 0.5
+    python tools/tls_standin.py --close-after 3    # exercise resumption
+    python tools/tls_standin.py --idle-timeout 5   # drop idle connections
+    python tools/tls_standin.py --delay 0.3 --token-delay 0.05   # stream pacing
+
+Chat requests with "stream": true are answered with server-sent events
+over chunked transfer encoding, one word per event, like the real API.
+
+A self-signed certificate is generated with the openssl command unless
+--cert and --key are given.
+"""
+
+import argparse
+import hashlib
+import http.server
+import itertools
+import json
+import os
+import re
+import socket
+import ssl
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+connection_ids = itertools.count(1)
+stats_lock = threading.Lock()
+stats = {"connections": 0, "resumed": 0, "requests": 0}
+
+
+def self_signed_certificate(directory):
+    cert = os.path.join(directory, "standin.crt")
+    key = os.path.join(directory, "standin.key")
+    subprocess.run(["openssl", "req", "-x509", "-newkey", "rsa:2048", "-nodes", "-days", "30",
+                    "-subj", "/CN=api.openai.com", "-keyout", key, "-out", cert],
+                   check=True, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    return cert, key
+
+
+def embedding(text, dim):
+    # Deterministic unit vector, so repeated queries embed identically
+    values = []
+    for i in range(dim):
+        digest = hashlib.sha256(("%d:%s" % (i, text)).encode("utf-8")).digest()
+        values.append(int.from_bytes(digest[:4], "little") / 2**31 - 1.0)
+    norm = sum(v * v for v in values) ** 0.5
+    return [v / norm for v in values]
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # keep-alive with Content-Length framing
+
+    def setup(self):
+        super().setup()
+        if self.server.idle_timeout:
+            self.connection.settimeout(self.server.idle_timeout)
+        self.connection.do_handshake()
+        self.connection_id = next(connection_ids)
+        self.resumed = self.connection.session_reused
+        self.served = 0
+        with stats_lock:
+            stats["connections"] += 1
+            stats["resumed"] += self.resumed
+
+    def do_POST(self):
+        length = int(self.headers.get("Content-Length", 0))
+        try:
+            request = json.loads(self.rfile.read(length) or b"{}")
+        except ValueError:
+            return self.reply(400, {"error": {"message": "invalid JSON"}})
+
+        time.sleep(self.server.delay)
+        if self.path == "/v1/chat/completions":
+            question = request.get("messages", [{}])[-1].get("content", "")
+            answer = "Stand-in answer (%d bytes of prompt): %s" % (len(question), question[-80:])
+            if request.get("stream"):
+                return self.stream(answer)
+            body = {"choices": [{"message": {"role": "assistant", "content": answer}}]}
+        elif self.path == "/v1/embeddings":
+            body = {"data": [{"index": 0, "embedding": embedding(str(request.get("input")),
+                                                                 int(request.get("dimensions", 256)))}]}
+        else:
+            return self.reply(404, {"error": {"message": "unknown path " + self.path}})
+        self.reply(200, body)
+
+    def reply(self, status, body):
+        payload = json.dumps(body).encode("utf-8")
+        self.start_reply(status, "application/json", len(payload))
+        self.wfile.write(payload)
+        self.log_reply(status)
+
+    def stream(self, answer):
+        # The model's first token arrives after --delay, then one per --token-delay
+        self.start_reply(200, "text/event-stream", None)
+        events = [{"choices": [{"index": 0, "delta": {"role": "assistant", "content": ""}}]}]
+        events += [{"choices": [{"index": 0, "delta": {"content": word}}]}
+                   for word in re.findall(r"\S+\s*|\s+", answer)]
+        events.append({"choices": [{"index": 0, "delta": {}, "finish_reason": "stop"}]})
+        for i, event in enumerate(events):
+            if i > 1:
+                time.sleep(self.server.token_delay)
+            self.write_chunk(("data: %s\n\n" % json.dumps(event)).encode("utf-8"))
+        self.write_chunk(b"data: [DONE]\n\n")
+        self.write_chunk(b"")
+        self.log_reply(200, "%d events" % (len(events) + 1))
+
+    def write_chunk(self, data):
+        self.wfile.write(b"%x\r\n%s\r\n" % (len(data), data))
+        self.wfile.flush()
+
+    def start_reply(self, status, content_type, length):
+        self.served += 1
+        close = self.server.close_after and self.served >= self.server.close_after
+        self.send_response(status)
+        self.send_header("Content-Type", content_type)
+        if length is None:
+            self.send_header("Transfer-Encoding", "chunked")
+        else:
+            self.send_header("Content-Length", str(length))
+        if close:
+            self.send_header("Connection", "close")
+            self.close_connection = True
+        self.end_headers()
+
+    def log_reply(self, status, note=""):
+        with stats_lock:
+            stats["requests"] += 1
+            totals = dict(stats)
+        how = "kept-alive" if self.served > 1 else "resumed session" if self.resumed else "full handshake"
+        print("conn %d request %d (%s) %s %d%s | %d connections, %d resumed, %d requests" % (
+            self.connection_id, self.served, how, self.path, status, " " + note if note else "",
+            totals["connections"], totals["resumed"], totals["requests"]))
+
+    def log_message(self, format, *args):
+        pass
+
+
+class Server(http.server.ThreadingHTTPServer):
+    daemon_threads = True
+
+    def __init__(self, address, context, delay, token_delay, close_after, idle_timeout):
+        super().__init__(address, Handler)
+        self.context = context
+        self.delay = delay
+        self.token_delay = token_delay
+        self.close_after = close_after
+        self.idle_timeout = idle_timeout
+
+    def get_request(self):
+        sock, address = super().get_request()
+        # Headers and body go out as separate writes; don't let delayed
+        # ACKs show up in the client's timings
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        return self.context.wrap_socket(sock, server_side=True, do_handshake_on_connect=False), address
+
+    def handle_error(self, request, client_address):
+        print("conn from %s: %s" % (client_address[0], sys.exc_info()[1]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--host", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=8443)
+    parser.add_argument("--cert")
+    parser.add_argument("--key")
+    parser.add_argument("--delay", type=float, default=0.0, help="seconds of simulated model time")
+    parser.add_argument("--token-delay", type=float, default=0.05, help="seconds between streamed tokens")
+    parser.add_argument("--close-after", type=int, default=0, help="close connections after N requests")
+    parser.add_argument("--idle-timeout", type=float, default=0, help="close connections idle this many seconds")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as directory:
+        cert, key = (args.cert, args.key) if args.cert else self_signed_certificate(directory)
+        context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+        context.load_cert_chain(cert, key)
+
+        server = Server((args.host, args.port), context, args.delay, args.token_delay, args.close_after,
+                        args.idle_timeout)
+        print("tls_standin: https://%s:%d (delay %.2fs, close after %s)" % (
+            args.host, args.port, args.delay, args.close_after or "never"))
+        try:
+            server.serve_forever()
+        except KeyboardInterrupt:
+            pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,122 @@
+"""Compress the web interface into flash-resident C++ arrays.
+
+Reads web/index.html, web/style.css and web/app.js, gzips each one and
+writes include/web_assets.h with the compressed bytes, a strong ETag per
+asset and the Cache-Control it is served with.
+
+The page is revalidated on every load, which costs a 304 when it has
+not changed. The stylesheet and script are cached for a year: the page
+links them with their ETag as a version (/app.js?v=...), so a changed
+asset gets a new URL.
+
+Runs as a PlatformIO pre-build script or standalone:
+    python tools/web_compile.py
+"""
+
+import gzip
+import hashlib
+import io
+import os
+
+PAGE = ("index.html", "/", "text/html", "no-cache")
+ASSETS = [
+    ("style.css", "/style.css", "text/css", "public, max-age=31536000, immutable"),
+    ("app.js", "/app.js", "application/javascript", "public, max-age=31536000, immutable"),
+]
+
+
+def compress(data):
+    # mtime=0 keeps the output, and so the ETag, the same between builds
+    out = io.BytesIO()
+    with gzip.GzipFile(fileobj=out, mode="wb", compresslevel=9, mtime=0) as f:
+        f.write(data)
+    return out.getvalue()
+
+
+def etag(data):
+    return '"%s"' % hashlib.sha1(data).hexdigest()[:16]
+
+
+def c_name(file_name):
+    stem, ext = os.path.splitext(file_name)
+    return "webAsset" + "".join(p.capitalize() for p in stem.replace("-", "_").split("_")) + ext[1:].capitalize()
+
+
+def c_bytes(data, per_line=16):
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append("  " + ", ".join("0x%02x" % b for b in data[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def build(web_dir):
+    assets = []
+    versions = {}
+    for file_name, path, content_type, cache_control in ASSETS:
+        with io.open(os.path.join(web_dir, file_name), "rb") as f:
+            body = compress(f.read())
+        tag = etag(body)
+        versions[path] = tag.strip('"')
+        assets.append((file_name, path, content_type, cache_control, body, tag))
+
+    # Link the page to this version of each asset
+    file_name, path, content_type, cache_control = PAGE
+    with io.open(os.path.join(web_dir, file_name), encoding="utf-8") as f:
+        page = f.read()
+    for asset_path, version in versions.items():
+        for attribute in ("href", "src"):
+            reference = '%s="%s"' % (attribute, asset_path)
+            page = page.replace(reference, '%s="%s?v=%s"' % (attribute, asset_path, version))
+    body = compress(page.encode("utf-8"))
+    assets.insert(0, (file_name, path, content_type, cache_control, body, etag(body)))
+    return assets
+
+
+def render(assets):
+    sources = ", ".join("web/" + a[0] for a in assets)
+    out = []
+    out.append("// Generated by tools/web_compile.py from %s. Do not edit." % sources)
+    out.append("#ifndef WEB_ASSETS_H")
+    out.append("#define WEB_ASSETS_H")
+    out.append("")
+    out.append('#include "static_assets.h"')
+    out.append("")
+    for file_name, path, content_type, cache_control, body, tag in assets:
+        out.append("// %s: %d bytes gzipped" % (file_name, len(body)))
+        out.append("constexpr uint8_t %s[] = {" % c_name(file_name))
+        out.append(c_bytes(body))
+        out.append("};")
+        out.append("")
+    out.append("constexpr StaticAsset webAssets[] = {")
+    for file_name, path, content_type, cache_control, body, tag in assets:
+        out.append('  {"%s", "%s", "%s", "%s", %s, %d},'
+                   % (path, content_type, tag.replace('"', '\\"'), cache_control, c_name(file_name), len(body)))
+    out.append("};")
+    out.append("")
+    out.append("#define WEB_ASSET_COUNT %d" % len(assets))
+    out.append("")
+    out.append("#endif")
+    return "\n".join(out) + "\n"
+
+
+def generate(project_dir):
+    assets = build(os.path.join(project_dir, "web"))
+    header = render(assets)
+    output = os.path.join(project_dir, "include", "web_assets.h")
+
+    # Only touch the header when it changes, so builds stay incremental
+    if os.path.exists(output):
+        with io.open(output, encoding="utf-8") as f:
+            if f.read() == header:
+                return
+    with io.open(output, "w", encoding="utf-8", newline="\n") as f:
+        f.write(header)
+    print("web_compile: wrote %s (%d bytes gzipped)" % (output, sum(len(a[4]) for a in assets)))
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+    generate(env.subst("$PROJECT_DIR"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        generate(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
@@ -0,0 +1,223 @@
+// Keep chat history
+let chatHistory = [];
+const POLL_INTERVAL_MS = 100;  // while an answer is being generated
+
+// Language detection patterns
+const codePatterns = {
+  javascript: /```(javascript|js)\n([\s\S]*?)```/g,
+  python: /```(python|py)\n([\s\S]*?)```/g,
+  cpp: /```(cpp|c\+\+|c)\n([\s\S]*?)```/g,
+  html: /```(html|xml)\n([\s\S]*?)```/g,
+  css: /```(css)\n([\s\S]*?)```/g,
+  json: /```(json)\n([\s\S]*?)```/g,
+  bash: /```(bash|sh|shell)\n([\s\S]*?)```/g,
+  plaintext: /```(plaintext|text)?\n([\s\S]*?)```/g
+};
+
+// Add system message on load
+window.onload = function() {
+  addToHistory('system', 'Welcome! Ask me anything about programming, ESP32, or AI. I can show code examples with syntax highlighting.');
+};
+
+async function ask() {
+  const questionInput = document.getElementById('question');
+  const question = questionInput.value.trim();
+  if (!question) return;
+  
+  // Show loading indicator
+  document.getElementById('loading').classList.remove('hidden');
+  document.getElementById('send-btn').disabled = true;
+  
+  // Add question to history
+  addToHistory('user', question);
+  
+  try {
+    const res = await fetch("/ask?q=" + encodeURIComponent(question));
+    if (res.status === 429 || res.status === 503) {
+      // The device is busy; it says when to come back
+      const wait = res.headers.get('Retry-After') || '1';
+      throw new Error(`${await res.text()}, try again in ${wait} s`);
+    }
+    if (!res.ok) {
+      throw new Error(`HTTP error! status: ${res.status}`);
+    }
+    const { id } = await res.json();
+    
+    // The device answers in the background; collect the answer as it
+    // streams in, rendering it as it grows
+    const decoder = new TextDecoder();
+    let message = null;
+    let text = '';
+    let received = 0;
+    for (;;) {
+      const part = await fetch(`/ask/result?id=${id}&from=${received}`);
+      if (!part.ok) {
+        throw new Error(`HTTP error! status: ${part.status}`);
+      }
+      const bytes = await part.arrayBuffer();
+      const done = part.headers.get('X-Answer-Done') === '1';
+      received += bytes.byteLength;
+      text += decoder.decode(bytes, { stream: !done });
+      if (!message && text) {
+        document.getElementById('loading').classList.add('hidden');
+        message = addToHistory('assistant', text);
+      } else if (message && bytes.byteLength) {
+        updateHistory(message, text);
+      }
+      if (done) break;
+      if (!bytes.byteLength) {
+        await new Promise(resolve => setTimeout(resolve, POLL_INTERVAL_MS));
+      }
+    }
+    if (!message) addToHistory('assistant', text);
+  } catch (err) {
+    addToHistory('system', "Error: " + err.message);
+  } finally {
+    document.getElementById('loading').classList.add('hidden');
+    document.getElementById('send-btn').disabled = false;
+    questionInput.value = '';
+    questionInput.focus();
+  }
+}
+
+function formatCodeBlocks(text) {
+  // Process each language pattern
+  let formattedText = text;
+  
+  // First replace all code blocks with placeholders
+  let codeBlocks = [];
+  let codeBlockIndex = 0;
+  
+  // Process each language
+  for (const [language, pattern] of Object.entries(codePatterns)) {
+    formattedText = formattedText.replace(pattern, (match, lang, code) => {
+      const placeholder = `__CODE_BLOCK_${codeBlockIndex}__`;
+      codeBlocks.push({
+        placeholder,
+        language: lang.trim(),
+        code: code.trim()
+      });
+      codeBlockIndex++;
+      return placeholder;
+    });
+  }
+  
+  // Replace placeholders with formatted code
+  for (const block of codeBlocks) {
+    const languageDisplay = block.language === 'plaintext' ? '' : block.language;
+    const formattedCode = `
+      <div class="code-block">
+        <div class="code-header">
+          <span>${languageDisplay}</span>
+        </div>
+        <pre><code class="language-${block.language}">${escapeHtml(block.code)}</code></pre>
+      </div>
+    `;
+    formattedText = formattedText.replace(block.placeholder, formattedCode);
+  }
+  
+  // Apply syntax highlighting to inline code
+  formattedText = formattedText.replace(/`([^`]+)`/g, '<code class="inline-code">$1</code>');
+  
+  return formattedText;
+}
+
+function escapeHtml(text) {
+  return text
+    .replace(/&/g, "&amp;")
+    .replace(/</g, "&lt;")
+    .replace(/>/g, "&gt;")
+    .replace(/"/g, "&quot;")
+    .replace(/'/g, "&#039;");
+}
+
+function highlightSyntax(element) {
+  // Apply syntax highlighting to code elements
+  const codeElements = element.querySelectorAll('code');
+  
+  codeElements.forEach(codeEl => {
+    const language = codeEl.className.replace('language-', '');
+    const code = codeEl.textContent;
+    
+    // Simple syntax highlighting for common elements
+    let highlighted = code;
+    
+    // Keywords
+    highlighted = highlighted.replace(
+      /\b(function|return|if|else|for|while|var|let|const|class|import|export|from|async|await|try|catch|throw|new|this)\b/g,
+      '<span class="token keyword">$1</span>'
+    );
+    
+    // Strings
+    highlighted = highlighted.replace(
+      /(".*?"|'.*?'|`.*?`)/g,
+      '<span class="token string">$1</span>'
+    );
+    
+    // Numbers
+    highlighted = highlighted.replace(
+      /\b(\d+(\.\d+)?)\b/g,
+      '<span class="token number">$1</span>'
+    );
+    
+    // Comments
+    highlighted = highlighted.replace(
+      /(\/\/.*|\/\*[\s\S]*?\*\/)/g,
+      '<span class="token comment">$1</span>'
+    );
+    
+    // Functions
+    highlighted = highlighted.replace(
+      /\b([a-zA-Z_$][a-zA-Z0-9_$]*)\s*\(/g,
+      '<span class="token function">$1</span>('
+    );
+    
+    codeEl.innerHTML = highlighted;
+  });
+}
+
+function addToHistory(role, text) {
+  const historyDiv = document.getElementById('chat-history');
+  const entry = document.createElement('div');
+  entry.className = `chat-entry ${role}`;
+  historyDiv.appendChild(entry);
+  
+  // Store in history array
+  const message = {role, text, entry};
+  chatHistory.push(message);
+  updateHistory(message, text);
+  return message;
+}
+
+// Re-render a message, as more of a streamed answer arrives
+function updateHistory(message, text) {
+  const historyDiv = document.getElementById('chat-history');
+  message.text = text;
+  
+  // Format code blocks if this is an assistant message
+  let processedText = text;
+  if (message.role === 'assistant') {
+    processedText = formatCodeBlocks(text);
+  }
+  
+  message.entry.innerHTML = `<div class="chat-bubble">${processedText}</div>`;
+  
+  // Apply syntax highlighting
+  if (message.role === 'assistant') {
+    highlightSyntax(message.entry);
+  }
+  
+  // Scroll to bottom
+  historyDiv.scrollTop = historyDiv.scrollHeight;
+}
+
+// Handle Enter key press
+document.getElementById('question').addEventListener('keypress', function(e) {
+  if (e.key === 'Enter') {
+    ask();
+  }
+});
+
+function showInfo() {
+  addToHistory('system', 'ESP32 AI Assistant v2.0 - Enhanced with code highlighting and a modern UI. Ask me about programming, ESP32 features, or AI topics!');
+}